@@ -226,7 +226,7 @@ Consumer::OnData(shared_ptr<const Data> data)
   auto ns3PacketTag = data->getTag<Ns3PacketTag>();
   if (ns3PacketTag != nullptr) { // e.g., packet came from local node's cache
     FwHopCountTag hopCountTag;
-    if (ns3PacketTag->getPacket()->PeekPacketTag(hopCountTag)) {
+    if (ns3PacketTag->peekHopCountTag(hopCountTag)) {
       hopCount = hopCountTag.Get();
       NS_LOG_DEBUG("Hop count: " << hopCount);
     }
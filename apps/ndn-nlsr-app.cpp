@@ -20,9 +20,17 @@
 #include "ndn-nlsr-app.hpp"
 
 #include "ns3/log.h"
-#include <ns3/node-list.h>
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
+#include "ns3/ndnSIM/helper/ndn-link-control-helper.hpp"
+
+#include "ndn-nlsr-routing-service.hpp"
+
+#include "adjacent.hpp"
+#include "adjacency-list.hpp"
+
+#include <limits>
 
 NS_LOG_COMPONENT_DEFINE ("NlsrApp");
 
@@ -38,54 +46,240 @@ NlsrApp::GetTypeId (void)
     .SetGroupName ("Ndn")
     .SetParent<Application> ()
     .AddConstructor<NlsrApp> ()
+    .AddAttribute ("LinkOracle",
+                   "Learn neighbor up/down state from LinkControlHelper instead of sending "
+                   "periodic hello Interests",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NlsrApp::m_linkOracle),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SharedRoutingCalculation",
+                   "Read routing table rows from NlsrRoutingService, which computes the routing "
+                   "tables of all routers in parallel once per LSDB version, instead of running "
+                   "a private calculation",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NlsrApp::m_sharedRouting),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
-NlsrApp::NlsrApp() {
+NlsrApp::NlsrApp()
+  : m_linkOracle(false)
+  , m_sharedRouting(false)
+  , m_linkListener(0)
+  , m_nLinkChanges(0)
+{
 }
 
 NlsrApp::~NlsrApp() {
 }
 
 void
-NlsrApp::Initialize(std::string& nodeConfig) {
-  m_nodeConfigFile = nodeConfig;
+NlsrApp::Initialize(const std::string& configFile,
+                    shared_ptr<const NlsrExec::ConfigSection> nodeConfig) {
+  m_nodeConfigFile = configFile;
+  m_nodeConfig = nodeConfig;
 }
 
 void
 NlsrApp::StartApplication ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_instance.reset(new ndn::NlsrExec(ndn::StackHelper::getKeyChain(), m_nodeConfigFile));
-  m_instance->run();
+  NS_ASSERT_MSG(m_nodeConfig != nullptr, "NlsrApp is not initialized with a configuration");
+  m_instance.reset(new ndn::NlsrExec(ndn::StackHelper::getKeyChain(), m_nodeConfigFile,
+                                       *m_nodeConfig));
+
+  if (m_linkOracle) {
+    RemoveLinkStateListener();
+    m_linkListener =
+      LinkControlHelper::AddLinkStateListener(std::bind(&NlsrApp::OnLinkStateChange, this,
+                                                        _1, _2, _3));
+
+    // NLSR sends the first hello round first-hello-interval after start, and the following
+    // rounds every hello-interval
+    nlsr::ConfParameter& conf = m_instance->GetConfParameter();
+    m_helloStart = Simulator::Now() + Seconds(conf.getFirstHelloInterval());
+    m_helloInterval = Seconds(conf.getInfoInterestInterval());
+    m_helloDeadTime = Seconds(conf.getInterestResendTime() * conf.getInterestRetryNumber());
+
+    // The initial hello round still establishes the adjacencies; afterwards, the neighbor
+    // state comes from the link oracle only
+    conf.setInfoInterestInterval(std::numeric_limits<int32_t>::max());
+
+    m_neighborNames.clear();
+    auto neighbors = m_nodeConfig->get_child_optional("neighbors");
+    if (neighbors) {
+      for (const auto& neighbor : *neighbors) {
+        if (neighbor.first == "neighbor") {
+          m_neighborNames[neighbor.second.get<std::string>("node-id", "")] =
+            neighbor.second.get<std::string>("name", "");
+        }
+      }
+    }
+  }
+
+  if (m_sharedRouting) {
+    nlsr::ConfParameter& conf = m_instance->GetConfParameter();
+    m_routingCalcInterval = Seconds(conf.getRoutingCalcInterval());
+    m_routingTables.reset();
+
+    // NLSR schedules its own calculation routing-calc-interval after every LSDB change;
+    // push it out and poll the shared service at the same interval instead
+    conf.setRoutingCalcInterval(std::numeric_limits<int32_t>::max());
+    m_routingEvent = Simulator::Schedule(m_routingCalcInterval, &NlsrApp::UpdateRoutingTable,
+                                         this);
+  }
+
+  m_instance->run(m_warmStart.get());
 }
 
 void
 NlsrApp::StopApplication ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  RemoveLinkStateListener();
+  m_linkEvents.clear();
+  Simulator::Cancel(m_routingEvent);
+  m_routingTables.reset();
   m_instance.reset();
 }
 
 void
-NlsrApp::SetNodeNameToIdMapping(std::string name, uint32_t id)
+NlsrApp::DoDispose ()
 {
-  m_ndn_node_map[name] = id;
+  // the application may be disposed without being stopped, e.g., when the simulation ends
+  // before its stop time
+  RemoveLinkStateListener();
+  Application::DoDispose();
 }
 
-Ptr<Node>
-NlsrApp::GetNode (std::string nodeName)
+void
+NlsrApp::RemoveLinkStateListener()
+{
+  if (m_linkListener != 0) {
+    LinkControlHelper::RemoveLinkStateListener(m_linkListener);
+    m_linkListener = 0;
+  }
+}
+
+void
+NlsrApp::UpdateRoutingTable()
+{
+  NlsrRoutingService::Instance().UpdateRoutingTable(GetNlsr(), m_routingTables);
+  m_routingEvent = Simulator::Schedule(m_routingCalcInterval, &NlsrApp::UpdateRoutingTable,
+                                       this);
+}
+
+void
+NlsrApp::OnLinkStateChange(Ptr<Node> node1, Ptr<Node> node2, bool isUp)
+{
+  Ptr<Node> neighbor;
+  if (node1 == Application::GetNode()) {
+    neighbor = node2;
+  }
+  else if (node2 == Application::GetNode()) {
+    neighbor = node1;
+  }
+  else {
+    return;
+  }
+
+  Ptr<NlsrApp> neighborApp = FindApp(neighbor);
+  if (neighborApp != nullptr) {
+    NotifyLinkState(neighborApp->GetNodeName(), isUp);
+  }
+}
+
+Ptr<NlsrApp>
+NlsrApp::FindApp(Ptr<Node> node)
 {
-  uint32_t id = m_ndn_node_map[nodeName];
-  uint32_t size = ns3::NodeList::GetNNodes();
-  for (uint32_t i = 0; i < size; i++) {
-    ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(i);
-    if (node->GetId() == id) {
-      return node;
+  for (uint32_t i = 0; i < node->GetNApplications(); ++i) {
+    Ptr<NlsrApp> app = DynamicCast<NlsrApp>(node->GetApplication(i));
+    if (app != nullptr) {
+      return app;
     }
   }
-  return NULL;
+  return nullptr;
+}
+
+void
+NlsrApp::NotifyLinkState(const std::string& neighborNodeId, bool isUp)
+{
+  if (!m_linkOracle || !IsRunning()) {
+    return;
+  }
+
+  auto neighbor = m_neighborNames.find(neighborNodeId);
+  if (neighbor == m_neighborNames.end()) {
+    NS_LOG_WARN(m_nodeName << ": " << neighborNodeId << " is not a configured neighbor");
+    return;
+  }
+
+  // Detection happens at the next hello round, and a failure is only declared after all
+  // hello retransmissions time out.  A flap before detection cancels the pending change.
+  Time delay = GetNextHelloRound() - Simulator::Now();
+  if (!isUp) {
+    delay += m_helloDeadTime;
+  }
+
+  uint64_t change = ++m_nLinkChanges;
+  m_linkEvents[neighbor->second] = change;
+  Simulator::ScheduleWithContext(Application::GetNode()->GetId(), delay,
+                                 &NlsrApp::SetNeighborStatus, this, neighbor->second, isUp,
+                                 change);
+
+  NS_LOG_DEBUG(m_nodeName << ": link to " << neighborNodeId << (isUp ? " up" : " down")
+               << ", detected in " << delay.GetSeconds() << "s");
+}
+
+Time
+NlsrApp::GetNextHelloRound() const
+{
+  Time now = Simulator::Now();
+  if (m_helloInterval.IsZero() || now <= m_helloStart) {
+    return now;
+  }
+
+  int64_t rounds = (now - m_helloStart).GetTimeStep() / m_helloInterval.GetTimeStep();
+  Time next = TimeStep(m_helloStart.GetTimeStep() + m_helloInterval.GetTimeStep() * rounds);
+  return next < now ? next + m_helloInterval : next;
+}
+
+void
+NlsrApp::SetNeighborStatus(std::string neighborName, bool isUp, uint64_t change)
+{
+  auto pending = m_linkEvents.find(neighborName);
+  if (!IsRunning() || pending == m_linkEvents.end() || pending->second != change) {
+    return; // superseded by a later change or application stopped
+  }
+
+  nlsr::Nlsr& nlsr = GetNlsr();
+  ::ndn::Name neighbor(neighborName);
+  nlsr::Adjacent::Status status = isUp ? nlsr::Adjacent::STATUS_ACTIVE :
+                                         nlsr::Adjacent::STATUS_INACTIVE;
+  if (nlsr.getAdjacencyList().getStatusOfNeighbor(neighbor) == status) {
+    return;
+  }
+
+  NS_LOG_INFO(m_nodeName << ": neighbor " << neighborName << (isUp ? " ACTIVE" : " INACTIVE"));
+
+  // Same transition the hello protocol performs on hello Data or on the last hello timeout
+  nlsr.getAdjacencyList().setStatusOfNeighbor(neighbor, status);
+  nlsr.getAdjacencyList().setTimedOutInterestCount(neighbor, 0);
+  nlsr.incrementAdjBuildCount();
+  if (!nlsr.getIsBuildAdjLsaSheduled()) {
+    nlsr.setIsBuildAdjLsaSheduled(true);
+    nlsr.getLsdb().scheduleAdjLsaBuild();
+  }
+}
+
+Ptr<Node>
+NlsrApp::GetNode (const std::string& nodeName) const
+{
+  if (m_nodeIndex == nullptr) {
+    return nullptr;
+  }
+  return m_nodeIndex->Find(nodeName);
 }
 
 } // namespace ndn
@@ -21,9 +21,17 @@
 #define NDN_NLSR_APP_H_
 
 #include "ndn-nlsr-exec.hpp"
+#include "ndn-nlsr-snapshot.hpp"
+#include "ndn-nlsr-routing-service.hpp"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/application.h"
 #include "ns3/ptr.h"
 #include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+
+#include "ns3/ndnSIM/helper/ndn-link-control-helper.hpp"
+#include "ns3/ndnSIM/utils/topology/nlsr-node-index.hpp"
 
 namespace ns3 {
 namespace ndn {
@@ -38,8 +46,31 @@ public:
   virtual
   ~NlsrApp();
 
+  /**
+   * \brief Set the parsed NLSR configuration of the node
+   *
+   * The section is owned by the topology reader and shared read-only, so no configuration
+   * file is opened when the application starts.  \p configFile is the file the section
+   * was read from and is only used in diagnostics.
+   */
+  void
+  Initialize(const std::string& configFile,
+             shared_ptr<const NlsrExec::ConfigSection> nodeConfig);
+
+  /**
+   * \brief Start NLSR from the recorded state of this router instead of from scratch
+   */
   void
-  Initialize(std::string& nodeConfig);
+  SetWarmStart(shared_ptr<const NlsrSnapshot> snapshot)
+  {
+    m_warmStart = snapshot;
+  }
+
+  bool
+  IsRunning() const
+  {
+    return m_instance != nullptr;
+  }
 
   nlsr::ConfParameter&
   GetConfParameter()
@@ -65,11 +96,32 @@ public:
     return m_nodeName;
   }
 
+  /**
+   * \brief Set the router name index shared by all NLSR applications
+   */
   void
-  SetNodeNameToIdMapping(std::string name, uint32_t id);
+  SetNodeIndex(shared_ptr<const NlsrNodeIndex> index)
+  {
+    m_nodeIndex = index;
+  }
 
   Ptr<Node>
-  GetNode(std::string name);
+  GetNode(const std::string& name) const;
+
+  /**
+   * \brief Learn the state of the link to a neighbor from the simulator ("link oracle")
+   *
+   * Normally called by the LinkControlHelper listener that an application with the LinkOracle
+   * attribute set registers while it is running.  The neighbor is marked ACTIVE or INACTIVE, and
+   * an adjacency LSA build is scheduled, at the time the hello protocol would have detected
+   * the change: at the next hello round for a recovered link, and hello-retries times
+   * hello-timeout after that for a failed link.
+   *
+   * \param neighborNodeId node-id of the neighbor, as in the neighbors section
+   * \param isUp new state of the link
+   */
+  void
+  NotifyLinkState(const std::string& neighborNodeId, bool isUp);
 
 protected:
   // inherited from Application base class.
@@ -79,13 +131,48 @@ protected:
   virtual void
   StopApplication ();     // Called at time specified by Stop
 
+  virtual void
+  DoDispose ();
+
+private:
+  void
+  OnLinkStateChange(Ptr<Node> node1, Ptr<Node> node2, bool isUp);
+
+  void
+  RemoveLinkStateListener();
+
+  static Ptr<NlsrApp>
+  FindApp(Ptr<Node> node);
+
+  Time
+  GetNextHelloRound() const;
+
+  void
+  SetNeighborStatus(std::string neighborName, bool isUp, uint64_t change);
+
+  void
+  UpdateRoutingTable();
+
 private:
   std::unique_ptr<ndn::NlsrExec> m_instance;
   std::string m_nodeConfigFile;
+  shared_ptr<const NlsrExec::ConfigSection> m_nodeConfig;
   std::string m_nodeName;
-  NodeContainer *m_nodes;
-  typedef std::map<std::string, uint32_t> NDN_NODE_MAP;
-  NDN_NODE_MAP m_ndn_node_map;
+  shared_ptr<const NlsrNodeIndex> m_nodeIndex;
+  shared_ptr<const NlsrSnapshot> m_warmStart;
+
+  bool m_linkOracle;
+  bool m_sharedRouting;
+  Time m_routingCalcInterval;
+  shared_ptr<const NlsrRoutingService::Result> m_routingTables; ///< \brief installed tables
+  EventId m_routingEvent;
+  LinkControlHelper::LinkStateListenerId m_linkListener; ///< \brief 0 if not registered
+  Time m_helloStart;                                  ///< \brief time of the first hello round
+  Time m_helloInterval;                               ///< \brief configured hello-interval
+  Time m_helloDeadTime;                               ///< \brief hello-timeout * hello-retries
+  std::map<std::string, std::string> m_neighborNames; ///< \brief node-id to router name
+  std::map<std::string, uint64_t> m_linkEvents;       ///< \brief last change per neighbor
+  uint64_t m_nLinkChanges;
 };
 
 } // namespace ndn
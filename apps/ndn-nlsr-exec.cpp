@@ -22,6 +22,7 @@
 #include <boost/filesystem.hpp>
 
 #include "ndn-nlsr-exec.hpp"
+#include "ndn-nlsr-snapshot.hpp"
 
 #include "conf-file-processor.hpp"
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
@@ -38,24 +39,31 @@ namespace ndn {
 
 INIT_LOGGER("NlsrExec");
 
-NlsrExec::NlsrExec(::ndn::KeyChain& keyChain, std::string& nlsrConf)
+NlsrExec::NlsrExec(::ndn::KeyChain& keyChain, const std::string& confFileName,
+                   const ConfigSection& nlsrConf)
   : m_ioService(m_face.getIoService())
   , m_scheduler(m_ioService)
   , m_keyChain(keyChain)
   , m_nlsr(m_ioService, m_scheduler, m_face, m_keyChain)
 {
-  m_nlsr.setConfFileName(nlsrConf);
+  m_nlsr.setConfFileName(confFileName);
+
+  // processConfSection() is added to NLSR by patches/NLSR (applied by wscript)
   nlsr::ConfFileProcessor configProcessor(m_nlsr, m_nlsr.getConfFileName());
-  if (!configProcessor.processConfFile()) {
-    throw Error("Error in configuration file processing! Exiting from NLSR");
+  if (!configProcessor.processConfSection(nlsrConf)) {
+    throw Error("Error in configuration file " + confFileName + " processing! Exiting from NLSR");
   }
 }
 
 void
-NlsrExec::run()
+NlsrExec::run(const NlsrSnapshot* warmStart)
 {
   m_nlsr.initialize();
 
+  if (warmStart != nullptr) {
+    warmStart->Restore(m_nlsr);
+  }
+
   try {
     m_nlsr.startEventLoop();
   }
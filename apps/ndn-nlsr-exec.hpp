@@ -31,6 +31,7 @@
 
 // boost needs to be included after ndn-cxx, otherwise there will be conflict with _1, _2, ...
 #include <boost/asio.hpp>
+#include <boost/property_tree/ptree.hpp>
 
 #include "conf-parameter.hpp"
 
@@ -38,6 +39,8 @@ namespace ns3 {
 
 namespace ndn {
 
+class NlsrSnapshot;
+
 class NlsrExec
 {
   class Error : public std::runtime_error
@@ -51,10 +54,22 @@ class NlsrExec
   };
 
 public:
-  NlsrExec(::ndn::KeyChain& keyChain, std::string& nlsrConf);
-
+  typedef boost::property_tree::ptree ConfigSection;
+
+  /**
+   * \brief Create NLSR instance configured from an already parsed configuration
+   * \param confFileName file the configuration was read from, reported in NLSR diagnostics
+   */
+  NlsrExec(::ndn::KeyChain& keyChain, const std::string& confFileName,
+           const ConfigSection& nlsrConf);
+
+  /**
+   * \brief Initialize and start NLSR
+   * \param warmStart if set, seed LSDB, adjacencies, sequence numbers and routing table from
+   *                  the snapshot before the event loop starts
+   */
   void
-  run();
+  run(const NlsrSnapshot* warmStart = nullptr);
 
   nlsr::ConfParameter&
   GetConfParameter()
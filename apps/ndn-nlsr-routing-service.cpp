@@ -0,0 +1,420 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-nlsr-routing-service.hpp"
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+#include "nlsr.hpp"
+#include "lsa.hpp"
+#include "lsdb.hpp"
+#include "adjacent.hpp"
+#include "adjacency-list.hpp"
+#include "conf-parameter.hpp"
+#include "route/nexthop.hpp"
+#include "route/routing-table.hpp"
+#include "route/name-prefix-table.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+NS_LOG_COMPONENT_DEFINE("ndn.NlsrRoutingService");
+
+namespace ns3 {
+namespace ndn {
+
+// results kept when no router holds them
+static const size_t CACHE_SIZE = 4;
+
+NlsrRoutingService::LsdbVersion::LsdbVersion(bool isHyperbolic, uint32_t maxFacesPerPrefix)
+  : m_isHyperbolic(isHyperbolic)
+  , m_maxFacesPerPrefix(maxFacesPerPrefix)
+  , m_nLsas(0)
+  , m_hash(0)
+{
+}
+
+uint64_t
+NlsrRoutingService::LsdbVersion::Hash(char type, const ::ndn::Name& origin, uint64_t seqNo)
+{
+  const Block& wire = origin.wireEncode();
+  size_t hash = boost::hash_range(wire.wire(), wire.wire() + wire.size());
+  boost::hash_combine(hash, type);
+  boost::hash_combine(hash, seqNo);
+
+  // spread the bits, so that the sum of hashes does not cancel out
+  uint64_t value = hash;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+void
+NlsrRoutingService::LsdbVersion::Add(char type, const ::ndn::Name& origin, uint64_t seqNo)
+{
+  ++m_nLsas;
+  m_hash += Hash(type, origin, seqNo);
+}
+
+void
+NlsrRoutingService::LsdbVersion::Remove(char type, const ::ndn::Name& origin, uint64_t seqNo)
+{
+  --m_nLsas;
+  m_hash -= Hash(type, origin, seqNo);
+}
+
+bool
+NlsrRoutingService::LsdbVersion::operator==(const LsdbVersion& other) const
+{
+  return m_hash == other.m_hash && m_nLsas == other.m_nLsas &&
+         m_isHyperbolic == other.m_isHyperbolic &&
+         m_maxFacesPerPrefix == other.m_maxFacesPerPrefix;
+}
+
+bool
+NlsrRoutingService::LsdbVersion::operator<(const LsdbVersion& other) const
+{
+  return std::tie(m_hash, m_nLsas, m_isHyperbolic, m_maxFacesPerPrefix) <
+         std::tie(other.m_hash, other.m_nLsas, other.m_isHyperbolic, other.m_maxFacesPerPrefix);
+}
+
+NlsrRoutingService::Result::Result(const LsdbVersion& version, bool isHyperbolic,
+                                   uint32_t maxFacesPerPrefix)
+  : m_version(version)
+  , m_isHyperbolic(isHyperbolic)
+  , m_maxFacesPerPrefix(maxFacesPerPrefix)
+  , m_nComputedTables(0)
+{
+}
+
+uint32_t
+NlsrRoutingService::Result::AddRouter(const std::string& router)
+{
+  NS_ASSERT(m_oracle == nullptr);
+  auto inserted = m_index.insert(std::make_pair(router, m_routers.size()));
+  if (inserted.second) {
+    m_routers.push_back(router);
+    Router params = {false, 0, 0};
+    m_routerParams.push_back(params);
+  }
+  return inserted.first->second;
+}
+
+void
+NlsrRoutingService::Result::SetCoordinates(uint32_t router, double radius, double angle)
+{
+  NS_ASSERT(m_oracle == nullptr && router < m_routers.size());
+  Router params = {true, radius, angle};
+  m_routerParams[router] = params;
+}
+
+void
+NlsrRoutingService::Result::AddLink(uint32_t router, uint32_t neighbor, double cost)
+{
+  NS_ASSERT(m_oracle == nullptr && router < m_routers.size() && neighbor < m_routers.size());
+  Link link = {router, neighbor, cost};
+  m_links.push_back(link);
+}
+
+void
+NlsrRoutingService::Result::SetLsas(std::vector<LsaId> lsas)
+{
+  std::sort(lsas.begin(), lsas.end());
+  m_lsas = std::move(lsas);
+}
+
+bool
+NlsrRoutingService::Result::HasLsa(char type, const ::ndn::Name& origin, uint64_t seqNo) const
+{
+  // compare with references, not to copy the name
+  return std::binary_search(m_lsas.begin(), m_lsas.end(), std::tie(type, origin, seqNo));
+}
+
+bool
+NlsrRoutingService::Result::FindRouter(const std::string& router, uint32_t& index) const
+{
+  auto found = m_index.find(router);
+  if (found == m_index.end()) {
+    return false;
+  }
+  index = found->second;
+  return true;
+}
+
+void
+NlsrRoutingService::Result::BuildOracle() const
+{
+  // the oracle needs all routers before the first link
+  m_oracle.reset(new NlsrRoutingOracle);
+  for (const Router& router : m_routerParams) {
+    if (m_isHyperbolic && router.hasCoordinates) {
+      m_oracle->AddHyperbolicRouter(m_maxFacesPerPrefix, router.radius, router.angle);
+    }
+    else {
+      m_oracle->AddRouter(m_maxFacesPerPrefix);
+    }
+  }
+  for (const Link& link : m_links) {
+    m_oracle->AddLink(link.from, link.to, link.cost);
+  }
+
+  m_tables.resize(m_routers.size());
+  m_isComputed.resize(m_routers.size(), false);
+}
+
+const NlsrRoutingOracle::RoutingTable&
+NlsrRoutingService::Result::GetRoutingTable(uint32_t router) const
+{
+  NS_ASSERT(router < m_routers.size());
+  if (m_oracle == nullptr) {
+    BuildOracle();
+  }
+
+  if (!m_isComputed[router]) {
+    m_tables[router] = m_oracle->ComputeRoutingTable(router);
+    m_isComputed[router] = true;
+    ++m_nComputedTables;
+  }
+  return m_tables[router];
+}
+
+void
+NlsrRoutingService::Result::ComputeAll(uint32_t nThreads) const
+{
+  if (m_oracle == nullptr) {
+    BuildOracle();
+  }
+  if (m_nComputedTables == m_routers.size()) {
+    return;
+  }
+
+  m_oracle->ComputeAll([this] (uint32_t router, const NlsrRoutingOracle::RoutingTable& table) {
+      if (!m_isComputed[router]) {
+        m_tables[router] = table;
+        m_isComputed[router] = true;
+        ++m_nComputedTables;
+      }
+    }, nThreads);
+
+  NS_LOG_INFO("Computed routing tables of " << m_routers.size() << " routers over "
+              << m_links.size() << " adjacencies");
+}
+
+NlsrRoutingService&
+NlsrRoutingService::Instance()
+{
+  static NlsrRoutingService instance;
+  return instance;
+}
+
+NlsrRoutingService::NlsrRoutingService()
+  : m_nThreads(0)
+  , m_nComputations(0)
+  , m_purgeThreshold(2 * CACHE_SIZE)
+{
+}
+
+NlsrRoutingService::LsdbVersion
+NlsrRoutingService::GetLsdbVersion(nlsr::Nlsr& nlsr)
+{
+  nlsr::ConfParameter& conf = nlsr.getConfParameter();
+  bool isHyperbolic = conf.getHyperbolicState() == nlsr::HYPERBOLIC_STATE_ON;
+
+  LsdbVersion version(isHyperbolic, conf.getMaxFacesPerPrefix());
+  for (const nlsr::AdjLsa& lsa : nlsr.getLsdb().getAdjLsdb()) {
+    version.Add('a', lsa.getOrigRouter(), lsa.getLsSeqNo());
+  }
+  if (isHyperbolic) {
+    for (const nlsr::CoordinateLsa& lsa : nlsr.getLsdb().getCoordinateLsdb()) {
+      version.Add('c', lsa.getOrigRouter(), lsa.getLsSeqNo());
+    }
+  }
+  return version;
+}
+
+shared_ptr<const NlsrRoutingService::Result>
+NlsrRoutingService::GetRoutingTables(nlsr::Nlsr& nlsr)
+{
+  shared_ptr<const Result> result = FindOrCompute(nlsr, GetLsdbVersion(nlsr));
+  result->ComputeAll(m_nThreads);
+  return result;
+}
+
+shared_ptr<const NlsrRoutingService::Result>
+NlsrRoutingService::Find(const LsdbVersion& version)
+{
+  auto cached = m_cache.find(version);
+  if (cached == m_cache.end()) {
+    return nullptr;
+  }
+
+  shared_ptr<const Result> result = cached->second.lock();
+  if (result == nullptr) {
+    m_cache.erase(cached);
+  }
+  return result;
+}
+
+void
+NlsrRoutingService::Insert(shared_ptr<const Result> result)
+{
+  m_cache[result->GetVersion()] = result;
+
+  m_recent.push_back(result);
+  if (m_recent.size() > CACHE_SIZE) {
+    m_recent.pop_front();
+  }
+
+  if (m_cache.size() >= m_purgeThreshold) {
+    Purge();
+  }
+}
+
+void
+NlsrRoutingService::Purge()
+{
+  for (auto entry = m_cache.begin(); entry != m_cache.end(); ) {
+    if (entry->second.expired()) {
+      entry = m_cache.erase(entry);
+    }
+    else {
+      ++entry;
+    }
+  }
+  m_purgeThreshold = std::max(2 * m_cache.size(), 2 * CACHE_SIZE);
+}
+
+void
+NlsrRoutingService::Clear()
+{
+  m_recent.clear();
+  Purge();
+}
+
+shared_ptr<const NlsrRoutingService::Result>
+NlsrRoutingService::FindOrCompute(nlsr::Nlsr& nlsr, const LsdbVersion& version)
+{
+  shared_ptr<const Result> result = Find(version);
+  if (result != nullptr && !IsReadFrom(*result, nlsr)) {
+    // the new result replaces the cached one, routers that installed it keep it
+    NS_LOG_WARN("LSDB version collision, reading the topology again");
+    result = nullptr;
+  }
+
+  if (result == nullptr) {
+    result = ReadTopology(nlsr, version);
+    ++m_nComputations;
+    Insert(result);
+  }
+  return result;
+}
+
+shared_ptr<NlsrRoutingService::Result>
+NlsrRoutingService::ReadTopology(nlsr::Nlsr& nlsr, const LsdbVersion& version) const
+{
+  nlsr::ConfParameter& conf = nlsr.getConfParameter();
+  bool isHyperbolic = conf.getHyperbolicState() == nlsr::HYPERBOLIC_STATE_ON;
+
+  auto result = make_shared<Result>(version, isHyperbolic, conf.getMaxFacesPerPrefix());
+  std::vector<Result::LsaId> lsas;
+  if (isHyperbolic) {
+    for (nlsr::CoordinateLsa& lsa : nlsr.getLsdb().getCoordinateLsdb()) {
+      lsas.push_back(Result::LsaId('c', lsa.getOrigRouter(), lsa.getLsSeqNo()));
+      uint32_t router = result->AddRouter(lsa.getOrigRouter().toUri());
+      result->SetCoordinates(router, lsa.getCorRadius(), lsa.getCorTheta());
+    }
+  }
+
+  for (nlsr::AdjLsa& lsa : nlsr.getLsdb().getAdjLsdb()) {
+    lsas.push_back(Result::LsaId('a', lsa.getOrigRouter(), lsa.getLsSeqNo()));
+    uint32_t origin = result->AddRouter(lsa.getOrigRouter().toUri());
+    for (const nlsr::Adjacent& adjacent : lsa.getAdjList().getAdjList()) {
+      result->AddLink(origin, result->AddRouter(adjacent.getName().toUri()),
+                      static_cast<double>(adjacent.getLinkCost()));
+    }
+  }
+
+  result->SetLsas(std::move(lsas));
+
+  NS_LOG_DEBUG("Read topology of " << result->GetNRouters() << " routers and "
+               << result->GetNLinks() << " adjacencies");
+  return result;
+}
+
+bool
+NlsrRoutingService::IsReadFrom(const Result& result, nlsr::Nlsr& nlsr)
+{
+  // LSDB lists hold one LSA per origin, so equal numbers of LSAs and inclusion mean equality
+  for (const nlsr::AdjLsa& lsa : nlsr.getLsdb().getAdjLsdb()) {
+    if (!result.HasLsa('a', lsa.getOrigRouter(), lsa.getLsSeqNo())) {
+      return false;
+    }
+  }
+  if (nlsr.getConfParameter().getHyperbolicState() == nlsr::HYPERBOLIC_STATE_ON) {
+    for (const nlsr::CoordinateLsa& lsa : nlsr.getLsdb().getCoordinateLsdb()) {
+      if (!result.HasLsa('c', lsa.getOrigRouter(), lsa.getLsSeqNo())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool
+NlsrRoutingService::UpdateRoutingTable(nlsr::Nlsr& nlsr, shared_ptr<const Result>& installed)
+{
+  LsdbVersion current = GetLsdbVersion(nlsr);
+  if (installed != nullptr && installed->GetVersion() == current && IsReadFrom(*installed, nlsr)) {
+    return false;
+  }
+
+  shared_ptr<const Result> result = FindOrCompute(nlsr, current);
+  uint32_t self = 0;
+  if (!result->FindRouter(nlsr.getConfParameter().getRouterPrefix().toUri(), self)) {
+    return false; // own adjacency LSA not built yet
+  }
+  installed = result;
+
+  // the other routers find their tables computed when they reach this version
+  result->ComputeAll(m_nThreads);
+
+  // same steps as nlsr::RoutingTable::calculate(): replace all entries, then update the NPT
+  nlsr::RoutingTable& routingTable = nlsr.getRoutingTable();
+  routingTable.getRoutingTableEntry().clear();
+
+  const NlsrRoutingOracle::RoutingTable& rows = result->GetRoutingTable(self);
+  for (uint32_t destination = 0; destination < rows.size(); ++destination) {
+    for (const NlsrRoutingOracle::NextHop& nextHop : rows[destination]) {
+      ::ndn::Name neighbor(result->GetRouter(nextHop.neighbor));
+      nlsr::NextHop route(nlsr.getAdjacencyList().getAdjacent(neighbor).getConnectingFaceUri(),
+                          nextHop.cost);
+      routingTable.addNextHop(::ndn::Name(result->GetRouter(destination)), route);
+    }
+  }
+  nlsr.getNamePrefixTable().updateWithNewRoute();
+
+  NS_LOG_DEBUG(result->GetRouter(self) << " installed shared routing table");
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
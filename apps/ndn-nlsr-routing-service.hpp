@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_NLSR_ROUTING_SERVICE_HPP
+#define NDN_NLSR_ROUTING_SERVICE_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/utils/topology/nlsr-routing-oracle.hpp"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace nlsr {
+class Nlsr;
+} // namespace nlsr
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Routing table calculation shared by simulated NLSR routers
+ *
+ * After convergence every router holds the same LSDB, yet each one runs its own Dijkstra or
+ * hyperbolic calculation.  The service instead memoizes the routing tables by LSDB version:
+ * the set of (origin, sequence number) of all adjacency and coordinate LSAs together with
+ * the routing parameters.  For each version, the topology is read from the LSDB once, and
+ * the first router that requests it computes the routing tables of all routers in parallel
+ * with NlsrRoutingOracle.  Each router then reads its own next-hop rows.
+ *
+ * A result stays cached as long as a router has it installed, so routers that are a few LSAs
+ * apart during convergence do not evict each other's tables.  The last few results are also
+ * kept when no router holds them.
+ */
+class NlsrRoutingService
+{
+public:
+  /**
+   * \brief Version of the LSDB content used by the routing calculation
+   *
+   * The LSAs are combined with a commutative, invertible hash, so the version does not depend
+   * on the order of the LSDB lists, and it can be updated as LSAs are installed and removed.
+   * Equal versions are only likely to be the same LSDB; Result keeps the LSAs to confirm it.
+   */
+  class LsdbVersion
+  {
+  public:
+    LsdbVersion(bool isHyperbolic = false, uint32_t maxFacesPerPrefix = 0);
+
+    void
+    Add(char type, const ::ndn::Name& origin, uint64_t seqNo);
+
+    void
+    Remove(char type, const ::ndn::Name& origin, uint64_t seqNo);
+
+    bool
+    operator==(const LsdbVersion& other) const;
+
+    bool
+    operator!=(const LsdbVersion& other) const
+    {
+      return !(*this == other);
+    }
+
+    bool
+    operator<(const LsdbVersion& other) const;
+
+  private:
+    static uint64_t
+    Hash(char type, const ::ndn::Name& origin, uint64_t seqNo);
+
+  private:
+    bool m_isHyperbolic;
+    uint32_t m_maxFacesPerPrefix;
+    uint64_t m_nLsas;
+    uint64_t m_hash;
+  };
+
+  /**
+   * \brief Topology of one LSDB version and the routing tables computed from it
+   *
+   * Routing tables are computed on first use and kept.
+   */
+  class Result
+  {
+  public:
+    /// \brief (type, origin, sequence number) of an LSA
+    typedef std::tuple<char, ::ndn::Name, uint64_t> LsaId;
+
+    Result(const LsdbVersion& version, bool isHyperbolic, uint32_t maxFacesPerPrefix);
+
+    /**
+     * \brief Get index of router \p router, adding it if not known
+     *
+     * Routers and links can only be added before the first routing table is computed.
+     */
+    uint32_t
+    AddRouter(const std::string& router);
+
+    void
+    SetCoordinates(uint32_t router, double radius, double angle);
+
+    void
+    AddLink(uint32_t router, uint32_t neighbor, double cost);
+
+    /**
+     * \brief Set the LSAs the topology is read from
+     */
+    void
+    SetLsas(std::vector<LsaId> lsas);
+
+    /**
+     * \brief Check if the topology is read from LSA (\p type, \p origin, \p seqNo)
+     */
+    bool
+    HasLsa(char type, const ::ndn::Name& origin, uint64_t seqNo) const;
+
+    const LsdbVersion&
+    GetVersion() const
+    {
+      return m_version;
+    }
+
+    /**
+     * \brief Find index of router \p router
+     * \return false if the router is not part of the topology
+     */
+    bool
+    FindRouter(const std::string& router, uint32_t& index) const;
+
+    const std::string&
+    GetRouter(uint32_t index) const
+    {
+      return m_routers[index];
+    }
+
+    uint32_t
+    GetNRouters() const
+    {
+      return m_routers.size();
+    }
+
+    size_t
+    GetNLinks() const
+    {
+      return m_links.size();
+    }
+
+    /**
+     * \brief Get routing table of \p router, computing it on first use
+     */
+    const NlsrRoutingOracle::RoutingTable&
+    GetRoutingTable(uint32_t router) const;
+
+    /**
+     * \brief Compute the routing tables of all routers with \p nThreads threads
+     *
+     * Tables computed earlier are kept.
+     */
+    void
+    ComputeAll(uint32_t nThreads) const;
+
+    size_t
+    GetNComputedTables() const
+    {
+      return m_nComputedTables;
+    }
+
+  private:
+    void
+    BuildOracle() const;
+
+  private:
+    struct Router
+    {
+      bool hasCoordinates;
+      double radius;
+      double angle;
+    };
+
+    struct Link
+    {
+      uint32_t from;
+      uint32_t to;
+      double cost;
+    };
+
+    LsdbVersion m_version;
+    std::vector<LsaId> m_lsas; ///< \brief sorted
+    bool m_isHyperbolic;
+    uint32_t m_maxFacesPerPrefix;
+    std::vector<std::string> m_routers;
+    std::unordered_map<std::string, uint32_t> m_index;
+    std::vector<Router> m_routerParams;
+    std::vector<Link> m_links;
+
+    mutable std::unique_ptr<NlsrRoutingOracle> m_oracle;
+    mutable std::vector<NlsrRoutingOracle::RoutingTable> m_tables;
+    mutable std::vector<bool> m_isComputed;
+    mutable size_t m_nComputedTables;
+  };
+
+  static NlsrRoutingService&
+  Instance();
+
+  /**
+   * \brief Set number of threads computing routing tables, 0 for all hardware threads
+   */
+  void
+  SetNThreads(uint32_t nThreads)
+  {
+    m_nThreads = nThreads;
+  }
+
+  /**
+   * \brief Get the LSDB version of the router, i.e., the memoization key
+   */
+  static LsdbVersion
+  GetLsdbVersion(nlsr::Nlsr& nlsr);
+
+  /**
+   * \brief Get routing tables of all routers for the LSDB of \p nlsr
+   *
+   * The topology is read on first request for an LSDB version, and all routing tables not
+   * computed yet are computed in parallel.
+   */
+  shared_ptr<const Result>
+  GetRoutingTables(nlsr::Nlsr& nlsr);
+
+  /**
+   * \brief Replace routing table of \p nlsr with its rows of the shared result and update
+   *        the name prefix table (FIB)
+   *
+   * The first router to request an LSDB version computes the routing tables of all routers.
+   *
+   * \param[in,out] installed result installed earlier; nothing is done if its version is
+   *                          the current one.  Holding it keeps the result cached.
+   * \return true if the routing table was replaced
+   */
+  bool
+  UpdateRoutingTable(nlsr::Nlsr& nlsr, shared_ptr<const Result>& installed);
+
+  /**
+   * \brief Get the cached result of LSDB version \p version
+   *
+   * Only the version is compared; UpdateRoutingTable() and GetRoutingTables() also check that
+   * the result is read from the same LSAs.
+   *
+   * \return the result, or nullptr if not cached
+   */
+  shared_ptr<const Result>
+  Find(const LsdbVersion& version);
+
+  /**
+   * \brief Add a result to the cache, replacing a cached result of the same version
+   */
+  void
+  Insert(shared_ptr<const Result> result);
+
+  /**
+   * \brief Drop all cached results that are not held by a router
+   */
+  void
+  Clear();
+
+  size_t
+  GetNComputations() const
+  {
+    return m_nComputations;
+  }
+
+  /**
+   * \brief Get number of cached results, including not yet purged unreferenced ones
+   */
+  size_t
+  GetNCachedResults() const
+  {
+    return m_cache.size();
+  }
+
+private:
+  NlsrRoutingService();
+
+  shared_ptr<const Result>
+  FindOrCompute(nlsr::Nlsr& nlsr, const LsdbVersion& version);
+
+  /**
+   * \brief Check if \p result is read from exactly the LSAs of the LSDB of \p nlsr
+   *
+   * \pre the version of \p result equals the LSDB version of \p nlsr, so both have the
+   *      same number of LSAs
+   */
+  static bool
+  IsReadFrom(const Result& result, nlsr::Nlsr& nlsr);
+
+  shared_ptr<Result>
+  ReadTopology(nlsr::Nlsr& nlsr, const LsdbVersion& version) const;
+
+  void
+  Purge();
+
+private:
+  uint32_t m_nThreads;
+  size_t m_nComputations;
+  std::map<LsdbVersion, std::weak_ptr<const Result>> m_cache;
+  std::deque<shared_ptr<const Result>> m_recent;
+  size_t m_purgeThreshold;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_NLSR_ROUTING_SERVICE_HPP
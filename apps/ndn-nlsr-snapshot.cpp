@@ -0,0 +1,294 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-nlsr-snapshot.hpp"
+#include "ndn-nlsr-app.hpp"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+
+#include "nlsr.hpp"
+#include "lsa.hpp"
+#include "lsdb.hpp"
+#include "adjacent.hpp"
+#include "adjacency-list.hpp"
+#include "sequencing-manager.hpp"
+#include "route/nexthop.hpp"
+#include "route/routing-table.hpp"
+#include "route/routing-table-entry.hpp"
+#include "route/name-prefix-table.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.NlsrSnapshot");
+
+namespace ns3 {
+namespace ndn {
+
+static const char* SNAPSHOT_MAGIC = "NLSR-SNAPSHOT 1";
+
+void
+NlsrSnapshot::Capture(nlsr::Nlsr& nlsr)
+{
+  std::string router = nlsr.getConfParameter().getRouterPrefix().toUri();
+  RouterState& state = m_routers[router] = RouterState();
+
+  nlsr::SequencingManager& sequencing = nlsr.getSequencingManager();
+  state.nameLsaSeq = sequencing.getNameLsaSeq();
+  state.adjLsaSeq = sequencing.getAdjLsaSeq();
+  state.corLsaSeq = sequencing.getCorLsaSeq();
+
+  for (const nlsr::Adjacent& adjacent : nlsr.getAdjacencyList().getAdjList()) {
+    state.adjacencies.push_back(std::make_pair(adjacent.getName().toUri(), adjacent.getStatus()));
+  }
+
+  for (nlsr::NameLsa lsa : nlsr.getLsdb().getNameLsdb()) {
+    state.nameLsas.push_back(lsa.getData());
+  }
+  for (nlsr::AdjLsa lsa : nlsr.getLsdb().getAdjLsdb()) {
+    state.adjLsas.push_back(lsa.getData());
+  }
+  for (nlsr::CoordinateLsa lsa : nlsr.getLsdb().getCoordinateLsdb()) {
+    state.corLsas.push_back(lsa.getData());
+  }
+
+  for (nlsr::RoutingTableEntry entry : nlsr.getRoutingTable().getRoutingTableEntry()) {
+    for (const nlsr::NextHop& nextHop : entry.getNexthopList().getNextHops()) {
+      Route route = {entry.getDestination().toUri(), nextHop.getConnectingFaceUri(),
+                     nextHop.getRouteCost()};
+      state.routes.push_back(route);
+    }
+  }
+
+  NS_LOG_DEBUG(router << ": " << state.nameLsas.size() << " name LSAs, " << state.adjLsas.size()
+                      << " adjacency LSAs, " << state.routes.size() << " routes");
+}
+
+bool
+NlsrSnapshot::Restore(nlsr::Nlsr& nlsr) const
+{
+  std::string router = nlsr.getConfParameter().getRouterPrefix().toUri();
+  const RouterState* state = Find(router);
+  if (state == nullptr) {
+    NS_LOG_ERROR("No snapshot state for " << router << ", starting cold");
+    return false;
+  }
+
+  // continue numbering own LSAs after the recorded ones, so neighbors accept them
+  nlsr::SequencingManager& sequencing = nlsr.getSequencingManager();
+  sequencing.setNameLsaSeq(state->nameLsaSeq);
+  sequencing.setAdjLsaSeq(state->adjLsaSeq);
+  sequencing.setCorLsaSeq(state->corLsaSeq);
+
+  for (const auto& adjacency : state->adjacencies) {
+    nlsr.getAdjacencyList().setStatusOfNeighbor(::ndn::Name(adjacency.first),
+                                                static_cast<nlsr::Adjacent::Status>(
+                                                  adjacency.second));
+  }
+
+  for (const std::string& content : state->nameLsas) {
+    nlsr::NameLsa lsa;
+    if (lsa.initializeFromContent(content)) {
+      nlsr.getLsdb().installNameLsa(lsa);
+    }
+  }
+  for (const std::string& content : state->adjLsas) {
+    nlsr::AdjLsa lsa;
+    if (lsa.initializeFromContent(content)) {
+      nlsr.getLsdb().installAdjLsa(lsa);
+    }
+  }
+  for (const std::string& content : state->corLsas) {
+    nlsr::CoordinateLsa lsa;
+    if (lsa.initializeFromContent(content)) {
+      nlsr.getLsdb().installCoordinateLsa(lsa);
+    }
+  }
+
+  for (const Route& route : state->routes) {
+    nlsr::NextHop nextHop(route.faceUri, route.cost);
+    nlsr.getRoutingTable().addNextHop(::ndn::Name(route.destination), nextHop);
+  }
+  // push recorded routes to the forwarder instead of waiting for the routing calculation
+  nlsr.getNamePrefixTable().updateWithNewRoute();
+
+  NS_LOG_DEBUG(router << " warm started with " << state->routes.size() << " routes");
+  return true;
+}
+
+const NlsrSnapshot::RouterState*
+NlsrSnapshot::Find(const std::string& routerPrefix) const
+{
+  std::map<std::string, RouterState>::const_iterator it = m_routers.find(routerPrefix);
+  if (it == m_routers.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+bool
+NlsrSnapshot::Save(const std::string& file) const
+{
+  std::ofstream os(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+  if (!os.is_open()) {
+    NS_LOG_ERROR("Cannot open " << file << " for writing");
+    return false;
+  }
+
+  // route costs are doubles, write enough digits to load them back exactly
+  os << std::setprecision(std::numeric_limits<double>::max_digits10);
+  os << SNAPSHOT_MAGIC << "\n";
+  for (const auto& router : m_routers) {
+    const RouterState& state = router.second;
+    os << "router " << router.first << "\n";
+    os << "seq " << state.nameLsaSeq << " " << state.adjLsaSeq << " " << state.corLsaSeq << "\n";
+    for (const auto& adjacency : state.adjacencies) {
+      os << "adj " << adjacency.first << " " << adjacency.second << "\n";
+    }
+    for (const std::string& lsa : state.nameLsas) {
+      os << "name-lsa " << lsa << "\n";
+    }
+    for (const std::string& lsa : state.adjLsas) {
+      os << "adj-lsa " << lsa << "\n";
+    }
+    for (const std::string& lsa : state.corLsas) {
+      os << "cor-lsa " << lsa << "\n";
+    }
+    for (const Route& route : state.routes) {
+      os << "route " << route.destination << " " << route.faceUri << " " << route.cost << "\n";
+    }
+    os << "end\n";
+  }
+
+  return static_cast<bool>(os);
+}
+
+bool
+NlsrSnapshot::Load(const std::string& file)
+{
+  std::ifstream is(file.c_str());
+  if (!is.is_open()) {
+    NS_LOG_ERROR("Cannot open " << file << " for reading");
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(is, line) || line != SNAPSHOT_MAGIC) {
+    NS_LOG_ERROR(file << " is not an NLSR snapshot");
+    return false;
+  }
+
+  RouterState* state = nullptr;
+  size_t lineNo = 1;
+  while (std::getline(is, line)) {
+    ++lineNo;
+    if (line.empty()) {
+      continue;
+    }
+
+    size_t separator = line.find(' ');
+    std::string key = line.substr(0, separator);
+    std::string value = separator == std::string::npos ? "" : line.substr(separator + 1);
+    std::istringstream values(value);
+
+    if (key == "router") {
+      state = &(m_routers[value] = RouterState());
+      continue;
+    }
+    if (state == nullptr) {
+      NS_LOG_ERROR(file << ":" << lineNo << ": record outside of router section");
+      return false;
+    }
+
+    bool isOk = true;
+    if (key == "seq") {
+      isOk = static_cast<bool>(values >> state->nameLsaSeq >> state->adjLsaSeq
+                                      >> state->corLsaSeq);
+    }
+    else if (key == "adj") {
+      std::pair<std::string, int32_t> adjacency;
+      isOk = static_cast<bool>(values >> adjacency.first >> adjacency.second);
+      state->adjacencies.push_back(adjacency);
+    }
+    else if (key == "name-lsa") {
+      state->nameLsas.push_back(value);
+    }
+    else if (key == "adj-lsa") {
+      state->adjLsas.push_back(value);
+    }
+    else if (key == "cor-lsa") {
+      state->corLsas.push_back(value);
+    }
+    else if (key == "route") {
+      Route route;
+      isOk = static_cast<bool>(values >> route.destination >> route.faceUri >> route.cost);
+      state->routes.push_back(route);
+    }
+    else if (key == "end") {
+      state = nullptr;
+    }
+    else {
+      isOk = false;
+    }
+
+    if (!isOk) {
+      NS_LOG_ERROR(file << ":" << lineNo << ": malformed record [" << line << "]");
+      return false;
+    }
+  }
+
+  NS_LOG_INFO("Loaded NLSR snapshot of " << m_routers.size() << " routers from " << file);
+  return true;
+}
+
+bool
+NlsrSnapshot::SaveAll(const std::string& file)
+{
+  NlsrSnapshot snapshot;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    for (uint32_t i = 0; i < (*node)->GetNApplications(); ++i) {
+      Ptr<NlsrApp> app = DynamicCast<NlsrApp>((*node)->GetApplication(i));
+      if (app != nullptr && app->IsRunning()) {
+        snapshot.Capture(app->GetNlsr());
+      }
+    }
+  }
+
+  NS_LOG_INFO("Saving NLSR snapshot of " << snapshot.GetN() << " routers to " << file);
+  return snapshot.Save(file);
+}
+
+void
+NlsrSnapshot::ScheduleSaveAll(Time delay, const std::string& file)
+{
+  Simulator::Schedule(delay, &NlsrSnapshot::DoSaveAll, file);
+}
+
+void
+NlsrSnapshot::DoSaveAll(std::string file)
+{
+  SaveAll(file);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_NLSR_SNAPSHOT_HPP
+#define NDN_NLSR_SNAPSHOT_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace nlsr {
+class Nlsr;
+} // namespace nlsr
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Snapshot of the protocol state of NLSR routers
+ *
+ * The snapshot holds, per router, the LSDB (name, adjacency and coordinate LSAs), adjacency
+ * status, LSA sequence numbers and routing table.  It is captured from a converged run and
+ * written to a compact text file; a later run restores it when NlsrApp starts, so the
+ * simulation begins in steady state instead of going through hello discovery, LSA flooding
+ * and sync.
+ *
+ * File format (one record per line, LSAs in NLSR content encoding):
+ *
+ *     NLSR-SNAPSHOT 1
+ *     router <router-prefix>
+ *     seq <name-lsa-seq> <adj-lsa-seq> <cor-lsa-seq>
+ *     adj <neighbor> <status>
+ *     name-lsa <content>
+ *     adj-lsa <content>
+ *     cor-lsa <content>
+ *     route <destination> <face-uri> <cost>
+ *     end
+ */
+class NlsrSnapshot
+{
+public:
+  struct Route
+  {
+    std::string destination;
+    std::string faceUri;
+    double cost;
+  };
+
+  struct RouterState
+  {
+    RouterState()
+      : nameLsaSeq(0)
+      , adjLsaSeq(0)
+      , corLsaSeq(0)
+    {
+    }
+
+    uint64_t nameLsaSeq;
+    uint64_t adjLsaSeq;
+    uint64_t corLsaSeq;
+    std::vector<std::pair<std::string, int32_t>> adjacencies;
+    std::vector<std::string> nameLsas;
+    std::vector<std::string> adjLsas;
+    std::vector<std::string> corLsas;
+    std::vector<Route> routes;
+  };
+
+  /**
+   * \brief Record state of the NLSR instance, replacing earlier state of the same router
+   */
+  void
+  Capture(nlsr::Nlsr& nlsr);
+
+  /**
+   * \brief Seed the NLSR instance with the recorded state of its router
+   *
+   * Must be called after nlsr::Nlsr::initialize().
+   *
+   * \return false if the snapshot has no state for the router
+   */
+  bool
+  Restore(nlsr::Nlsr& nlsr) const;
+
+  /**
+   * \brief Get recorded state of a router
+   * \return state or nullptr if the router is unknown
+   */
+  const RouterState*
+  Find(const std::string& routerPrefix) const;
+
+  size_t
+  GetN() const
+  {
+    return m_routers.size();
+  }
+
+  bool
+  Save(const std::string& file) const;
+
+  bool
+  Load(const std::string& file);
+
+  /**
+   * \brief Capture all running NlsrApp instances and save them to \p file
+   */
+  static bool
+  SaveAll(const std::string& file);
+
+  /**
+   * \brief Schedule SaveAll \p delay from now, typically once the network has converged
+   */
+  static void
+  ScheduleSaveAll(Time delay, const std::string& file);
+
+private:
+  static void
+  DoSaveAll(std::string file);
+
+private:
+  std::map<std::string, RouterState> m_routers;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_NLSR_SNAPSHOT_HPP
@@ -0,0 +1,73 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-binary-log-decode.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM/utils/ndn-binary-log.hpp"
+
+#include <fstream>
+#include <iostream>
+
+namespace ns3 {
+
+/**
+ * Convert a binary log, recorded by a simulation built with --enable-binary-log, into NS_LOG
+ * text:
+ *
+ *     NS_LOG=ndn.Consumer=level_all NS_BINARY_LOG=run.bin ./waf --run=ndn-simple
+ *     ./waf --run="ndn-binary-log-decode --input=run.bin --output=run.log"
+ */
+
+int
+main(int argc, char* argv[])
+{
+  std::string input = "ns3-log.bin";
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue("input", "Binary log file", input);
+  cmd.AddValue("output", "Text log file (standard output if empty)", output);
+  cmd.Parse(argc, argv);
+
+  std::ifstream is(input.c_str(), std::ios_base::in | std::ios_base::binary);
+  if (!is.is_open()) {
+    std::cerr << "Cannot open " << input << std::endl;
+    return 1;
+  }
+
+  if (output.empty()) {
+    return ndn::BinaryLog::Decode(is, std::cout) ? 0 : 1;
+  }
+
+  std::ofstream os(output.c_str());
+  if (!os.is_open()) {
+    std::cerr << "Cannot open " << output << std::endl;
+    return 1;
+  }
+  return ndn::BinaryLog::Decode(is, os) ? 0 : 1;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -46,6 +46,10 @@
 #include <set>
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <thread>
+
+#include "utils/topology/nlsr-conf-generator.hpp"
 
 #include <unistd.h>
 #include <sys/types.h>
@@ -267,411 +271,14 @@ ProcessRouterList(const std::string &file)
   return true;
 }
 
-bool
-ProcessBriteTopology(std::string confFile, std::string rtType)
-{
-  std::string brite_topo_file = confFile;
-  ifstream topgen;
-  topgen.open (brite_topo_file.c_str ());
-  typedef map<std::string, pt::ptree> nodeConfigMap;
-  nodeConfigMap nodeMap;
-  const char *homeDir = NULL;
-  std::string nodeLabel;
-  //ofstream graphvizfile;
-
-  if ((homeDir = getenv("HOME")) == NULL) {
-      homeDir = getpwuid(getuid())->pw_dir;
-  }
-  NS_LOG_INFO ("Home dir is: " << homeDir);
-
-  if ( !topgen.is_open () || !topgen.good () ) {
-    NS_FATAL_ERROR ("Cannot open file " << brite_topo_file << " for reading");
-    return false;
-  }
-
-  while (!topgen.eof ()) {
-    string line;
-    getline (topgen, line);
-    NS_LOG_INFO ("Brite config line: " << line);
-
-    if (line.compare(0, 9, "Topology:") == 0)  {
-      std::size_t f1 = line.find_first_of("(", 0);
-      std::size_t f2 = line.find_first_of(" ", f1+2);
-      nodeLabel = line.substr(f1+2, f2-f1-2);
-    }
- 
-    if (line.compare(0, 6, "Nodes:") == 0) 
-      break;
-  }
-
-  if (topgen.eof ()) {
-    NS_FATAL_ERROR ("BRITE topology config file " << brite_topo_file << " does not have \"Nodes\" section");
-    return false;
-  }
-
-  // Read network 'Node' configuration.
-  while (!topgen.eof ()) {
-    string line;
-    getline (topgen,line);
-
-    if (line[0] == ';') 
-      continue;
-    if (line.compare(0, 6, "Edges:") == 0) 
-      break;
-
-    istringstream linebuffer(line);
-    std::string nodeId, xpos, ypos, indegree, outdegree, asid, type;
-    linebuffer >> nodeId >> xpos >> ypos >> indegree >> outdegree >> asid >> type;
-
-    if (nodeId.empty ()) 
-      continue;
-
-    std::string id = nodeId;
-    nodeId = "N" + nodeId;
-    std::string city = "NA";
-    std::string latitude = "3";
-    std::string longitude = "1";
-    std::string network = "/n";
-    std::string site = "/e";
-    std::string router = "/%C1r" + id;
-    std::string lsaRefreshTime = "1800";
-    std::string routerDeadInterval = "3600";
-    std::string lsaInterestLifetime = "4";
-    std::string logLevel = "INFO";
-    std::string logDir = std::string(homeDir) + "/log/" + nodeId + "/nlsr";
-    std::string seqDir = std::string(homeDir) + "/log/" + nodeId + "/nlsr";
-    std::string helloRetries = "2";
-    std::string helloTimeout = "5";
-    std::string helloInterval = "60";
-    std::string adjLsaBuildInterval = "5";
-    std::string firstHelloInterval = "10";
-    std::string state;
-    std::string radius;
-    std::string angle;
-
-    if (rtType.compare("hb") == 0) {
-      state = "on";
-      radius = std::string("10") + id;
-      angle = id;
-    } else {
-      state = "off";
-      radius = "123.456";
-      angle = "1.45";
-    }
-    std::string maxFacesPerPrefix = "3";
-    std::string routingCalcInterval = "15";
-    std::string prefix1 = "/n/e/" + nodeId + "/p1";
-    std::string prefix2 = "/n/e/" + nodeId + "/p2";
-
-    NS_LOG_DEBUG ("Router: " << nodeId << " " << city << " " << latitude << " " << longitude << " " << network << " " << site << " " << router << " " << lsaRefreshTime << " " << routerDeadInterval << " " << lsaInterestLifetime << " " << logLevel << " " << logDir << " " << seqDir << " " << helloRetries << " " << helloTimeout << " " << helloInterval << " " << adjLsaBuildInterval << " " << firstHelloInterval << " " << state << " " << radius << " " << angle << " " << maxFacesPerPrefix << " " << routingCalcInterval << " " << prefix1 << " " << prefix2);
-
-    // Add General config
-    pt::ptree nt;
-    nt.put("general.node-id", nodeId);
-    nt.put("general.city", city);
-    nt.put("general.latitude", latitude);
-    nt.put("general.longitude", longitude);
-    nt.put("general.network", network);
-    nt.put("general.site", site);
-    nt.put("general.router", router);
-    nt.put("general.lsa-refresh-time", lsaRefreshTime);
-    nt.put("general.router-dead-interval", routerDeadInterval);
-    nt.put("general.lsa-interest-lifetime", lsaInterestLifetime);
-    nt.put("general.log-level", logLevel);
-    nt.put("general.log-dir", logDir);
-    nt.put("general.seq-dir", seqDir);
-
-    // Add Neighbors config
-    nt.put("neighbors.hello-retries", helloRetries);
-    nt.put("neighbors.hello-timeout", helloTimeout);
-    nt.put("neighbors.hello-interval", helloInterval);
-    nt.put("neighbors.adj-lsa-build-interval", adjLsaBuildInterval);
-    nt.put("neighbors.first-hello-interval", firstHelloInterval);
-
-    // Add Hyperbolic config
-    nt.put("hyperbolic.state", state);
-    nt.put("hyperbolic.radius", radius);
-    nt.put("hyperbolic.angle", angle);
-
-    // Add Fib config
-    nt.put("fib.max-faces-per-prefix", maxFacesPerPrefix);
-    nt.put("fib.routing-calc-interval", routingCalcInterval);
-
-    // Add Advertising config
-    nt.add("advertising.prefix", prefix1);
-    nt.add("advertising.prefix", prefix2);
-
-    // Add Security config
-    nt.put("security.validator.trust-anchor.type", "any");
-    nt.put("security.prefix-update-validator.trust-anchor.type", "any");
-
-    // Save the tree object for later on.
-    nodeMap[nodeId] = nt;
-
-    if (topgen.eof ()) {
-      NS_FATAL_ERROR ("BRITE topology config file " << brite_topo_file << " does not have \"Edge\" section");
-      return false;
-    }
-
-    linebuffer.str("");
-  }
-
-  // Read network 'Link' configuration.
-  while (!topgen.eof()) {
-    string line;
-    getline (topgen,line);
-
-    if (line[0] == ';') 
-      continue;
-
-    istringstream linebuffer(line);
-    std::string edgeId, srcNodeId, dstNodeId, length, delay, bandwidth, asfrom, asto, type, unknown, srcId, dstId;
-    linebuffer >> edgeId >> srcNodeId >> dstNodeId >> length >> delay >> bandwidth >> asfrom >> asto >> type >> unknown;
-
-    if (edgeId.empty ()) 
-      continue;
-
-    srcId = srcNodeId;
-    dstId = dstNodeId;
-    srcNodeId = "N" + srcNodeId;
-    dstNodeId = "N" + dstNodeId;
-    std::string name = "/n/e/%C1r" + dstId;
-    std::string faceUri = "tcp4://10.0.0." + dstId + ":6363";
-    std::string linkCost = "25";
-    //std::string length = length.substr(0, length.find('.', 0) + 3);
-    bandwidth = "100"; //bandwidth.substr(0, bandwidth.find('.', 0) + 3);
-    std::string metric = "1";
-    delay = "0"; //delay.substr(0, delay.find('.', 0) + 3);
-    std::string queue = "1000";
-
-    NS_LOG_DEBUG ("Adjacent router: " << srcNodeId << " " << dstNodeId << " " << name << " " << faceUri << " " << linkCost << " " << bandwidth << " " << metric << " " << delay << " " << queue);
-
-    // Establish full-duplex link between adjacent nodes.
-    nodeConfigMap::iterator it = nodeMap.find(srcNodeId);
-    if (it != nodeMap.end()) {
-      auto& nbr = (it->second).get_child("neighbors");
-
-      // Add neighbor
-      pt::ptree nb;
-      nb.add("node-id", dstNodeId);
-      nb.add("name", name);
-      nb.add("face-uri", faceUri);
-      nb.add("link-cost", linkCost);
-      nb.add("bandwidth", bandwidth);
-      nb.add("metric", metric);
-      nb.add("delay", delay);
-      nb.add("queue", queue);
-      nbr.add_child("neighbor", nb);
-    }
-
-    it = nodeMap.find(dstNodeId);
-    if (it != nodeMap.end()) {
-
-      // Add neighbor
-      auto& nbr = (it->second).get_child("neighbors");
-      name = "/n/e/%C1r" + srcId;
-      faceUri = "tcp4://10.0.0." + srcId + ":6363";
-
-      pt::ptree nb;
-      nb.add("node-id", srcNodeId);
-      nb.add("name", name);
-      nb.add("face-uri", faceUri);
-      nb.add("link-cost", linkCost);
-      nb.add("bandwidth", bandwidth);
-      nb.add("metric", metric);
-      nb.add("delay", delay);
-      nb.add("queue", queue);
-      nbr.add_child("neighbor", nb);
-    }
-
-    srcNodeId.clear();
-    linebuffer.str("");
-  }
-
-  // Generate the NLSR configuration file
-  for (nodeConfigMap::iterator it = nodeMap.begin(); it != nodeMap.end(); ++it) {
-    std::string filename = "src/ndnSIM/examples/ndn-nlsr-conf/nlsr_node_" + it->first + ".conf";
-    pt::write_info(filename, it->second);
-  }
-
-  // Generate topology config file.
-  std::string sim_config = "src/ndnSIM/examples/ndn-nlsr-conf/nlsr_sim.conf";
-  pt::ptree simTree;
-  for (nodeConfigMap::iterator itr = nodeMap.begin(); itr != nodeMap.end(); ++itr) {
-    std::string filename = "src/ndnSIM/examples/ndn-nlsr-conf/nlsr_node_" + itr->first + ".conf";
-    pt::ptree nodeTree;
-    nodeTree.add("node-id", itr->first);
-    nodeTree.add("nlsr-config", filename);
-    simTree.add_child("ndn-node", nodeTree);
-  }
-
-  pt::write_info(sim_config, simTree);
-
-  return true;
-}
-
-bool
-ProcessBulkConfig(std::string confFile)
-{
-  std::string bulk_config = confFile;
-  ifstream topgen;
-  topgen.open (bulk_config.c_str ());
-  typedef map<std::string, pt::ptree> nodeConfigMap;
-  nodeConfigMap nodeMap;
-
-  if ( !topgen.is_open () || !topgen.good () ) {
-    NS_FATAL_ERROR ("Cannot open file " << bulk_config << " for reading");
-    return false;
-  }
-
-  while (!topgen.eof ()) {
-    string line;
-    getline (topgen, line);
-
-    if (line == "ndn-routers")
-      break;
-  }
-
-  if (topgen.eof ()) {
-    NS_FATAL_ERROR ("Bulk config file " << bulk_config << " does not have \"ndn-routers\" section");
-    return false;
-  }
-
-  while (!topgen.eof ()) {
-    string line;
-    getline (topgen,line);
-
-    if (line[0] == ';')
-      continue;
-    if (line == "adjacency-matrix")
-      break;
-
-    istringstream linebuffer(line);
-    std::string nodeId, city, latitude, longitude, network, site, router, lsaRefreshTime, routerDeadInterval, lsaInterestLifetime, logLevel, logDir, seqDir, helloRetries, helloTimeout, helloInterval, adjLsaBuildInterval, firstHelloInterval, state, radius, angle, maxFacesPerPrefix, routingCalcInterval, prefix1, prefix2;
-
-    linebuffer >> nodeId >> city >> latitude >> longitude >> network >> site >> router >> lsaRefreshTime >> routerDeadInterval >> lsaInterestLifetime >> logLevel >> logDir >> seqDir >> helloRetries >> helloTimeout >> helloInterval >> adjLsaBuildInterval >> firstHelloInterval >> state >> radius >> angle >> maxFacesPerPrefix >> routingCalcInterval >> prefix1 >> prefix2;
-
-    if (nodeId.empty ())
-      continue;
-
-    NS_LOG_DEBUG ("Router: " << nodeId << " " << city << " " << latitude << " " << longitude << " " << network << " " << site << " " << router << " " << lsaRefreshTime << " " << routerDeadInterval << " " << lsaInterestLifetime << " " << logLevel << " " << logDir << " " << seqDir << " " << helloRetries << " " << helloTimeout << " " << helloInterval << " " << adjLsaBuildInterval << " " << firstHelloInterval << " " << state << " " << radius << " " << angle << " " << maxFacesPerPrefix << " " << routingCalcInterval << " " << prefix1 << " " << prefix2);
-
-    // Add General config
-    pt::ptree nt;
-    nt.put("general.node-id", nodeId);
-    nt.put("general.city", city);
-    nt.put("general.latitude", latitude);
-    nt.put("general.longitude", longitude);
-    nt.put("general.network", network);
-    nt.put("general.site", site);
-    nt.put("general.router", router);
-    nt.put("general.lsa-refresh-time", lsaRefreshTime);
-    nt.put("general.router-dead-interval", routerDeadInterval);
-    nt.put("general.lsa-interest-lifetime", lsaInterestLifetime);
-    nt.put("general.log-level", logLevel);
-    nt.put("general.log-dir", logDir);
-    nt.put("general.seq-dir", seqDir);
-
-    // Add Neighbors config
-    nt.put("neighbors.hello-retries", helloRetries);
-    nt.put("neighbors.hello-timeout", helloTimeout);
-    nt.put("neighbors.hello-interval", helloInterval);
-    nt.put("neighbors.adj-lsa-build-interval", adjLsaBuildInterval);
-    nt.put("neighbors.first-hello-interval", firstHelloInterval);
-
-    // Add Hyperbolic config
-    nt.put("hyperbolic.state", state);
-    nt.put("hyperbolic.radius", radius);
-    nt.put("hyperbolic.angle", angle);
-
-    // Add Fib config
-    nt.put("fib.max-faces-per-prefix", maxFacesPerPrefix);
-    nt.put("fib.routing-calc-interval", routingCalcInterval);
-
-    // Add Advertising config
-    nt.add("advertising.prefix", prefix1);
-    nt.add("advertising.prefix", prefix2);
-
-    // Add Security config
-    nt.put("security.validator.trust-anchor.type", "any");
-    nt.put("security.prefix-update-validator.trust-anchor.type", "any");
-
-    // Save the tree object for later on.
-    nodeMap[nodeId] = nt;
-
-    if (topgen.eof ()) {
-      NS_LOG_ERROR ("Bulk config file " << bulk_config << " does not have \"adjacency matrix\" section");
-      return false;
-    }
-
-    linebuffer.str("");
-  }
-
-  while (!topgen.eof()) {
-    string line;
-    getline (topgen,line);
-
-    if (line[0] == ';')
-      continue;
-
-    istringstream linebuffer(line);
-    std::string srcNodeId, dstNodeId, name, faceUri, linkCost, bandwidth, metric, delay, queue;
-    linebuffer >> srcNodeId >> dstNodeId >> name >> faceUri >> linkCost >> bandwidth >> metric >> delay >> queue;
-
-    if (srcNodeId.empty ())
-      continue;
-
-    NS_LOG_DEBUG ("Adjacent router: " << srcNodeId << " " << dstNodeId << " " << name << " " << faceUri << " " << linkCost << " " << bandwidth << " " << metric << " " << delay << " " << queue);
-
-    nodeConfigMap::iterator it = nodeMap.find(srcNodeId);
-    if (it != nodeMap.end()) {
-      auto& nbr = (it->second).get_child("neighbors");
-
-      // Add neighbor
-      pt::ptree nb;
-      nb.add("node-id", dstNodeId);
-      nb.add("name", name);
-      nb.add("face-uri", faceUri);
-      nb.add("link-cost", linkCost);
-      nb.add("bandwidth", bandwidth);
-      nb.add("metric", metric);
-      nb.add("delay", delay);
-      nb.add("queue", queue);
-      nbr.add_child("neighbor", nb);
-    }
-    srcNodeId.clear();
-    linebuffer.str("");
-  }
-
-  // Generate the NLSR configuration file
-  for (nodeConfigMap::iterator it = nodeMap.begin(); it != nodeMap.end(); ++it) {
-    std::string filename = "src/ndnSIM/examples/ndn-nlsr-conf/nlsr_node_" + it->first + ".conf";
-    pt::write_info(filename, it->second);
-  }
-
-  // Generate topology config file.
-  //std::string sim_config = "src/ndnSIM/examples/ndn-nlsr-conf/nlsr_sim.conf";
-  std::string sim_config = "src/ndnSIM/examples/ndn-nlsr-conf/nlsr_sim.conf";
-  pt::ptree simTree;
-  for (nodeConfigMap::iterator itr = nodeMap.begin(); itr != nodeMap.end(); ++itr) {
-    std::string filename = "src/ndnSIM/examples/ndn-nlsr-conf/nlsr_node_" + itr->first + ".conf";
-    pt::ptree nodeTree;
-    nodeTree.add("node-id", itr->first);
-    nodeTree.add("nlsr-config", filename);
-    simTree.add_child("ndn-node", nodeTree);
-  }
-
-  pt::write_info(sim_config, simTree);
-
-  return true;
-}
-
 int
 main (int argc, char *argv[])
 {
 
   const char *homeDir = NULL;
   std::string type = "linkstate";
+  bool streaming = false;
+  size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
   int c;
 
   if ((homeDir = getenv("HOME")) == NULL) {
@@ -683,10 +290,16 @@ main (int argc, char *argv[])
   //std::string topo_file = std::string(homeDir) + "/sandbox/creepyCode/networkx/scalefree_topo.dot";
 
   opterr = 0;
-  while ((c = getopt (argc, argv, "at:")) != -1)
+  while ((c = getopt (argc, argv, "at:sj:")) != -1)
     switch (c) {
       case 'a':
         break;
+      case 's':
+        streaming = true;
+        break;
+      case 'j':
+        nThreads = std::max(1, atoi(optarg));
+        break;
       case 't':
         type = std::string(optarg);
 	if (type.compare("ls") == 0 || type.compare("hb") == 0) {
@@ -732,7 +345,13 @@ main (int argc, char *argv[])
   if(!ProcessCommonConfig())
     return -1;
 
-  ProcessBriteTopology(topo_file, type);
+  ndn::NlsrConfGenerator generator("src/ndnSIM/examples/ndn-nlsr-conf", type, homeDir);
+  if (streaming) {
+    generator.ProcessBriteTopologyStreaming(topo_file, nThreads);
+  }
+  else {
+    generator.ProcessBriteTopology(topo_file);
+  }
   return 0;
 }
 
@@ -25,8 +25,10 @@
 #include "ns3/log.h"
 
 #include "utils/tracers/ndn-nlsr-tracer.hpp"
+#include "utils/tracers/ndn-nlsr-convergence-monitor.hpp"
 
 #include "utils/topology/nlsr-conf-reader.hpp"
+#include "apps/ndn-nlsr-snapshot.hpp"
 
 namespace ns3 {
 
@@ -55,7 +57,24 @@ NS_LOG_COMPONENT_DEFINE ("NdnNlsrSimple");
 int
 main (int argc, char *argv[])
 {
+  bool summary = false;
+  bool convergence = false;
+  std::string partitioning = "none";
+  std::string saveSnapshot;
+  std::string warmStart;
+  bool oracle = false;
+  bool linkOracle = false;
+  bool sharedRouting = false;
+
   CommandLine cmd;
+  cmd.AddValue ("summary", "Write per-node NLSR traffic summary every second instead of per-event traces", summary);
+  cmd.AddValue ("convergence", "Report NLSR convergence time and control overhead", convergence);
+  cmd.AddValue ("partitioning", "Assign nodes to MPI ranks automatically: none, edge-cut or geo", partitioning);
+  cmd.AddValue ("save-snapshot", "Save converged NLSR state to this file at the end of the run", saveSnapshot);
+  cmd.AddValue ("warm-start", "Start NLSR from a snapshot saved by --save-snapshot", warmStart);
+  cmd.AddValue ("oracle", "Install NLSR routes centrally instead of running NLSR", oracle);
+  cmd.AddValue ("link-oracle", "Take NLSR neighbor state from link failures instead of hellos", linkOracle);
+  cmd.AddValue ("shared-routing", "Compute routing tables once per LSDB version for all routers", sharedRouting);
   cmd.Parse (argc, argv);
 
   // Creating nodes
@@ -63,16 +82,31 @@ main (int argc, char *argv[])
 
   // Build the NLSR network topology from nlsr.conf
   ndn::NlsrConfReader nlsrConfReader("src/ndnSIM/examples/ndn-nlsr-conf/nlsr_sim.conf", 25);
+  if (partitioning == "edge-cut") {
+    nlsrConfReader.SetAutoPartitioning(0, TopologyPartitioner::MIN_EDGE_CUT);
+  }
+  else if (partitioning == "geo") {
+    nlsrConfReader.SetAutoPartitioning(0, TopologyPartitioner::GEOGRAPHIC);
+  }
   nodes = nlsrConfReader.Read();
 
   ns3::ndn::NlsrTracer &tracer = ndn::NlsrTracer::Instance();
   std::string prefix = std::to_string(nodes.size());
-  tracer.InitializeTracer(prefix);
+  if (summary) {
+    tracer.InitializeSummaryTracer(prefix, Seconds (1.0));
+  }
+  else {
+    tracer.InitializeTracer(prefix);
+  }
 
   // Install NLSR app on all nodes.
-  NS_LOG_INFO ("Installing NLSR application on " << nodes.size() << " nodes");
-  ndn::AppHelper nlsrHelper ("ns3::ndn::NlsrApp");
-  nlsrHelper.Install(nodes);
+  if (!oracle) {
+    NS_LOG_INFO ("Installing NLSR application on " << nodes.size() << " nodes");
+    ndn::AppHelper nlsrHelper ("ns3::ndn::NlsrApp");
+    nlsrHelper.SetAttribute ("LinkOracle", BooleanValue (linkOracle));
+    nlsrHelper.SetAttribute ("SharedRoutingCalculation", BooleanValue (sharedRouting));
+    nlsrHelper.Install(nodes);
+  }
 
   // Install NDN stack on all nodes
   NS_LOG_INFO ("Installing NDN stack on " << nodes.size() << " nodes");
@@ -82,7 +116,23 @@ main (int argc, char *argv[])
   ndn::StrategyChoiceHelper::InstallAll("/", "ndn:/localhost/nfd/strategy/best-route");
 
   // Initialize the NLSR app on nodes.
-  nlsrConfReader.InitializeNlsr();
+  if (oracle) {
+    nlsrConfReader.InstallOracleRoutes();
+  }
+  else {
+    if (!warmStart.empty() && !nlsrConfReader.SetWarmStart(warmStart)) {
+      return 1;
+    }
+    nlsrConfReader.InitializeNlsr();
+  }
+
+  if (convergence) {
+    ndn::NlsrConvergenceMonitor::InstallAll(prefix + "-nlsr-convergence.txt");
+  }
+
+  if (!saveSnapshot.empty()) {
+    ndn::NlsrSnapshot::ScheduleSaveAll(Seconds (149.0), saveSnapshot);
+  }
 
   Simulator::Stop (Seconds (150.0));
 
@@ -91,6 +141,7 @@ main (int argc, char *argv[])
   //ndn::AppDelayTracer::InstallAll((prefix + "-nlsr-app-delays-trace.txt"));
 
   Simulator::Run ();
+  ndn::NlsrConvergenceMonitor::Destroy ();
   Simulator::Destroy ();
 
   return 0;
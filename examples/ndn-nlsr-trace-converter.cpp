@@ -0,0 +1,61 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-nlsr-trace-converter.cpp
+
+#include "ns3/core-module.h"
+
+#include "utils/tracers/ndn-nlsr-tracer.hpp"
+
+namespace ns3 {
+
+/**
+ * Converts the binary trace written by ndn::NlsrTracer into the tab-separated per-event
+ * files (hello, nlsa, llsa, sync, fib) that the R scripts in ndn-nlsr-conf expect:
+ *
+ *     ./waf --run="ndn-nlsr-trace-converter --input=25-nlsr-trace.bin --prefix=25"
+ */
+int
+main(int argc, char* argv[])
+{
+  std::string input;
+  std::string prefix;
+  int rollOver = 4000;
+
+  CommandLine cmd;
+  cmd.AddValue("input", "Binary NLSR trace file", input);
+  cmd.AddValue("prefix", "Prefix of the produced text trace files", prefix);
+  cmd.AddValue("rollover", "Number of lines per text trace file", rollOver);
+  cmd.Parse(argc, argv);
+
+  if (input.empty()) {
+    std::cerr << "--input must be specified" << std::endl;
+    return 1;
+  }
+
+  return ndn::NlsrTracer::ConvertToText(input, prefix, rollOver) ? 0 : 1;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
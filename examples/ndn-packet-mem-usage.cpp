@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-packet-mem-usage.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ns3/ndnSIM/utils/mem-usage.hpp"
+
+namespace ns3 {
+
+/**
+ * This scenario measures memory used by PIT or CS entries that hold packets received
+ * from a point-to-point link:
+ *
+ *      +----------+     1Gbps      +--------+     1Gbps      +-------------------+
+ *      | consumer | <------------> | router | <------------> | producer (or sink) |
+ *      +----------+          1ms   +--------+           1ms  +-------------------+
+ *
+ * The consumer requests --n Data packets during 10 seconds.  With --table=cs, the producer
+ * replies with --payload bytes of payload and the Data are kept in the content stores of
+ * the router and the consumer node.  With --table=pit, nothing replies, and Interests stay
+ * in the PITs of the consumer node and the router for their 100-second lifetime.
+ *
+ * Memory is measured with MemUsage (resident set size) before the first Interest is sent
+ * and after the last one has been processed, and divided by the number of entries in the
+ * measured table on all nodes.  The result includes per-packet state of the consumer
+ * application, so it is meant to be compared between builds, e.g.:
+ *
+ *     ./waf --run="ndn-packet-mem-usage --table=pit"
+ *     ./waf --run="ndn-packet-mem-usage --table=cs"
+ */
+
+double g_memBefore = 0;
+
+void
+MeasureBefore()
+{
+  g_memBefore = MemUsage::Get();
+}
+
+void
+MeasureAfter(NodeContainer nodes, std::string table)
+{
+  double memAfter = MemUsage::Get();
+
+  size_t nEntries = 0;
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+    auto forwarder = (*node)->GetObject<ndn::L3Protocol>()->getForwarder();
+    nEntries += table == "cs" ? forwarder->getCs().size() : forwarder->getPit().size();
+  }
+
+  std::cout << nEntries << " " << table << " entries: " << (memAfter - g_memBefore) / 1024.0
+            << " KiB, " << (memAfter - g_memBefore) / std::max<size_t>(nEntries, 1)
+            << " bytes per entry" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+  uint32_t n = 20000;
+  uint32_t payloadSize = 1024;
+  std::string table = "pit";
+
+  CommandLine cmd;
+  cmd.AddValue("n", "Number of requested packets", n);
+  cmd.AddValue("payload", "Payload size of Data packets", payloadSize);
+  cmd.AddValue("table", "Measured table (pit or cs)", table);
+  cmd.Parse(argc, argv);
+
+  if (table != "pit" && table != "cs") {
+    std::cerr << "--table must be pit or cs" << std::endl;
+    return 1;
+  }
+
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Gbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("1ms"));
+  Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("1000"));
+
+  NodeContainer nodes;
+  nodes.Create(3);
+
+  PointToPointHelper p2p;
+  p2p.Install(nodes.Get(0), nodes.Get(1));
+  p2p.Install(nodes.Get(1), nodes.Get(2));
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.setCsSize(n);
+  ndnHelper.InstallAll();
+
+  ndn::FibHelper::AddRoute(nodes.Get(0), "/prefix", nodes.Get(1), 1);
+  ndn::FibHelper::AddRoute(nodes.Get(1), "/prefix", nodes.Get(2), 1);
+
+  ndn::AppHelper consumerHelper("ns3::ndn::ConsumerCbr");
+  consumerHelper.SetPrefix("/prefix");
+  consumerHelper.SetAttribute("Frequency", DoubleValue(n / 10.0));
+  consumerHelper.SetAttribute("MaxSeq", IntegerValue(n));
+  consumerHelper.SetAttribute("LifeTime", StringValue("100s"));
+  consumerHelper.Install(nodes.Get(0)).Start(Seconds(1.0));
+
+  if (table == "cs") {
+    ndn::AppHelper producerHelper("ns3::ndn::Producer");
+    producerHelper.SetPrefix("/prefix");
+    producerHelper.SetAttribute("PayloadSize", UintegerValue(payloadSize));
+    producerHelper.Install(nodes.Get(2));
+  }
+
+  Simulator::Schedule(Seconds(0.5), &MeasureBefore);
+  Simulator::Schedule(Seconds(12.0), &MeasureAfter, nodes, table);
+
+  Simulator::Stop(Seconds(12.0));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-stack-mem-usage.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ns3/ndnSIM/utils/mem-usage.hpp"
+
+namespace ns3 {
+
+/**
+ * This scenario measures memory used by the NDN stack on every node of a grid topology,
+ * with the full NFD management stack or with the headless data-plane profile
+ * (StackHelper::disableManagement).
+ *
+ * The memory is measured with MemUsage (resident set size) before the stack is installed
+ * and after all management components, including RIB managers scheduled at time 0, have
+ * been created.
+ *
+ * To compare both profiles, run:
+ *
+ *     ./waf --run="ndn-stack-mem-usage --size=30"
+ *     ./waf --run="ndn-stack-mem-usage --size=30 --headless"
+ */
+
+int
+main(int argc, char* argv[])
+{
+  uint32_t size = 30;
+  bool isHeadless = false;
+
+  CommandLine cmd;
+  cmd.AddValue("size", "Grid size (the topology has size*size nodes)", size);
+  cmd.AddValue("headless", "Install the stack without NFD management", isHeadless);
+  cmd.Parse(argc, argv);
+
+  PointToPointHelper p2p;
+  PointToPointGridHelper grid(size, size, p2p);
+
+  double before = MemUsage::Get() / 1024.0;
+
+  ndn::StackHelper ndnHelper;
+  if (isHeadless) {
+    ndnHelper.disableManagement();
+  }
+  ndnHelper.InstallAll();
+
+  Simulator::Stop(Seconds(0.1));
+  Simulator::Run();
+
+  double after = MemUsage::Get() / 1024.0;
+  uint32_t nNodes = size * size;
+
+  std::cout << (isHeadless ? "headless" : "full") << " stack on " << nNodes << " nodes: "
+            << (after - before) / 1024.0 << " MiB, " << (after - before) / nNodes
+            << " KiB per node" << std::endl;
+
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
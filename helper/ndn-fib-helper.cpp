@@ -50,6 +50,18 @@ NS_LOG_COMPONENT_DEFINE("ndn.FibHelper");
 void
 FibHelper::AddNextHop(const ControlParameters& parameters, Ptr<Node> node)
 {
+  Ptr<L3Protocol> l3protocol = node->GetObject<L3Protocol>();
+  if (l3protocol->isManagementDisabled()) {
+    shared_ptr<Face> face = l3protocol->getFaceById(parameters.getFaceId());
+    if (face == nullptr) {
+      NS_LOG_WARN("[" << node->GetId() << "] face " << parameters.getFaceId()
+                  << " does not exist, next hop for " << parameters.getName() << " not added");
+      return;
+    }
+    l3protocol->addRoute(parameters.getName(), face, parameters.getCost());
+    return;
+  }
+
   NS_LOG_DEBUG("Add Next Hop command was initialized");
   Block encodedParameters(parameters.wireEncode());
 
@@ -60,13 +72,24 @@ FibHelper::AddNextHop(const ControlParameters& parameters, Ptr<Node> node)
   shared_ptr<Interest> command(make_shared<Interest>(commandName));
   StackHelper::getKeyChain().sign(*command);
 
-  Ptr<L3Protocol> l3protocol = node->GetObject<L3Protocol>();
   l3protocol->injectInterest(*command);
 }
 
 void
 FibHelper::RemoveNextHop(const ControlParameters& parameters, Ptr<Node> node)
 {
+  Ptr<L3Protocol> l3protocol = node->GetObject<L3Protocol>();
+  if (l3protocol->isManagementDisabled()) {
+    shared_ptr<Face> face = l3protocol->getFaceById(parameters.getFaceId());
+    if (face == nullptr) {
+      NS_LOG_WARN("[" << node->GetId() << "] face " << parameters.getFaceId()
+                  << " does not exist, next hop for " << parameters.getName() << " not removed");
+      return;
+    }
+    l3protocol->removeRoute(parameters.getName(), face);
+    return;
+  }
+
   NS_LOG_DEBUG("Remove Next Hop command was initialized");
   Block encodedParameters(parameters.wireEncode());
 
@@ -77,7 +100,6 @@ FibHelper::RemoveNextHop(const ControlParameters& parameters, Ptr<Node> node)
   shared_ptr<Interest> command(make_shared<Interest>(commandName));
   StackHelper::getKeyChain().sign(*command);
 
-  Ptr<L3Protocol> l3protocol = node->GetObject<L3Protocol>();
   l3protocol->injectInterest(*command);
 }
 
@@ -100,6 +122,40 @@ FibHelper::AddRoute(Ptr<Node> node, const Name& prefix, shared_ptr<Face> face, i
   AddNextHop(parameters, node);
 }
 
+bool
+FibHelper::AddRoutes(Ptr<Node> node, const std::vector<Route>& routes, bool useManagement)
+{
+  Ptr<L3Protocol> ndn = node->GetObject<L3Protocol>();
+  NS_ASSERT_MSG(ndn != 0, "Ndn stack should be installed on the node");
+
+  for (const Route& route : routes) {
+    if (route.face == nullptr || ndn->getFaceById(route.face->getId()) != route.face) {
+      NS_LOG_WARN("[" << node->GetId() << "] route " << route.prefix
+                  << " uses a face that does not belong to the node, no routes installed");
+      return false;
+    }
+    if (route.metric < 0) {
+      NS_LOG_WARN("[" << node->GetId() << "] route " << route.prefix << " has negative metric "
+                  << route.metric << ", no routes installed");
+      return false;
+    }
+  }
+
+  if (useManagement) {
+    for (const Route& route : routes) {
+      AddRoute(node, route.prefix, route.face, route.metric);
+    }
+  }
+  else {
+    for (const Route& route : routes) {
+      ndn->addRoute(route.prefix, route.face, route.metric);
+    }
+  }
+
+  NS_LOG_DEBUG("[" << node->GetId() << "] installed " << routes.size() << " routes");
+  return true;
+}
+
 void
 FibHelper::AddRoute(Ptr<Node> node, const Name& prefix, uint32_t faceId, int32_t metric)
 {
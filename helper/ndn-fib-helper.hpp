@@ -28,6 +28,8 @@
 
 #include <ndn-cxx/management/nfd-control-parameters.hpp>
 
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 
@@ -40,9 +42,39 @@ using ::ndn::nfd::ControlParameters;
  * The FIB helper interacts with the FIB manager of NFD by sending special Interest
  * commands to the manager in order to add/remove a next hop from FIB entries or add
  * routes to the FIB manually (manual configuration of FIB).
+ *
+ * On nodes without management (StackHelper::disableManagement), the helper changes the FIB
+ * directly.
  */
 class FibHelper {
 public:
+  /**
+   * \brief Forwarding entry for AddRoutes
+   */
+  struct Route
+  {
+    Name prefix;
+    shared_ptr<Face> face;
+    int32_t metric;
+  };
+
+  /**
+   * \brief Add a batch of forwarding entries to FIB of the node
+   *
+   * Next hops are written directly into nfd::Fib, without encoding, signing, and validating
+   * one management command per route.  The batch is transactional: all routes are checked
+   * first, and if any of them uses a face that does not belong to the node or a negative
+   * metric, none of them is installed.
+   *
+   * \param node   Node
+   * \param routes Forwarding entries
+   * \param useManagement send add-nexthop commands to the FIB manager instead, as AddRoute
+   *                      does (ignored if management is disabled on the node)
+   * \return false if the batch was rejected
+   */
+  static bool
+  AddRoutes(Ptr<Node> node, const std::vector<Route>& routes, bool useManagement = false);
+
   /**
    * \brief Add forwarding entry to FIB
    *
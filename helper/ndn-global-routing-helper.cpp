@@ -53,6 +53,7 @@
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 
 #include <unordered_map>
+#include <vector>
 
 #include "boost-graph-ndn-global-routing-helper.hpp"
 
@@ -215,7 +216,7 @@ GlobalRoutingHelper::AddOriginsForAll()
 }
 
 void
-GlobalRoutingHelper::CalculateRoutes()
+GlobalRoutingHelper::CalculateRoutes(bool useManagement)
 {
   /**
    * Implementation of route calculation is heavily based on Boost Graph Library
@@ -255,6 +256,8 @@ GlobalRoutingHelper::CalculateRoutes()
     Ptr<L3Protocol> L3protocol = (*node)->GetObject<L3Protocol>();
     shared_ptr<nfd::Forwarder> forwarder = L3protocol->getForwarder();
 
+    std::vector<FibHelper::Route> routes;
+
     NS_LOG_DEBUG("Reachability from Node: " << source->GetObject<Node>()->GetId());
     for (const auto& dist : distances) {
       if (dist.first == source)
@@ -270,17 +273,19 @@ GlobalRoutingHelper::CalculateRoutes()
                          << " with distance " << std::get<1>(dist.second) << " with delay "
                          << std::get<2>(dist.second));
 
-            FibHelper::AddRoute(*node, *prefix, std::get<0>(dist.second),
-                                std::get<1>(dist.second));
+            routes.push_back({*prefix, std::get<0>(dist.second),
+                              static_cast<int32_t>(std::get<1>(dist.second))});
           }
         }
       }
     }
+
+    FibHelper::AddRoutes(*node, routes, useManagement);
   }
 }
 
 void
-GlobalRoutingHelper::CalculateAllPossibleRoutes()
+GlobalRoutingHelper::CalculateAllPossibleRoutes(bool useManagement)
 {
   /**
    * Implementation of route calculation is heavily based on Boost Graph Library
@@ -313,6 +318,8 @@ GlobalRoutingHelper::CalculateAllPossibleRoutes()
     Ptr<L3Protocol> l3 = source->GetObject<L3Protocol>();
     NS_ASSERT(l3 != 0);
 
+    std::vector<FibHelper::Route> routes;
+
     // remember interface statuses
     std::list<nfd::FaceId> faceIds;
     std::unordered_map<nfd::FaceId, uint16_t> originalMetrics;
@@ -368,8 +375,8 @@ GlobalRoutingHelper::CalculateAllPossibleRoutes()
               if (std::get<0>(dist.second)->getMetric() == std::numeric_limits<uint16_t>::max() - 1)
                 continue;
 
-              FibHelper::AddRoute(*node, *prefix, std::get<0>(dist.second),
-                                  std::get<1>(dist.second));
+              routes.push_back({*prefix, std::get<0>(dist.second),
+                                static_cast<int32_t>(std::get<1>(dist.second))});
             }
           }
         }
@@ -383,6 +390,8 @@ GlobalRoutingHelper::CalculateAllPossibleRoutes()
     for (auto& i : originalMetrics) {
       l3->getForwarder()->getFaceTable().get(i.first)->setMetric(i.second);
     }
+
+    FibHelper::AddRoutes(*node, routes, useManagement);
   }
 }
 
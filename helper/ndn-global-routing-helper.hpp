@@ -96,9 +96,13 @@ public:
 
   /**
    * @brief Calculate for every node shortest path trees and install routes to all prefix origins
+   *
+   * Routes of every node are installed as one batch directly into FIB (FibHelper::AddRoutes).
+   *
+   * @param useManagement install routes with signed commands to the FIB manager of each node
    */
   static void
-  CalculateRoutes();
+  CalculateRoutes(bool useManagement = false);
 
   /**
    * @brief Calculate all possible next-hop independent alternative routes
@@ -107,9 +111,11 @@ public:
    *
    * Note that this method is highly experimental and should be used with caution (very time
    *consuming).
+   *
+   * @param useManagement install routes with signed commands to the FIB manager of each node
    */
   static void
-  CalculateAllPossibleRoutes();
+  CalculateAllPossibleRoutes(bool useManagement = false);
 
 private:
   void
@@ -55,14 +55,13 @@ LinkControlHelper::setErrorRate(Ptr<Node> node1, Ptr<Node> node2, double errorRa
 
   NS_ASSERT(ndn1 != nullptr && ndn2 != nullptr);
 
-  // iterate over all faces to find the right one
-  for (const auto& face : ndn1->getForwarder()->getFaceTable()) {
-    auto linkService = dynamic_cast<NetDeviceLinkService*>(face->getLinkService());
-    if (linkService == nullptr)
+  // iterate over devices of node1 to find the link, which must have an NDN face
+  for (uint32_t deviceId = 0; deviceId < node1->GetNDevices(); ++deviceId) {
+    Ptr<PointToPointNetDevice> nd1 = DynamicCast<PointToPointNetDevice>(node1->GetDevice(deviceId));
+    if (nd1 == nullptr)
       continue;
 
-    Ptr<PointToPointNetDevice> nd1 = linkService->GetNetDevice()->GetObject<PointToPointNetDevice>();
-    if (nd1 == nullptr)
+    if (ndn1->getFaceByNetDevice(nd1) == nullptr)
       continue;
 
     Ptr<Channel> channel = nd1->GetChannel();
@@ -85,12 +84,44 @@ LinkControlHelper::setErrorRate(Ptr<Node> node1, Ptr<Node> node2, double errorRa
 
       nd1->SetAttribute("ReceiveErrorModel", PointerValue(errorFactory.Create<ErrorModel>()));
       nd2->SetAttribute("ReceiveErrorModel", PointerValue(errorFactory.Create<ErrorModel>()));
+
+      bool isUp = errorRate < 1.0;
+      for (const auto& listener : getLinkStateListeners()) {
+        listener.second(node1, node2, isUp);
+      }
       return;
     }
   }
   NS_FATAL_ERROR("There is no link to fail between the requested nodes");
 }
 
+std::map<LinkControlHelper::LinkStateListenerId, LinkControlHelper::LinkStateListener>&
+LinkControlHelper::getLinkStateListeners()
+{
+  static std::map<LinkStateListenerId, LinkStateListener> listeners;
+  return listeners;
+}
+
+LinkControlHelper::LinkStateListenerId
+LinkControlHelper::AddLinkStateListener(const LinkStateListener& listener)
+{
+  static LinkStateListenerId lastId = 0;
+  getLinkStateListeners()[++lastId] = listener;
+  return lastId;
+}
+
+void
+LinkControlHelper::RemoveLinkStateListener(LinkStateListenerId id)
+{
+  getLinkStateListeners().erase(id);
+}
+
+void
+LinkControlHelper::RemoveLinkStateListeners()
+{
+  getLinkStateListeners().clear();
+}
+
 void
 LinkControlHelper::FailLink(Ptr<Node> node1, Ptr<Node> node2)
 {
@@ -25,6 +25,9 @@
 #include "ns3/ptr.h"
 #include "ns3/node.h"
 
+#include <functional>
+#include <map>
+
 namespace ns3 {
 namespace ndn {
 
@@ -95,7 +98,45 @@ public:
   static void
   UpLinkByName(const std::string& node1, const std::string& node2);
 
+  /**
+   * @brief Callback invoked after FailLink or UpLink changed the state of a link
+   *
+   * The arguments are the two nodes of the link and true if the link is now up.
+   */
+  typedef std::function<void(Ptr<Node>, Ptr<Node>, bool)> LinkStateListener;
+
+  /**
+   * @brief Identifies a registered link state listener
+   */
+  typedef uint64_t LinkStateListenerId;
+
+  /**
+   * @brief Register a listener for link state changes
+   *
+   * Listeners allow protocol models to learn about link failures directly, e.g., to
+   * replace periodic keep-alive (hello) traffic with an oracle.
+   *
+   * @return id to remove the listener with RemoveLinkStateListener
+   */
+  static LinkStateListenerId
+  AddLinkStateListener(const LinkStateListener& listener);
+
+  /**
+   * @brief Remove a registered link state listener, does nothing if \p id is not registered
+   */
+  static void
+  RemoveLinkStateListener(LinkStateListenerId id);
+
+  /**
+   * @brief Remove all registered link state listeners
+   */
+  static void
+  RemoveLinkStateListeners();
+
 private:
+  static std::map<LinkStateListenerId, LinkStateListener>&
+  getLinkStateListeners();
+
   static void
   setErrorRate(Ptr<Node> node1, Ptr<Node> node2, double errorRate);
 }; // LinkControlHelper
@@ -190,6 +190,13 @@ public: // topology accessors
   void
   disableForwarderStatusManager();
 
+  /**
+   * \brief Disable all of NFD management (headless data-plane profile)
+   * \see StackHelper::disableManagement
+   */
+  void
+  disableManagement();
+
   /**
    * \brief Get NDN stack helper, e.g., to adjust its parameters
    */
@@ -46,6 +46,8 @@ StackHelper::StackHelper()
   // , m_isFaceManagerDisabled(false)
   , m_isForwarderStatusManagerDisabled(false)
   , m_isStrategyChoiceManagerDisabled(false)
+  , m_isManagementDisabled(false)
+  , m_isSharedPacketEnabled(false)
   , m_needSetDefaultRoutes(false)
   , m_maxCsSize(100)
 {
@@ -156,23 +158,27 @@ StackHelper::Install(Ptr<Node> node) const
 
   Ptr<L3Protocol> ndn = m_ndnFactory.Create<L3Protocol>();
 
+  if (m_isManagementDisabled) {
+    ndn->setConfigValue("ndnSIM.disable_management", "true");
+  }
+
   if (m_isRibManagerDisabled) {
-    ndn->getConfig().put("ndnSIM.disable_rib_manager", true);
+    ndn->setConfigValue("ndnSIM.disable_rib_manager", "true");
   }
 
   // if (m_isFaceManagerDisabled) {
-  //   ndn->getConfig().put("ndnSIM.disable_face_manager", true);
+  //   ndn->setConfigValue("ndnSIM.disable_face_manager", "true");
   // }
 
   if (m_isForwarderStatusManagerDisabled) {
-    ndn->getConfig().put("ndnSIM.disable_forwarder_status_manager", true);
+    ndn->setConfigValue("ndnSIM.disable_forwarder_status_manager", "true");
   }
 
   if (m_isStrategyChoiceManagerDisabled) {
-    ndn->getConfig().put("ndnSIM.disable_strategy_choice_manager", true);
+    ndn->setConfigValue("ndnSIM.disable_strategy_choice_manager", "true");
   }
 
-  ndn->getConfig().put("tables.cs_max_packets", (m_maxCsSize == 0) ? 1 : m_maxCsSize);
+  ndn->setConfigValue("tables.cs_max_packets", std::to_string((m_maxCsSize == 0) ? 1 : m_maxCsSize));
 
   // Create and aggregate content store if NFD's contest store has been disabled
   if (m_maxCsSize == 0) {
@@ -272,6 +278,10 @@ StackHelper::PointToPointNetDeviceCallback(Ptr<Node> node, Ptr<L3Protocol> ndn,
     remoteNetDevice = channel->GetDevice(1);
 
   auto netDeviceLink = make_unique<NetDeviceLinkService>(node, netDevice);
+  // objects cannot be shared with a node in another MPI process
+  if (m_isSharedPacketEnabled && channel->GetInstanceTypeId() == PointToPointChannel::GetTypeId()) {
+    netDeviceLink->setSharedPacketEnabled(true);
+  }
 
   auto transport = make_unique<NullTransport>(constructFaceUri(netDevice), constructFaceUri(remoteNetDevice));
   auto face = std::make_shared<Face>(std::move(netDeviceLink), std::move(transport));
@@ -381,5 +391,17 @@ StackHelper::disableForwarderStatusManager()
   m_isForwarderStatusManagerDisabled = true;
 }
 
+void
+StackHelper::disableManagement()
+{
+  m_isManagementDisabled = true;
+}
+
+void
+StackHelper::enableSharedPackets()
+{
+  m_isSharedPacketEnabled = true;
+}
+
 } // namespace ndn
 } // namespace ns3
@@ -236,6 +236,31 @@ public:
   void
   disableForwarderStatusManager();
 
+  /**
+   * \brief Disable all of NFD management (headless data-plane profile)
+   *
+   * Only the forwarder, the face table, and the tables are installed.  Internal faces, the
+   * dispatcher, the command validator, all managers, and the RIB manager are not created,
+   * which saves memory on every node (see examples/ndn-stack-mem-usage.cpp).
+   *
+   * FibHelper and StrategyChoiceHelper keep working on such nodes; other code should use
+   * the direct API of L3Protocol (addRoute(), removeRoute(), setStrategy(), addFace(),
+   * removeFace()).  Applications that talk to NFD management, e.g., NLSR, cannot be used.
+   */
+  void
+  disableManagement();
+
+  /**
+   * \brief Enable the shared-packet mode on point-to-point faces
+   *
+   * Interests and Data sent over point-to-point links are not encoded and decoded on every
+   * hop: the receiving node uses the object created by the sender (see
+   * NetDeviceLinkService::setSharedPacketEnabled).  Link delays and queueing do not change.
+   * Links over PointToPointRemoteChannel (MPI) always carry encoded packets.
+   */
+  void
+  enableSharedPackets();
+
 private:
   shared_ptr<Face>
   DefaultNetDeviceCallback(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetDevice> netDevice) const;
@@ -250,6 +275,8 @@ private:
   // bool m_isFaceManagerDisabled;
   bool m_isForwarderStatusManagerDisabled;
   bool m_isStrategyChoiceManagerDisabled;
+  bool m_isManagementDisabled;
+  bool m_isSharedPacketEnabled;
 
 public:
   void
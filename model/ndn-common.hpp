@@ -37,6 +37,8 @@
 
 #include "NFD/daemon/face/face.hpp"
 
+#include "ns3/ndnSIM/utils/ndn-binary-log.hpp"
+
 namespace nfd {
 }
 
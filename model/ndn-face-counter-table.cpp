@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-face-counter-table.hpp"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+FaceCounterTable::FaceCounterTable()
+  : m_size(0)
+{
+  m_nodeTotals.fill(0);
+}
+
+void
+FaceCounterTable::resize(size_t size)
+{
+  // faces ids are allocated sequentially, leave room for a few more faces
+  size_t capacity = std::max<size_t>(size, m_size + m_size / 2 + 1);
+  for (int counter = 0; counter < N_COUNTERS; ++counter) {
+    m_packets[counter].resize(capacity, 0);
+    m_bytes[counter].resize(capacity, 0);
+  }
+  m_size = capacity;
+}
+
+void
+FaceCounterTable::setPackets(Counter counter, nfd::FaceId faceId, uint64_t nPackets)
+{
+  if (faceId <= nfd::face::FACEID_RESERVED_MAX) {
+    return;
+  }
+
+  size_t index = faceId - nfd::face::FACEID_RESERVED_MAX - 1;
+  if (index >= m_size) {
+    resize(index + 1);
+  }
+  m_packets[counter][index] = nPackets;
+}
+
+uint64_t
+FaceCounterTable::getPackets(Counter counter, nfd::FaceId faceId) const
+{
+  if (faceId < getBeginFaceId() || faceId >= getEndFaceId()) {
+    return 0;
+  }
+  return m_packets[counter][faceId - getBeginFaceId()];
+}
+
+uint64_t
+FaceCounterTable::getBytes(Counter counter, nfd::FaceId faceId) const
+{
+  if (faceId < getBeginFaceId() || faceId >= getEndFaceId()) {
+    return 0;
+  }
+  return m_bytes[counter][faceId - getBeginFaceId()];
+}
+
+FaceCounterTable
+FaceCounterTable::diff(const FaceCounterTable& earlier) const
+{
+  NS_ASSERT_MSG(earlier.m_size <= m_size, "Snapshot does not belong to this table");
+  FaceCounterTable result(*this);
+
+  for (int counter = 0; counter < N_COUNTERS; ++counter) {
+    for (size_t index = 0; index < earlier.m_size; ++index) {
+      result.m_packets[counter][index] -= earlier.m_packets[counter][index];
+      result.m_bytes[counter][index] -= earlier.m_bytes[counter][index];
+    }
+    result.m_nodeTotals[counter] -= earlier.m_nodeTotals[counter];
+  }
+  return result;
+}
+
+const char*
+FaceCounterTable::getCounterName(Counter counter)
+{
+  static const char* names[N_COUNTERS] = {
+    "InInterests",
+    "OutInterests",
+    "InData",
+    "OutData",
+    "InNacks",
+    "OutNacks",
+    "InSatisfiedInterests",
+    "InTimedOutInterests",
+    "OutSatisfiedInterests",
+    "OutTimedOutInterests"
+  };
+  return names[counter];
+}
+
+} // namespace ndn
+} // namespace ns3
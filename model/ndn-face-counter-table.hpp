@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_FACE_COUNTER_TABLE_HPP
+#define NDN_FACE_COUNTER_TABLE_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <array>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Per-face packet and byte counters of an NDN stack
+ *
+ * Counters are stored as a struct of arrays: one contiguous array per counter, indexed by
+ * face id (reserved faces are not counted).  Incrementing a counter is an array update, and
+ * the whole table can be copied cheaply, so readers take periodic snapshots and diff them
+ * instead of observing every packet.
+ *
+ * \see L3Protocol::enableFaceCounters, L3RateTracer
+ */
+class FaceCounterTable {
+public:
+  enum Counter {
+    IN_INTERESTS,
+    OUT_INTERESTS,
+    IN_DATA,
+    OUT_DATA,
+    IN_NACKS,
+    OUT_NACKS,
+    IN_SATISFIED_INTERESTS,  ///< \brief satisfied PIT entries with an in-record of the face
+    IN_TIMED_OUT_INTERESTS,  ///< \brief expired PIT entries with an in-record of the face
+    OUT_SATISFIED_INTERESTS, ///< \brief satisfied PIT entries with an out-record of the face
+    OUT_TIMED_OUT_INTERESTS, ///< \brief expired PIT entries with an out-record of the face
+    N_COUNTERS
+  };
+
+  FaceCounterTable();
+
+  /**
+   * \brief Count a packet of \p nBytes on the face
+   */
+  void
+  increment(Counter counter, nfd::FaceId faceId, uint64_t nBytes = 0)
+  {
+    if (faceId <= nfd::face::FACEID_RESERVED_MAX) {
+      return;
+    }
+
+    size_t index = faceId - nfd::face::FACEID_RESERVED_MAX - 1;
+    if (index >= m_size) {
+      resize(index + 1);
+    }
+    ++m_packets[counter][index];
+    m_bytes[counter][index] += nBytes;
+  }
+
+  /**
+   * \brief Set packet count of the face, e.g., from counters maintained by NFD
+   */
+  void
+  setPackets(Counter counter, nfd::FaceId faceId, uint64_t nPackets);
+
+  /**
+   * \brief Count an event of the whole node, e.g., a satisfied Interest
+   */
+  void
+  incrementNodeTotal(Counter counter)
+  {
+    ++m_nodeTotals[counter];
+  }
+
+  uint64_t
+  getPackets(Counter counter, nfd::FaceId faceId) const;
+
+  uint64_t
+  getBytes(Counter counter, nfd::FaceId faceId) const;
+
+  uint64_t
+  getNodeTotal(Counter counter) const
+  {
+    return m_nodeTotals[counter];
+  }
+
+  /**
+   * \brief Get ids of faces that may have non-zero counters, i.e., [begin, end)
+   */
+  nfd::FaceId
+  getBeginFaceId() const
+  {
+    return nfd::face::FACEID_RESERVED_MAX + 1;
+  }
+
+  nfd::FaceId
+  getEndFaceId() const
+  {
+    return getBeginFaceId() + m_size;
+  }
+
+  /**
+   * \brief Get counters accumulated since \p earlier, a snapshot of the same table
+   */
+  FaceCounterTable
+  diff(const FaceCounterTable& earlier) const;
+
+  /**
+   * \brief Get name of the counter, as used by tracers (e.g., "InInterests")
+   */
+  static const char*
+  getCounterName(Counter counter);
+
+private:
+  void
+  resize(size_t size);
+
+private:
+  size_t m_size;
+  std::array<std::vector<uint64_t>, N_COUNTERS> m_packets;
+  std::array<std::vector<uint64_t>, N_COUNTERS> m_bytes;
+  std::array<uint64_t, N_COUNTERS> m_nodeTotals;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_FACE_COUNTER_TABLE_HPP
@@ -19,12 +19,6 @@
 
 #include "ndn-header.hpp"
 
-#include <iosfwd>
-#include <boost/iostreams/concepts.hpp>
-#include <boost/iostreams/stream.hpp>
-
-namespace io = boost::iostreams;
-
 namespace ns3 {
 namespace ndn {
 
@@ -70,6 +64,7 @@ PacketHeader<Pkt>::PacketHeader()
 template<class Pkt>
 PacketHeader<Pkt>::PacketHeader(const Pkt& packet)
   : m_packet(packet.shared_from_this())
+  , m_block(packet.wireEncode())
 {
 }
 
@@ -77,51 +72,71 @@ template<class Pkt>
 uint32_t
 PacketHeader<Pkt>::GetSerializedSize(void) const
 {
-  return m_packet->wireEncode().size();
+  return m_block.size();
 }
 
 template<class Pkt>
 void
 PacketHeader<Pkt>::Serialize(ns3::Buffer::Iterator start) const
 {
-  start.Write(m_packet->wireEncode().wire(), m_packet->wireEncode().size());
+  start.Write(m_block.wire(), m_block.size());
 }
 
-class Ns3BufferIteratorSource : public io::source {
-public:
-  Ns3BufferIteratorSource(ns3::Buffer::Iterator& is)
-    : m_is(is)
-  {
+namespace {
+
+/**
+ * \brief Read TLV-TYPE or TLV-LENGTH number from ns-3 buffer
+ * \throw tlv::Error the buffer does not contain the whole number
+ */
+uint64_t
+readVarNumber(ns3::Buffer::Iterator& i)
+{
+  if (i.GetRemainingSize() < 1) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Insufficient data during TLV processing"));
   }
 
-  std::streamsize
-  read(char* buf, std::streamsize nMaxRead)
-  {
-    std::streamsize i = 0;
-    for (; i < nMaxRead && !m_is.IsEnd(); ++i) {
-      buf[i] = m_is.ReadU8();
-    }
-    if (i == 0) {
-      return -1;
-    }
-    else {
-      return i;
-    }
+  uint8_t firstOctet = i.ReadU8();
+  uint32_t size = firstOctet < 253 ? 0 : (1 << (firstOctet - 252));
+  if (i.GetRemainingSize() < size) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Insufficient data during TLV processing"));
   }
 
-private:
-  ns3::Buffer::Iterator& m_is;
-};
+  switch (size) {
+  case 0:
+    return firstOctet;
+  case 2:
+    return i.ReadNtohU16();
+  case 4:
+    return i.ReadNtohU32();
+  default:
+    return i.ReadNtohU64();
+  }
+}
+
+} // namespace
 
 template<class Pkt>
 uint32_t
 PacketHeader<Pkt>::Deserialize(ns3::Buffer::Iterator start)
 {
+  // Peek TLV-TYPE and TLV-LENGTH to copy the whole element at once, instead of reading
+  // it one octet at a time through a stream
+  ns3::Buffer::Iterator i = start;
+  readVarNumber(i);
+  uint64_t length = readVarNumber(i);
+  if (length > i.GetRemainingSize()) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Not enough data in the buffer to fully parse TLV"));
+  }
+  uint32_t size = i.GetDistanceFrom(start) + static_cast<uint32_t>(length);
+
+  auto buffer = make_shared< ::ndn::Buffer>(size);
+  start.Read(buffer->buf(), size);
+
+  m_block = ::ndn::Block(buffer);
   auto packet = make_shared<Pkt>();
-  io::stream<Ns3BufferIteratorSource> is(start);
-  packet->wireDecode(::ndn::Block::fromStream(is));
+  packet->wireDecode(m_block);
   m_packet = packet;
-  return packet->wireEncode().size();
+  return size;
 }
 
 template<>
@@ -38,6 +38,12 @@ public:
 
   PacketHeader();
 
+  /**
+   * \brief Create header for the packet
+   *
+   * The packet is encoded once, and the encoded wire is reused by GetSerializedSize and
+   * Serialize.
+   */
   PacketHeader(const Pkt& packet);
 
   virtual uint32_t
@@ -57,6 +63,7 @@ public:
 
 private:
   shared_ptr<const Pkt> m_packet;
+  ::ndn::Block m_block;
 };
 
 } // namespace ndn
@@ -30,13 +30,18 @@
 #include "ns3/simulator.h"
 
 #include "ndn-net-device-link-service.hpp"
+#include "ndn-face-counter-table.hpp"
 
 #include "../helper/ndn-stack-helper.hpp"
 #include "cs/ndn-content-store.hpp"
 
 #include <boost/property_tree/info_parser.hpp>
 
+#include <map>
+#include <unordered_map>
+
 #include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/pit-entry.hpp"
 #include "ns3/ndnSIM/NFD/daemon/face/internal-face.hpp"
 #include "ns3/ndnSIM/NFD/daemon/face/internal-transport.hpp"
 #include "ns3/ndnSIM/NFD/daemon/mgmt/fib-manager.hpp"
@@ -55,6 +60,7 @@
 #include "ns3/ndnSIM/NFD/core/config-file.hpp"
 
 #include <ndn-cxx/mgmt/dispatcher.hpp>
+#include <ndn-cxx/util/signal.hpp>
 
 NS_LOG_COMPONENT_DEFINE("ndn.L3Protocol");
 
@@ -104,6 +110,21 @@ L3Protocol::GetTypeId(void)
 class L3Protocol::Impl {
 private:
   Impl()
+  {
+  }
+
+  /**
+   * \brief Default NFD config, parsed once and shared by all nodes
+   */
+  static const nfd::ConfigSection&
+  getDefaultConfig()
+  {
+    static const nfd::ConfigSection defaultConfig = parseDefaultConfig();
+    return defaultConfig;
+  }
+
+  static nfd::ConfigSection
+  parseDefaultConfig()
   {
     // Do not modify initial config file. Use helpers to set specific NFD parameters
     std::string initialConfig =
@@ -154,12 +175,52 @@ private:
       "}\n"
       "\n";
 
+    nfd::ConfigSection config;
     std::istringstream input(initialConfig);
-    boost::property_tree::read_info(input, m_config);
+    boost::property_tree::read_info(input, config);
+    return config;
+  }
+
+  /**
+   * \brief Complete NFD config of the node: the default config with the node's overrides
+   */
+  nfd::ConfigSection
+  makeConfig() const
+  {
+    if (m_config != nullptr) {
+      return *m_config;
+    }
+
+    nfd::ConfigSection config = getDefaultConfig();
+    for (const auto& value : m_overrides) {
+      config.put(value.first, value.second);
+    }
+    return config;
+  }
+
+  bool
+  isConfigFlagSet(const std::string& key) const
+  {
+    std::string value;
+    if (m_config != nullptr) {
+      value = m_config->get<std::string>(key, "");
+    }
+    else {
+      auto it = m_overrides.find(key);
+      value = it != m_overrides.end() ? it->second : getDefaultConfig().get<std::string>(key, "");
+    }
+    return value == "true" || value == "1";
   }
 
   friend class L3Protocol;
 
+  /**
+   * \brief Index of faces created on NetDevices, updated on face addition and removal
+   *
+   * Declared before the forwarder, so it outlives the face table that updates it.
+   */
+  std::unordered_map<const NetDevice*, shared_ptr<Face>> m_netDeviceFaces;
+
   std::shared_ptr<nfd::Forwarder> m_forwarder;
 
   std::shared_ptr<nfd::Face> m_internalFace;
@@ -176,7 +237,35 @@ private:
   std::shared_ptr<nfd::ForwarderStatusManager> m_forwarderStatusManager;
   std::shared_ptr<nfd::rib::RibManager> m_ribManager;
 
-  nfd::ConfigSection m_config;
+  /**
+   * \brief Signal connections of a face added with addFace(), made only while traced
+   */
+  struct FaceTraces
+  {
+    std::weak_ptr<Face> face;
+    ::ndn::util::signal::ScopedConnection inInterests;
+    ::ndn::util::signal::ScopedConnection outInterests;
+    ::ndn::util::signal::ScopedConnection inData;
+    ::ndn::util::signal::ScopedConnection outData;
+
+    bool isCounted = false; ///< \brief whether connections below are made
+    ::ndn::util::signal::ScopedConnection countInInterests;
+    ::ndn::util::signal::ScopedConnection countOutInterests;
+    ::ndn::util::signal::ScopedConnection countInData;
+    ::ndn::util::signal::ScopedConnection countOutData;
+  };
+
+  std::unordered_map<nfd::FaceId, FaceTraces> m_faceTraces;
+  ::ndn::util::signal::ScopedConnection m_satisfiedInterestsConnection;
+  ::ndn::util::signal::ScopedConnection m_timedOutInterestsConnection;
+
+  std::unique_ptr<FaceCounterTable> m_faceCounters;
+  bool m_isForwarderCounted = false;
+  ::ndn::util::signal::ScopedConnection m_countSatisfiedInterests;
+  ::ndn::util::signal::ScopedConnection m_countTimedOutInterests;
+
+  std::map<std::string, std::string> m_overrides;
+  std::unique_ptr<nfd::ConfigSection> m_config; ///< \brief private config, see getConfig()
 
   Ptr<ContentStore> m_csFromNdnSim;
 };
@@ -185,6 +274,15 @@ L3Protocol::L3Protocol()
   : m_impl(new Impl())
 {
   NS_LOG_FUNCTION(this);
+
+  // face and forwarder signals are connected only while trace sources have sinks
+  auto updateTraces = std::bind(&L3Protocol::updateTraces, this);
+  m_inInterests.SetSinksChangedCallback(updateTraces);
+  m_outInterests.SetSinksChangedCallback(updateTraces);
+  m_inData.SetSinksChangedCallback(updateTraces);
+  m_outData.SetSinksChangedCallback(updateTraces);
+  m_satisfiedInterests.SetSinksChangedCallback(updateTraces);
+  m_timedOutInterests.SetSinksChangedCallback(updateTraces);
 }
 
 L3Protocol::~L3Protocol()
@@ -197,18 +295,40 @@ L3Protocol::initialize()
 {
   m_impl->m_forwarder = make_shared<nfd::Forwarder>();
 
-  initializeManagement();
+  // the effective config is built once and released after the RIB manager applies it
+  shared_ptr<nfd::ConfigSection> config;
+  if (!isManagementDisabled()) {
+    config = make_shared<nfd::ConfigSection>(m_impl->makeConfig());
+    initializeManagement(*config);
+  }
+  else {
+    initializeTables();
+  }
 
   nfd::FaceTable& faceTable = m_impl->m_forwarder->getFaceTable();
+  Impl* impl = m_impl.get();
+  faceTable.beforeRemove.connect([impl] (shared_ptr<Face> face) {
+      impl->m_faceTraces.erase(face->getId());
+
+      auto linkService = dynamic_cast<NetDeviceLinkService*>(face->getLinkService());
+      if (linkService == nullptr)
+        return;
+
+      auto it = impl->m_netDeviceFaces.find(PeekPointer(linkService->GetNetDevice()));
+      if (it != impl->m_netDeviceFaces.end() && it->second == face) {
+        impl->m_netDeviceFaces.erase(it);
+      }
+    });
+
   faceTable.addReserved(nfd::face::makeNullFace(), nfd::face::FACEID_NULL);
   faceTable.addReserved(nfd::face::makeNullFace(FaceUri("contentstore://")), nfd::face::FACEID_CONTENT_STORE);
 
-  if (!this->getConfig().get<bool>("ndnSIM.disable_rib_manager", false)) {
-    Simulator::ScheduleWithContext(m_node->GetId(), Seconds(0), &L3Protocol::initializeRibManager, this);
+  if (!isManagementDisabled() && !m_impl->isConfigFlagSet("ndnSIM.disable_rib_manager")) {
+    Simulator::ScheduleWithContext(m_node->GetId(), Seconds(0), &L3Protocol::initializeRibManager,
+                                   this, config);
   }
 
-  m_impl->m_forwarder->beforeSatisfyInterest.connect(std::ref(m_satisfiedInterests));
-  m_impl->m_forwarder->beforeExpirePendingInterest.connect(std::ref(m_timedOutInterests));
+  updateTraces();
 }
 
 class IgnoreSections
@@ -235,11 +355,63 @@ private:
 void
 L3Protocol::injectInterest(const Interest& interest)
 {
+  NS_ASSERT_MSG(m_impl->m_internalFace != nullptr,
+                "Management is disabled on node " << m_node->GetId() << ", use direct API instead");
   m_impl->m_internalFace->sendInterest(interest);
 }
 
+bool
+L3Protocol::isManagementDisabled() const
+{
+  return m_impl->isConfigFlagSet("ndnSIM.disable_management");
+}
+
+void
+L3Protocol::addRoute(const Name& prefix, shared_ptr<Face> face, uint64_t cost)
+{
+  NS_LOG_LOGIC("[" << m_node->GetId() << "]$ route add " << prefix << " via " << face->getId()
+                   << " cost " << cost);
+
+  auto entry = m_impl->m_forwarder->getFib().insert(prefix).first;
+  entry->addNextHop(face, cost);
+}
+
+void
+L3Protocol::removeRoute(const Name& prefix, shared_ptr<Face> face)
+{
+  NS_LOG_LOGIC("[" << m_node->GetId() << "]$ route del " << prefix << " via " << face->getId());
+
+  nfd::Fib& fib = m_impl->m_forwarder->getFib();
+  auto entry = fib.findExactMatch(prefix);
+  if (entry == nullptr) {
+    return;
+  }
+
+  entry->removeNextHop(face);
+  if (!entry->hasNextHops()) {
+    fib.erase(*entry);
+  }
+}
+
+bool
+L3Protocol::setStrategy(const Name& prefix, const Name& strategy)
+{
+  NS_LOG_LOGIC("[" << m_node->GetId() << "]$ strategy set " << prefix << " " << strategy);
+
+  return m_impl->m_forwarder->getStrategyChoice().insert(prefix, strategy);
+}
+
 void
-L3Protocol::initializeManagement()
+L3Protocol::removeFace(shared_ptr<Face> face)
+{
+  NS_LOG_LOGIC("[" << m_node->GetId() << "]$ face destroy " << face->getId());
+
+  // the face table removes the face and its FIB next hops once the face is closed
+  face->close();
+}
+
+void
+L3Protocol::initializeManagement(nfd::ConfigSection& nfdConfig)
 {
   auto& forwarder = m_impl->m_forwarder;
   using namespace nfd;
@@ -265,16 +437,16 @@ L3Protocol::initializeManagement()
   //   this->getConfig().get_child("authorizations").get_child("authorize").get_child("privileges").erase("faces");
   // }
 
-  if (!this->getConfig().get<bool>("ndnSIM.disable_strategy_choice_manager", false)) {
+  if (!m_impl->isConfigFlagSet("ndnSIM.disable_strategy_choice_manager")) {
     m_impl->m_strategyChoiceManager.reset(new StrategyChoiceManager(forwarder->getStrategyChoice(),
                                                                     *m_impl->m_dispatcher,
                                                                     *m_impl->m_validator));
   }
   else {
-    this->getConfig().get_child("authorizations").get_child("authorize").get_child("privileges").erase("strategy-choice");
+    nfdConfig.get_child("authorizations").get_child("authorize").get_child("privileges").erase("strategy-choice");
   }
 
-  if (!this->getConfig().get<bool>("ndnSIM.disable_forwarder_status_manager", false)) {
+  if (!m_impl->isConfigFlagSet("ndnSIM.disable_forwarder_status_manager")) {
     m_impl->m_forwarderStatusManager.reset(new ForwarderStatusManager(*forwarder, *m_impl->m_dispatcher));
   }
 
@@ -295,7 +467,7 @@ L3Protocol::initializeManagement()
   // }
 
   // apply config
-  config.parse(m_impl->m_config, false, "ndnSIM.conf");
+  config.parse(nfdConfig, false, "ndnSIM.conf");
 
   tablesConfig.ensureTablesAreConfigured();
 
@@ -307,7 +479,29 @@ L3Protocol::initializeManagement()
 }
 
 void
-L3Protocol::initializeRibManager()
+L3Protocol::initializeTables()
+{
+  auto& forwarder = m_impl->m_forwarder;
+  using namespace nfd;
+
+  ConfigFile config(&ConfigFile::ignoreUnknownSection);
+
+  TablesConfigSection tablesConfig(forwarder->getCs(),
+                                   forwarder->getPit(),
+                                   forwarder->getFib(),
+                                   forwarder->getStrategyChoice(),
+                                   forwarder->getMeasurements(),
+                                   forwarder->getNetworkRegionTable());
+  tablesConfig.setConfigFile(config);
+
+  // apply config
+  config.parse(m_impl->makeConfig(), false, "ndnSIM.conf");
+
+  tablesConfig.ensureTablesAreConfigured();
+}
+
+void
+L3Protocol::initializeRibManager(shared_ptr<const nfd::ConfigSection> nfdConfig)
 {
   using namespace nfd;
 
@@ -331,8 +525,8 @@ L3Protocol::initializeRibManager()
 
   m_impl->m_ribManager->setConfigFile(config);
 
-  // apply config
-  config.parse(m_impl->m_config, false, "ndnSIM.conf");
+  // apply config; a private config made by getConfig() after initialization takes precedence
+  config.parse(m_impl->m_config != nullptr ? *m_impl->m_config : *nfdConfig, false, "ndnSIM.conf");
 
   m_impl->m_ribManager->registerWithNfd();
 
@@ -360,7 +554,36 @@ L3Protocol::getStrategyChoiceManager()
 nfd::ConfigSection&
 L3Protocol::getConfig()
 {
-  return m_impl->m_config;
+  if (m_impl->m_config == nullptr) {
+    m_impl->m_config.reset(new nfd::ConfigSection(m_impl->makeConfig()));
+    m_impl->m_overrides.clear();
+  }
+  return *m_impl->m_config;
+}
+
+void
+L3Protocol::setConfigValue(const std::string& key, const std::string& value)
+{
+  if (m_impl->m_config != nullptr) {
+    m_impl->m_config->put(key, value);
+  }
+  else {
+    m_impl->m_overrides[key] = value;
+  }
+}
+
+std::string
+L3Protocol::getConfigValue(const std::string& key, const std::string& defaultValue) const
+{
+  if (m_impl->m_config != nullptr) {
+    return m_impl->m_config->get<std::string>(key, defaultValue);
+  }
+
+  auto it = m_impl->m_overrides.find(key);
+  if (it != m_impl->m_overrides.end()) {
+    return it->second;
+  }
+  return Impl::getDefaultConfig().get<std::string>(key, defaultValue);
 }
 
 /*
@@ -408,43 +631,192 @@ L3Protocol::addFace(shared_ptr<Face> face)
 
   m_impl->m_forwarder->addFace(face);
 
+  auto netDeviceLinkService = dynamic_cast<NetDeviceLinkService*>(face->getLinkService());
+  if (netDeviceLinkService != nullptr) {
+    // the first face of a NetDevice is kept, as with the former face table scan
+    m_impl->m_netDeviceFaces.emplace(PeekPointer(netDeviceLinkService->GetNetDevice()), face);
+  }
+
+  m_impl->m_faceTraces[face->getId()].face = face;
+  updateFaceTraces(face);
+
+  return face->getId();
+}
+
+void
+L3Protocol::updateTraces()
+{
+  if (m_impl == nullptr || m_impl->m_forwarder == nullptr) {
+    // not yet initialized or already disposed
+    return;
+  }
+
+  auto& forwarder = m_impl->m_forwarder;
+  FaceCounterTable* counters = m_impl->m_faceCounters.get();
+  if (counters != nullptr && !m_impl->m_isForwarderCounted) {
+    m_impl->m_countSatisfiedInterests = forwarder->beforeSatisfyInterest.connect(
+      [counters] (const nfd::pit::Entry& entry, const Face&, const Data&) {
+        counters->incrementNodeTotal(FaceCounterTable::IN_SATISFIED_INTERESTS);
+        for (const auto& in : entry.getInRecords()) {
+          counters->increment(FaceCounterTable::IN_SATISFIED_INTERESTS, in.getFace()->getId());
+        }
+        for (const auto& out : entry.getOutRecords()) {
+          counters->increment(FaceCounterTable::OUT_SATISFIED_INTERESTS, out.getFace()->getId());
+        }
+      });
+
+    m_impl->m_countTimedOutInterests = forwarder->beforeExpirePendingInterest.connect(
+      [counters] (const nfd::pit::Entry& entry) {
+        counters->incrementNodeTotal(FaceCounterTable::IN_TIMED_OUT_INTERESTS);
+        for (const auto& in : entry.getInRecords()) {
+          counters->increment(FaceCounterTable::IN_TIMED_OUT_INTERESTS, in.getFace()->getId());
+        }
+        for (const auto& out : entry.getOutRecords()) {
+          counters->increment(FaceCounterTable::OUT_TIMED_OUT_INTERESTS, out.getFace()->getId());
+        }
+      });
+    m_impl->m_isForwarderCounted = true;
+  }
+
+  for (const auto& i : m_impl->m_faceTraces) {
+    shared_ptr<Face> face = i.second.face.lock();
+    if (face != nullptr) {
+      updateFaceTraces(face);
+    }
+  }
+
+#ifndef NDN_DISABLE_L3_TRACES
+  if (m_satisfiedInterests.HasSinks()) {
+    m_impl->m_satisfiedInterestsConnection =
+      forwarder->beforeSatisfyInterest.connect(std::ref(m_satisfiedInterests));
+  }
+  else {
+    m_impl->m_satisfiedInterestsConnection.disconnect();
+  }
+
+  if (m_timedOutInterests.HasSinks()) {
+    m_impl->m_timedOutInterestsConnection =
+      forwarder->beforeExpirePendingInterest.connect(std::ref(m_timedOutInterests));
+  }
+  else {
+    m_impl->m_timedOutInterestsConnection.disconnect();
+  }
+#endif // NDN_DISABLE_L3_TRACES
+}
+
+void
+L3Protocol::updateFaceTraces(const shared_ptr<Face>& face)
+{
+  Impl::FaceTraces& traces = m_impl->m_faceTraces[face->getId()];
+
+  FaceCounterTable* counters = m_impl->m_faceCounters.get();
+  if (counters != nullptr && !traces.isCounted) {
+    nfd::FaceId faceId = face->getId();
+    traces.countInInterests = face->afterReceiveInterest.connect([counters, faceId] (const Interest& interest) {
+        counters->increment(FaceCounterTable::IN_INTERESTS, faceId,
+                            interest.hasWire() ? interest.wireEncode().size() : 0);
+      });
+    traces.countInData = face->afterReceiveData.connect([counters, faceId] (const Data& data) {
+        counters->increment(FaceCounterTable::IN_DATA, faceId,
+                            data.hasWire() ? data.wireEncode().size() : 0);
+      });
+    traces.countOutInterests = face->getLinkService()->afterSendInterest.connect([counters, faceId] (const Interest& interest) {
+        counters->increment(FaceCounterTable::OUT_INTERESTS, faceId,
+                            interest.hasWire() ? interest.wireEncode().size() : 0);
+      });
+    traces.countOutData = face->getLinkService()->afterSendData.connect([counters, faceId] (const Data& data) {
+        counters->increment(FaceCounterTable::OUT_DATA, faceId,
+                            data.hasWire() ? data.wireEncode().size() : 0);
+      });
+    traces.isCounted = true;
+  }
+
+#ifndef NDN_DISABLE_L3_TRACES
   std::weak_ptr<Face> weakFace = face;
 
-  // // Connect Signals to TraceSource
-  face->afterReceiveInterest.connect([this, weakFace](const Interest& interest) {
-      shared_ptr<Face> face = weakFace.lock();
-      if (face != nullptr) {
-        this->m_inInterests(interest, *face);
-      }
-    });
+  // Connect Signals to TraceSource
+  if (m_inInterests.HasSinks()) {
+    traces.inInterests = face->afterReceiveInterest.connect([this, weakFace](const Interest& interest) {
+        shared_ptr<Face> face = weakFace.lock();
+        if (face != nullptr) {
+          this->m_inInterests(interest, *face);
+        }
+      });
+  }
+  else {
+    traces.inInterests.disconnect();
+  }
 
-  face->afterReceiveData.connect([this, weakFace](const Data& data) {
-      shared_ptr<Face> face = weakFace.lock();
-      if (face != nullptr) {
-        this->m_inData(data, *face);
-      }
-    });
+  if (m_inData.HasSinks()) {
+    traces.inData = face->afterReceiveData.connect([this, weakFace](const Data& data) {
+        shared_ptr<Face> face = weakFace.lock();
+        if (face != nullptr) {
+          this->m_inData(data, *face);
+        }
+      });
+  }
+  else {
+    traces.inData.disconnect();
+  }
   // TODO Add nack signals
 
   auto tracingLink = face->getLinkService();
-  NS_LOG_LOGIC("Adding trace sources for afterSendInterest and afterSendData");
-  tracingLink->afterSendInterest.connect([this, weakFace](const Interest& interest) {
-      shared_ptr<Face> face = weakFace.lock();
-      if (face != nullptr) {
-        this->m_outInterests(interest, *face);
-      }
-    });
+  if (m_outInterests.HasSinks()) {
+    traces.outInterests = tracingLink->afterSendInterest.connect([this, weakFace](const Interest& interest) {
+        shared_ptr<Face> face = weakFace.lock();
+        if (face != nullptr) {
+          this->m_outInterests(interest, *face);
+        }
+      });
+  }
+  else {
+    traces.outInterests.disconnect();
+  }
 
-  tracingLink->afterSendData.connect([this, weakFace](const Data& data) {
-      shared_ptr<Face> face = weakFace.lock();
-      if (face != nullptr) {
-        this->m_outData(data, *face);
-      }
-    });
+  if (m_outData.HasSinks()) {
+    traces.outData = tracingLink->afterSendData.connect([this, weakFace](const Data& data) {
+        shared_ptr<Face> face = weakFace.lock();
+        if (face != nullptr) {
+          this->m_outData(data, *face);
+        }
+      });
+  }
+  else {
+    traces.outData.disconnect();
+  }
 
   // TODO Add nack signals
+#endif // NDN_DISABLE_L3_TRACES
+}
 
-  return face->getId();
+void
+L3Protocol::enableFaceCounters()
+{
+  if (m_impl->m_faceCounters != nullptr) {
+    return;
+  }
+
+  m_impl->m_faceCounters.reset(new FaceCounterTable());
+  updateTraces();
+}
+
+const FaceCounterTable*
+L3Protocol::getFaceCounters()
+{
+  FaceCounterTable* counters = m_impl->m_faceCounters.get();
+  if (counters == nullptr) {
+    return nullptr;
+  }
+
+  // Nacks are not signaled on send, take their counts from NFD
+  for (const auto& i : m_impl->m_faceTraces) {
+    shared_ptr<Face> face = i.second.face.lock();
+    if (face != nullptr) {
+      counters->setPackets(FaceCounterTable::IN_NACKS, i.first, face->getCounters().nInNacks);
+      counters->setPackets(FaceCounterTable::OUT_NACKS, i.first, face->getCounters().nOutNacks);
+    }
+  }
+  return counters;
 }
 
 shared_ptr<Face>
@@ -453,18 +825,26 @@ L3Protocol::getFaceById(nfd::FaceId id) const
   return m_impl->m_forwarder->getFaceTable().get(id);
 }
 
+bool
+L3Protocol::isFaceTraced(nfd::FaceId faceId) const
+{
+  auto it = m_impl->m_faceTraces.find(faceId);
+  if (it == m_impl->m_faceTraces.end())
+    return false;
+
+  const Impl::FaceTraces& traces = it->second;
+  return traces.inInterests.isConnected() || traces.outInterests.isConnected() ||
+         traces.inData.isConnected() || traces.outData.isConnected();
+}
+
 shared_ptr<Face>
 L3Protocol::getFaceByNetDevice(Ptr<NetDevice> netDevice) const
 {
-  for (const auto& i : m_impl->m_forwarder->getFaceTable()) {
-    auto linkService = dynamic_cast<NetDeviceLinkService*>(i->getLinkService());
-    if (linkService == nullptr)
-      continue;
+  auto it = m_impl->m_netDeviceFaces.find(PeekPointer(netDevice));
+  if (it == m_impl->m_netDeviceFaces.end())
+    return nullptr;
 
-    if (linkService->GetNetDevice() == netDevice)
-      return i;
-  }
-  return nullptr;
+  return it->second;
 }
 
 Ptr<L3Protocol>
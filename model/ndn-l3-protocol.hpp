@@ -30,6 +30,8 @@
 #include "ns3/nstime.h"
 #include "ns3/traced-callback.h"
 
+#include "ns3/ndnSIM/utils/ndn-observed-traced-callback.hpp"
+
 #include <boost/property_tree/ptree_fwd.hpp>
 
 namespace nfd {
@@ -50,6 +52,8 @@ class Header;
 
 namespace ndn {
 
+class FaceCounterTable;
+
 /**
  * \defgroup ndn ndnSIM: NDN simulation module
  *
@@ -100,12 +104,16 @@ public:
 
   /**
    * \brief Get smart pointer to nfd::FibManager, used by node's NFD
+   *
+   * \return nullptr if management is disabled
    */
   shared_ptr<nfd::FibManager>
   getFibManager();
 
   /**
    * \brief Get smart pointer to nfd::StrategyChoiceManager, used by node's NFD
+   *
+   * \return nullptr if management or the strategy choice manager is disabled
    */
   shared_ptr<nfd::StrategyChoiceManager>
   getStrategyChoiceManager();
@@ -137,22 +145,114 @@ public:
 
   /**
    * \brief Get face for NetDevice
+   *
+   * Constant-time lookup in an index maintained as faces are added and removed
    */
   shared_ptr<Face>
   getFaceByNetDevice(Ptr<NetDevice> netDevice) const;
 
   /**
    * \brief Get NFD config (boost::property_tree)
+   *
+   * The returned config is a private copy of the complete config for this node, which from
+   * then on replaces the shared default config and the values set with setConfigValue().
+   * Prefer setConfigValue() and getConfigValue(), which do not copy the config.
    */
   nfd::ConfigSection&
   getConfig();
 
+  /**
+   * \brief Override a value of the NFD config of this node, e.g., tables.cs_max_packets
+   *
+   * The default config is parsed once and shared by all nodes; a node keeps only the values
+   * it overrides.  Must be called before the stack is aggregated to the node.
+   */
+  void
+  setConfigValue(const std::string& key, const std::string& value);
+
+  /**
+   * \brief Get a value of the NFD config of this node
+   */
+  std::string
+  getConfigValue(const std::string& key, const std::string& defaultValue = "") const;
+
+  /**
+   * \brief Start maintaining per-face packet and byte counters of the node
+   *
+   * Counting costs one array update per packet; it is enabled on demand, e.g., by
+   * L3RateTracer or scenario code that reads getFaceCounters().
+   */
+  void
+  enableFaceCounters();
+
+  /**
+   * \brief Refresh Nack counters and get per-face counters of the node
+   *
+   * Nacks are not signaled on send, so Nack counters are packet counts copied from NFD faces
+   * on every call; Nack bytes are not counted.
+   *
+   * \return nullptr unless enableFaceCounters() was called
+   */
+  const FaceCounterTable*
+  getFaceCounters();
+
+  /**
+   * \brief Check if the face signals of \p faceId are connected to the trace sources
+   *
+   * Face signals are connected only while InInterests, OutInterests, InData, or OutData
+   * have sinks.
+   */
+  bool
+  isFaceTraced(nfd::FaceId faceId) const;
+
   /**
    * \brief Inject interest through internal Face
+   *
+   * Not available when management is disabled, see isManagementDisabled()
    */
   void
   injectInterest(const Interest& interest);
 
+  /**
+   * \brief Check if the stack runs without NFD management (headless data-plane profile)
+   *
+   * Without management, the stack has no internal faces, dispatcher, command validator,
+   * managers, or RIB manager: FIB, strategy choice, and faces can only be changed with the
+   * direct API below (addRoute(), removeRoute(), setStrategy(), addFace(), removeFace()).
+   *
+   * \see StackHelper::disableManagement
+   */
+  bool
+  isManagementDisabled() const;
+
+  /**
+   * \brief Add next hop to FIB entry of \p prefix, bypassing the FIB manager
+   */
+  void
+  addRoute(const Name& prefix, shared_ptr<Face> face, uint64_t cost);
+
+  /**
+   * \brief Remove next hop from FIB entry of \p prefix, bypassing the FIB manager
+   *
+   * The FIB entry is erased if no next hops are left.
+   */
+  void
+  removeRoute(const Name& prefix, shared_ptr<Face> face);
+
+  /**
+   * \brief Set forwarding strategy for \p prefix, bypassing the strategy choice manager
+   *
+   * \return false if \p strategy is not installed on the node
+   */
+  bool
+  setStrategy(const Name& prefix, const Name& strategy);
+
+  /**
+   * \brief Close face and remove it from the face table, bypassing the face manager
+   */
+  void
+  removeFace(shared_ptr<Face> face);
+
 public: // Workaround for python bindings
   static Ptr<L3Protocol>
   getL3Protocol(Ptr<Object> node);
@@ -182,10 +282,25 @@ private:
   initialize();
 
   void
-  initializeManagement();
+  initializeManagement(nfd::ConfigSection& nfdConfig);
+
+  void
+  initializeTables();
+
+  void
+  initializeRibManager(shared_ptr<const nfd::ConfigSection> nfdConfig);
+
+  /**
+   * \brief Connect or disconnect face and forwarder signals to follow trace sinks
+   *
+   * Signals are connected only while the corresponding trace source has sinks.  With
+   * NDN_DISABLE_L3_TRACES defined, signals are never connected and trace sources stay silent.
+   */
+  void
+  updateTraces();
 
   void
-  initializeRibManager();
+  updateFaceTraces(const shared_ptr<Face>& face);
 
 private:
   class Impl;
@@ -194,16 +309,16 @@ private:
   // These objects are aggregated, but for optimization, get them here
   Ptr<Node> m_node; ///< \brief node on which ndn stack is installed
 
-  TracedCallback<const Interest&, const Face&>
+  ObservedTracedCallback<const Interest&, const Face&>
     m_inInterests; ///< @brief trace of incoming Interests
-  TracedCallback<const Interest&, const Face&>
+  ObservedTracedCallback<const Interest&, const Face&>
     m_outInterests; ///< @brief Transmitted interests trace
 
-  TracedCallback<const Data&, const Face&> m_outData; ///< @brief trace of outgoing Data
-  TracedCallback<const Data&, const Face&> m_inData;  ///< @brief trace of incoming Data
+  ObservedTracedCallback<const Data&, const Face&> m_outData; ///< @brief trace of outgoing Data
+  ObservedTracedCallback<const Data&, const Face&> m_inData;  ///< @brief trace of incoming Data
 
-  TracedCallback<const nfd::pit::Entry&, const Face&/*in face*/, const Data&> m_satisfiedInterests;
-  TracedCallback<const nfd::pit::Entry&> m_timedOutInterests;
+  ObservedTracedCallback<const nfd::pit::Entry&, const Face&/*in face*/, const Data&> m_satisfiedInterests;
+  ObservedTracedCallback<const nfd::pit::Entry&> m_timedOutInterests;
 };
 
 } // namespace ndn
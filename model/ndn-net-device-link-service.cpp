@@ -27,21 +27,87 @@
 #include "ns3/packet.h"
 #include "ns3/node.h"
 #include "ns3/pointer.h"
+#include "ns3/simulator.h"
 
 // #include "ns3/address.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/channel.h"
 
 #include "../utils/ndn-fw-hop-count-tag.hpp"
+#include "../utils/ndn-ns3-packet-tag.hpp"
+#include "../utils/ndn-shared-packet-tag.hpp"
+
+#include <ndn-cxx/lp/packet.hpp>
+#include <ndn-cxx/lp/fields.hpp>
+
+#include <tuple>
 
 NS_LOG_COMPONENT_DEFINE("ndn.NetDeviceLinkService");
 
 namespace ns3 {
 namespace ndn {
 
-NetDeviceLinkService::NetDeviceLinkService(Ptr<Node> node, const Ptr<NetDevice>& netDevice)
+namespace {
+
+/**
+ * \brief Identify the sender of fragments for the reassembler
+ *
+ * The identifier is the address itself for addresses of up to 8 bytes (e.g., MAC-48).
+ */
+nfd::face::EndpointId
+makeEndpointId(const Address& address)
+{
+  uint8_t buffer[Address::MAX_SIZE];
+  uint32_t length = address.CopyTo(buffer);
+
+  nfd::face::EndpointId id = 0;
+  for (uint32_t i = 0; i < length; ++i) {
+    id = (id << 8) | buffer[i];
+  }
+  return id;
+}
+
+template<class Pkt>
+void
+copyHopCountTag(const Pkt& pkt, Ptr<Packet> packet)
+{
+  auto tag = pkt.template getTag<Ns3PacketTag>();
+  if (tag != nullptr) {
+    FwHopCountTag hopCountTag;
+    if (tag->peekHopCountTag(hopCountTag)) {
+      packet->AddPacketTag(hopCountTag);
+    }
+  }
+}
+
+template<class Pkt>
+Ptr<Packet>
+makeSharedPacket(const Pkt& pkt)
+{
+  // zero-filled area of an ns-3 packet is not allocated, it only makes the size exact
+  Ptr<Packet> packet = Create<Packet>(pkt.wireEncode().size());
+  packet->AddPacketTag(SharedPacketTag(pkt));
+  copyHopCountTag(pkt, packet);
+  return packet;
+}
+
+} // namespace
+
+NetDeviceLinkService::Options::Options()
+  : allowFragmentation(true)
+  , nMaxPartialPackets(64)
+{
+}
+
+NetDeviceLinkService::NetDeviceLinkService(Ptr<Node> node, const Ptr<NetDevice>& netDevice,
+                                           const Options& options)
   : m_node(node)
   , m_netDevice(netDevice)
+  , m_isSharedPacketEnabled(false)
+  , m_options(options)
+  , m_fragmenter(options.fragmenterOptions, this)
+  , m_reassembler(options.reassemblerOptions, this)
+  , m_lastSeqNo(0)
 {
   NS_LOG_FUNCTION(this << netDevice);
 
@@ -50,6 +116,10 @@ NetDeviceLinkService::NetDeviceLinkService(Ptr<Node> node, const Ptr<NetDevice>&
   m_node->RegisterProtocolHandler(MakeCallback(&NetDeviceLinkService::receiveFromNetDevice, this),
                                   L3Protocol::ETHERNET_FRAME_TYPE, m_netDevice,
                                   true /*promiscuous mode*/);
+
+  m_reassembler.beforeTimeout.connect([] (nfd::face::EndpointId, size_t nDroppedFragments) {
+      NS_LOG_DEBUG("Reassembly timed out, " << nDroppedFragments << " fragments dropped");
+    });
 }
 
 NetDeviceLinkService::~NetDeviceLinkService()
@@ -69,13 +139,44 @@ NetDeviceLinkService::GetNetDevice() const
   return m_netDevice;
 }
 
+void
+NetDeviceLinkService::setSharedPacketEnabled(bool isEnabled)
+{
+  m_isSharedPacketEnabled = isEnabled;
+}
+
+bool
+NetDeviceLinkService::isSharedPacketEnabled() const
+{
+  return m_isSharedPacketEnabled;
+}
+
+const NetDeviceLinkService::Options&
+NetDeviceLinkService::getOptions() const
+{
+  return m_options;
+}
+
+void
+NetDeviceLinkService::setOptions(const Options& options)
+{
+  m_options = options;
+  m_fragmenter.setOptions(options.fragmenterOptions);
+  m_reassembler.setOptions(options.reassemblerOptions);
+}
+
+size_t
+NetDeviceLinkService::getNPartialPackets() const
+{
+  return m_reassembler.size();
+}
+
 void
 NetDeviceLinkService::doSendInterest(const Interest& interest)
 {
   NS_LOG_FUNCTION(this << &interest);
 
-  Ptr<Packet> packet = Convert::ToPacket(interest);
-  send(packet);
+  sendNetworkPacket(interest);
 }
 
 void
@@ -83,10 +184,57 @@ NetDeviceLinkService::doSendData(const Data& data)
 {
   NS_LOG_FUNCTION(this << &data);
 
-  Ptr<Packet> packet = Convert::ToPacket(data);
+  sendNetworkPacket(data);
+}
+
+template<class Pkt>
+void
+NetDeviceLinkService::sendNetworkPacket(const Pkt& pkt)
+{
+  if (pkt.wireEncode().size() > m_netDevice->GetMtu()) {
+    if (!m_options.allowFragmentation) {
+      NS_LOG_ERROR("Packet of " << pkt.wireEncode().size() << " bytes exceeds MTU "
+                   << m_netDevice->GetMtu() << " and fragmentation is disabled, packet dropped");
+      return;
+    }
+
+    // shared packets are not fragmented either, as fragments have their own headers
+    sendFragments(pkt);
+    return;
+  }
+
+  Ptr<Packet> packet = m_isSharedPacketEnabled ? makeSharedPacket(pkt) : Convert::ToPacket(pkt);
   send(packet);
 }
 
+template<class Pkt>
+void
+NetDeviceLinkService::sendFragments(const Pkt& pkt)
+{
+  bool isOk = false;
+  std::vector<lp::Packet> fragments;
+  std::tie(isOk, fragments) = m_fragmenter.fragmentPacket(lp::Packet(pkt.wireEncode()),
+                                                          m_netDevice->GetMtu());
+  if (!isOk) {
+    NS_LOG_ERROR("Packet of " << pkt.wireEncode().size() << " bytes cannot be fragmented for MTU "
+                 << m_netDevice->GetMtu() << ", packet dropped");
+    return;
+  }
+
+  // fragments of one packet have consecutive sequence numbers, the receiver identifies the
+  // packet by the sequence number of its first fragment
+  NS_LOG_DEBUG("Sending " << pkt.wireEncode().size() << " bytes in " << fragments.size()
+               << " fragments");
+  for (lp::Packet& fragment : fragments) {
+    fragment.add<lp::SequenceField>(++m_lastSeqNo);
+
+    Block fragmentWire = fragment.wireEncode();
+    Ptr<Packet> packet = Create<Packet>(fragmentWire.wire(), fragmentWire.size());
+    copyHopCountTag(pkt, packet);
+    send(packet);
+  }
+}
+
 void
 NetDeviceLinkService::doSendNack(const lp::Nack& nack)
 {
@@ -105,21 +253,45 @@ NetDeviceLinkService::receiveFromNetDevice(Ptr<NetDevice> device, Ptr<const Pack
 {
   NS_LOG_FUNCTION(device << p << protocol << from << to << packetType);
 
-  Ptr<Packet> packet = p->Copy();
+  SharedPacketTag sharedPacketTag;
+  if (p->PeekPacketTag(sharedPacketTag)) {
+    // a shallow copy shares the name and wire buffers with the sender's object, but keeps
+    // the tags set by this node (e.g., the hop count of this link) to itself
+    if (shared_ptr<const Interest> i = sharedPacketTag.releaseInterest()) {
+      auto interest = make_shared<Interest>(*i);
+      interest->setTag(make_shared<Ns3PacketTag>(p));
+      this->receiveInterest(*interest);
+    }
+    else if (shared_ptr<const Data> d = sharedPacketTag.releaseData()) {
+      auto data = make_shared<Data>(*d);
+      data->setTag(make_shared<Ns3PacketTag>(p));
+      this->receiveData(*data);
+    }
+    else {
+      NS_LOG_ERROR("Shared packet has been released or has expired");
+    }
+    return;
+  }
+
+  // the packet is only peeked, so it does not need to be copied
   try {
     switch (Convert::getPacketType(p)) {
       case ::ndn::tlv::Interest: {
-        shared_ptr<const Interest> i = Convert::FromPacket<Interest>(packet);
+        shared_ptr<const Interest> i = Convert::FromPacket<Interest>(p);
         this->receiveInterest(*i);
         break;
       }
       case ::ndn::tlv::Data: {
-        shared_ptr<const Data> d = Convert::FromPacket<Data>(packet);
+        shared_ptr<const Data> d = Convert::FromPacket<Data>(p);
         this->receiveData(*d);
         break;
       }
+      case lp::tlv::LpPacket: {
+        receiveFragment(p, from);
+        break;
+      }
       // case ::ndn::tlv::Nack: {
-      //   shared_ptr<const Nack> n = Convert::FromPacket<Nack>(packet);
+      //   shared_ptr<const Nack> n = Convert::FromPacket<Nack>(p);
       //   this->onReceiveNack(*n);
       // }
       default:
@@ -131,6 +303,98 @@ NetDeviceLinkService::receiveFromNetDevice(Ptr<NetDevice> device, Ptr<const Pack
   }
 }
 
+void
+NetDeviceLinkService::receiveFragment(Ptr<const Packet> p, const Address& from)
+{
+  std::vector<uint8_t> buffer(p->GetSize());
+  p->CopyData(buffer.data(), buffer.size());
+  lp::Packet fragment(Block(buffer.data(), buffer.size()));
+
+  if (!fragment.has<lp::FragmentField>()) {
+    NS_LOG_DEBUG("LpPacket without fragment (IDLE packet), ignored");
+    return;
+  }
+
+  // LpReassembler only reports the number of partial packets, so they are tracked here to tell
+  // fragments of buffered packets from fragments of new ones
+  nfd::face::EndpointId endpoint = makeEndpointId(from);
+  bool isPartial = fragment.has<lp::SequenceField>() && fragment.has<lp::FragCountField>() &&
+                   fragment.get<lp::FragCountField>() > 1;
+  PartialPacketKey key;
+  if (isPartial) {
+    uint64_t fragIndex = fragment.has<lp::FragIndexField>() ? fragment.get<lp::FragIndexField>() : 0;
+    key = PartialPacketKey(endpoint, fragment.get<lp::SequenceField>() - fragIndex);
+
+    expirePartialPackets();
+    if (m_partialPackets.count(key) == 0 &&
+        m_reassembler.size() >= m_options.nMaxPartialPackets) {
+      NS_LOG_DEBUG(m_reassembler.size() << " partial packets are buffered, fragment dropped");
+      return;
+    }
+  }
+
+  size_t nPartialPackets = m_reassembler.size();
+  bool isReassembled = false;
+  Block wire;
+  lp::Packet firstFragment;
+  std::tie(isReassembled, wire, firstFragment) = m_reassembler.receiveFragment(endpoint, fragment);
+
+  if (isPartial) {
+    if (isReassembled) {
+      m_partialPackets.erase(key);
+    }
+    else if (m_reassembler.size() > nPartialPackets || m_partialPackets.count(key) > 0) {
+      // the reassembler restarts the timeout of a partial packet on each of its fragments
+      m_partialPackets[key] = Simulator::Now();
+    }
+  }
+
+  // the last fragment carries the hop count, as all fragments do
+  if (isReassembled) {
+    receiveNetworkPacket(wire, p);
+  }
+}
+
+void
+NetDeviceLinkService::expirePartialPackets()
+{
+  if (m_reassembler.size() == 0) {
+    m_partialPackets.clear();
+    return;
+  }
+
+  Time timeout = NanoSeconds(m_options.reassemblerOptions.reassemblyTimeout.count());
+  for (auto it = m_partialPackets.begin(); it != m_partialPackets.end();) {
+    if (Simulator::Now() - it->second >= timeout) {
+      it = m_partialPackets.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+void
+NetDeviceLinkService::receiveNetworkPacket(const Block& wire, Ptr<const Packet> p)
+{
+  switch (wire.type()) {
+    case ::ndn::tlv::Interest: {
+      auto i = make_shared<Interest>(wire);
+      i->setTag(make_shared<Ns3PacketTag>(p));
+      this->receiveInterest(*i);
+      break;
+    }
+    case ::ndn::tlv::Data: {
+      auto d = make_shared<Data>(wire);
+      d->setTag(make_shared<Ns3PacketTag>(p));
+      this->receiveData(*d);
+      break;
+    }
+    default:
+      NS_LOG_ERROR("Unsupported TLV packet in LpPacket fragment");
+  }
+}
+
 void
 NetDeviceLinkService::send(Ptr<Packet> packet)
 {
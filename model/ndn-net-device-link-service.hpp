@@ -22,8 +22,14 @@
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/ndnSIM/NFD/daemon/face/link-service.hpp"
+#include "ns3/ndnSIM/NFD/daemon/face/lp-fragmenter.hpp"
+#include "ns3/ndnSIM/NFD/daemon/face/lp-reassembler.hpp"
 
 #include "ns3/net-device.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <tuple>
 
 namespace ns3 {
 namespace ndn {
@@ -36,10 +42,53 @@ namespace ndn {
  * object and this object cannot be changed for the lifetime of the
  * face
  *
+ * Interests and Data that do not fit into the MTU of the NetDevice are split into NDNLP
+ * fragments (LpPacket with Sequence, FragIndex, and FragCount fields) by NFD's LpFragmenter,
+ * and the receiving NetDeviceLinkService reassembles them with NFD's LpReassembler.  The
+ * receiver buffers at most Options::nMaxPartialPackets incomplete packets and drops
+ * fragments of further packets until some of these are complete or time out.
+ *
  * \see AppLinkService
  */
 class NetDeviceLinkService : public nfd::face::LinkService
 {
+public:
+  /**
+   * \brief Options of NDNLP fragmentation and reassembly
+   */
+  class Options
+  {
+  public:
+    Options();
+
+  public:
+    /**
+     * \brief whether packets exceeding the device MTU are fragmented
+     *
+     * If disabled, such packets are dropped.  Fragments are reassembled regardless of this
+     * option.
+     */
+    bool allowFragmentation;
+
+    /**
+     * \brief maximum number of packets whose fragments are waiting for reassembly
+     *
+     * Fragments that would start a new partial packet are dropped when this many partial
+     * packets are buffered.
+     */
+    size_t nMaxPartialPackets;
+
+    /**
+     * \brief options of the fragmenter (maximum number of fragments of one packet)
+     */
+    nfd::face::LpFragmenter::Options fragmenterOptions;
+
+    /**
+     * \brief options of the reassembler (maximum number of fragments of one packet and
+     *        time after which an incomplete packet is dropped)
+     */
+    nfd::face::LpReassembler::Options reassemblerOptions;
+  };
 
 public:
   /**
@@ -47,8 +96,10 @@ public:
    *
    * @param node Node associated with the face
    * @param netDevice a smart pointer to NetDevice object to which this NetDeviceLinkService will be associate
+   * @param options fragmentation and reassembly options
    */
-  NetDeviceLinkService(Ptr<Node> node, const Ptr<NetDevice>& netDevice);
+  NetDeviceLinkService(Ptr<Node> node, const Ptr<NetDevice>& netDevice,
+                       const Options& options = Options());
 
   virtual
   ~NetDeviceLinkService();
@@ -66,6 +117,37 @@ public:
   Ptr<NetDevice>
   GetNetDevice() const;
 
+  /**
+   * \brief Enable or disable the shared-packet mode
+   *
+   * In this mode Interests and Data are not encoded into ns-3 packets.  The packet sent to
+   * the NetDevice carries zero padding of the size of the encoded packet and a
+   * SharedPacketTag that references the Interest or Data, so the serialization delay and
+   * queueing on the link do not change, and the receiving NetDeviceLinkService uses a
+   * shallow copy of the object, which shares its buffers, without decoding it.  Receivers
+   * handle such packets in any mode.
+   *
+   * The mode is only valid when both ends of the link run in the same process (e.g., not
+   * over a PointToPointRemoteChannel), and packet traces (pcap) will contain the padding.
+   */
+  void
+  setSharedPacketEnabled(bool isEnabled);
+
+  bool
+  isSharedPacketEnabled() const;
+
+  const Options&
+  getOptions() const;
+
+  void
+  setOptions(const Options& options);
+
+  /**
+   * \brief Get the number of packets whose fragments are waiting for reassembly
+   */
+  size_t
+  getNPartialPackets() const;
+
 private:
   virtual void
   doSendInterest(const ::ndn::Interest& interest) override;
@@ -84,9 +166,29 @@ private:
   }
 
 private:
+  template<class Pkt>
+  void
+  sendNetworkPacket(const Pkt& pkt);
+
+  /// \brief split encoded Interest or Data into NDNLP fragments and send them
+  template<class Pkt>
+  void
+  sendFragments(const Pkt& pkt);
+
   void
   send(Ptr<Packet> packet);
 
+  void
+  receiveFragment(Ptr<const Packet> p, const Address& from);
+
+  /// \brief forget partial packets that the reassembler has dropped after its timeout
+  void
+  expirePartialPackets();
+
+  /// \brief decode and dispatch reassembled Interest or Data
+  void
+  receiveNetworkPacket(const Block& wire, Ptr<const Packet> p);
+
   /// \brief callback from lower layers
   void
   receiveFromNetDevice(Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol,
@@ -95,6 +197,18 @@ private:
 private:
   Ptr<Node> m_node;
   Ptr<NetDevice> m_netDevice; ///< \brief Smart pointer to NetDevice
+  bool m_isSharedPacketEnabled;
+  Options m_options;
+
+  nfd::face::LpFragmenter m_fragmenter;
+  nfd::face::LpReassembler m_reassembler;
+  uint64_t m_lastSeqNo;
+
+  /// \brief sender and sequence number of the first fragment, which identify a partial packet
+  typedef std::tuple<nfd::face::EndpointId, uint64_t> PartialPacketKey;
+
+  /// \brief partial packets in m_reassembler and the arrival time of their last fragment
+  std::map<PartialPacketKey, Time> m_partialPackets;
 };
 
 } // namespace ndn
@@ -22,19 +22,21 @@
 #include <ndn-cxx/encoding/block.hpp>
 #include <ndn-cxx/interest.hpp>
 #include <ndn-cxx/data.hpp>
+#include <ndn-cxx/lp/tlv.hpp>
 
 #include "ndn-header.hpp"
 #include "../utils/ndn-ns3-packet-tag.hpp"
+#include "../utils/ndn-fw-hop-count-tag.hpp"
 
 namespace ns3 {
 namespace ndn {
 
 template<class T>
 std::shared_ptr<const T>
-Convert::FromPacket(Ptr<Packet> packet)
+Convert::FromPacket(Ptr<const Packet> packet)
 {
   PacketHeader<T> header;
-  packet->RemoveHeader(header);
+  packet->PeekHeader(header);
 
   auto pkt = header.getPacket();
   pkt->setTag(make_shared<Ns3PacketTag>(packet));
@@ -43,10 +45,10 @@ Convert::FromPacket(Ptr<Packet> packet)
 }
 
 template std::shared_ptr<const Interest>
-Convert::FromPacket<Interest>(Ptr<Packet> packet);
+Convert::FromPacket<Interest>(Ptr<const Packet> packet);
 
 template std::shared_ptr<const Data>
-Convert::FromPacket<Data>(Ptr<Packet> packet);
+Convert::FromPacket<Data>(Ptr<const Packet> packet);
 
 template<class T>
 Ptr<Packet>
@@ -54,17 +56,17 @@ Convert::ToPacket(const T& pkt)
 {
   PacketHeader<T> header(pkt);
 
-  Ptr<Packet> packet;
+  Ptr<Packet> packet = Create<Packet>();
+  packet->AddHeader(header);
 
   auto tag = pkt.template getTag<Ns3PacketTag>();
   if (tag != nullptr) {
-    packet = tag->getPacket()->Copy();
-  }
-  else {
-    packet = Create<Packet>();
+    FwHopCountTag hopCountTag;
+    if (tag->peekHopCountTag(hopCountTag)) {
+      packet->AddPacketTag(hopCountTag);
+    }
   }
 
-  packet->AddHeader(header);
   return packet;
 }
 
@@ -83,7 +85,7 @@ Convert::getPacketType(Ptr<const Packet> packet)
     throw ::ndn::tlv::Error("Unknown header");
   }
 
-  if (type == ::ndn::tlv::Interest || type == ::ndn::tlv::Data) {
+  if (type == ::ndn::tlv::Interest || type == ::ndn::tlv::Data || type == lp::tlv::LpPacket) {
     return type;
   }
   else {
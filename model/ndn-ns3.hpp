@@ -29,9 +29,15 @@ namespace ndn {
 
 class Convert {
 public:
+  /**
+   * \brief Decode Interest or Data from the packet
+   *
+   * The packet is not modified.  The returned object is tagged with Ns3PacketTag, which
+   * holds the per-hop metadata of the packet (hop count), not the packet itself.
+   */
   template<class T>
   static std::shared_ptr<const T>
-  FromPacket(Ptr<Packet> packet);
+  FromPacket(Ptr<const Packet> packet);
 
   template<class T>
   static Ptr<Packet>
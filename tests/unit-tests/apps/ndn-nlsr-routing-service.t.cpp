@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/ndn-nlsr-routing-service.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class NlsrRoutingServiceFixture : public CleanupFixture
+{
+public:
+  NlsrRoutingServiceFixture()
+  {
+    NlsrRoutingService::Instance().Clear();
+  }
+
+  ~NlsrRoutingServiceFixture()
+  {
+    NlsrRoutingService::Instance().Clear();
+  }
+
+  // line r0 -- r1 -- r2 with link cost 10
+  static shared_ptr<NlsrRoutingService::Result>
+  makeLine(const NlsrRoutingService::LsdbVersion& version)
+  {
+    auto result = make_shared<NlsrRoutingService::Result>(version, false, 1);
+    for (uint32_t i = 0; i < 2; ++i) {
+      uint32_t router = result->AddRouter("/r" + std::to_string(i));
+      uint32_t neighbor = result->AddRouter("/r" + std::to_string(i + 1));
+      result->AddLink(router, neighbor, 10);
+      result->AddLink(neighbor, router, 10);
+    }
+    return result;
+  }
+
+  static NlsrRoutingService::LsdbVersion
+  makeVersion(uint64_t seqNo)
+  {
+    NlsrRoutingService::LsdbVersion version;
+    version.Add('a', Name("/r0"), seqNo);
+    return version;
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(AppsNlsrRoutingService, NlsrRoutingServiceFixture)
+
+BOOST_AUTO_TEST_CASE(LsdbVersion)
+{
+  NlsrRoutingService::LsdbVersion version1(false, 3);
+  version1.Add('a', Name("/r1"), 5);
+  version1.Add('a', Name("/r2"), 4);
+  version1.Add('c', Name("/r1"), 1);
+
+  // independent of LSDB order
+  NlsrRoutingService::LsdbVersion version2(false, 3);
+  version2.Add('c', Name("/r1"), 1);
+  version2.Add('a', Name("/r2"), 4);
+  version2.Add('a', Name("/r1"), 5);
+  BOOST_CHECK(version1 == version2);
+  BOOST_CHECK(!(version1 < version2) && !(version2 < version1));
+
+  // incremental update when an LSA is refreshed
+  version2.Remove('a', Name("/r2"), 4);
+  version2.Add('a', Name("/r2"), 5);
+  BOOST_CHECK(version1 != version2);
+
+  NlsrRoutingService::LsdbVersion version3(false, 3);
+  version3.Add('a', Name("/r2"), 5);
+  version3.Add('a', Name("/r1"), 5);
+  version3.Add('c', Name("/r1"), 1);
+  BOOST_CHECK(version2 == version3);
+
+  // LSA type and routing parameters are part of the version
+  NlsrRoutingService::LsdbVersion version4(false, 3);
+  version4.Add('c', Name("/r1"), 5);
+  version4.Add('a', Name("/r2"), 4);
+  version4.Add('a', Name("/r1"), 1);
+  BOOST_CHECK(version1 != version4);
+
+  NlsrRoutingService::LsdbVersion version5(true, 3);
+  version5.Add('a', Name("/r1"), 5);
+  version5.Add('a', Name("/r2"), 4);
+  version5.Add('c', Name("/r1"), 1);
+  BOOST_CHECK(version1 != version5);
+
+  NlsrRoutingService::LsdbVersion version6(false, 0);
+  version6.Add('a', Name("/r1"), 5);
+  version6.Add('a', Name("/r2"), 4);
+  version6.Add('c', Name("/r1"), 1);
+  BOOST_CHECK(version1 != version6);
+}
+
+BOOST_AUTO_TEST_CASE(ResultLsas)
+{
+  // the LSAs confirm a version match, which is only a hash
+  shared_ptr<NlsrRoutingService::Result> result = makeLine(makeVersion(1));
+  result->SetLsas({
+      NlsrRoutingService::Result::LsaId('a', Name("/r2"), 4),
+      NlsrRoutingService::Result::LsaId('c', Name("/r0"), 1),
+      NlsrRoutingService::Result::LsaId('a', Name("/r0"), 1),
+      NlsrRoutingService::Result::LsaId('a', Name("/r1"), 7),
+    });
+
+  BOOST_CHECK(result->HasLsa('a', Name("/r0"), 1));
+  BOOST_CHECK(result->HasLsa('a', Name("/r1"), 7));
+  BOOST_CHECK(result->HasLsa('a', Name("/r2"), 4));
+  BOOST_CHECK(result->HasLsa('c', Name("/r0"), 1));
+
+  BOOST_CHECK(!result->HasLsa('a', Name("/r1"), 8));
+  BOOST_CHECK(!result->HasLsa('c', Name("/r1"), 7));
+  BOOST_CHECK(!result->HasLsa('a', Name("/r3"), 1));
+}
+
+BOOST_AUTO_TEST_CASE(RoutingTablePerRouter)
+{
+  shared_ptr<NlsrRoutingService::Result> result = makeLine(makeVersion(1));
+  BOOST_REQUIRE_EQUAL(result->GetNRouters(), 3);
+  BOOST_CHECK_EQUAL(result->GetNComputedTables(), 0);
+
+  uint32_t r0 = 0;
+  uint32_t r2 = 0;
+  BOOST_REQUIRE(result->FindRouter("/r0", r0));
+  BOOST_REQUIRE(result->FindRouter("/r2", r2));
+  BOOST_CHECK(!result->FindRouter("/r3", r2));
+
+  // only the requested table is computed
+  const NlsrRoutingOracle::RoutingTable& table = result->GetRoutingTable(r0);
+  BOOST_CHECK_EQUAL(result->GetNComputedTables(), 1);
+  BOOST_REQUIRE_EQUAL(table.size(), 3);
+  BOOST_CHECK(table[r0].empty());
+  BOOST_REQUIRE_EQUAL(table[r2].size(), 1);
+  BOOST_CHECK_EQUAL(result->GetRouter(table[r2][0].neighbor), "/r1");
+  BOOST_CHECK_EQUAL(table[r2][0].cost, 20);
+
+  result->GetRoutingTable(r0);
+  BOOST_CHECK_EQUAL(result->GetNComputedTables(), 1);
+
+  // the remaining tables are computed at once, with the same rows
+  result->ComputeAll(2);
+  BOOST_CHECK_EQUAL(result->GetNComputedTables(), 3);
+  const NlsrRoutingOracle::RoutingTable& reverse = result->GetRoutingTable(r2);
+  BOOST_REQUIRE_EQUAL(reverse[r0].size(), 1);
+  BOOST_CHECK_EQUAL(result->GetRouter(reverse[r0][0].neighbor), "/r1");
+  BOOST_CHECK_EQUAL(reverse[r0][0].cost, 20);
+}
+
+BOOST_AUTO_TEST_CASE(CacheKeepsInstalledResults)
+{
+  NlsrRoutingService& service = NlsrRoutingService::Instance();
+
+  // results installed by routers stay cached, however many versions coexist
+  std::vector<shared_ptr<const NlsrRoutingService::Result>> installed;
+  for (uint64_t seqNo = 0; seqNo < 100; ++seqNo) {
+    installed.push_back(makeLine(makeVersion(seqNo)));
+    service.Insert(installed.back());
+  }
+  for (uint64_t seqNo = 0; seqNo < 100; ++seqNo) {
+    BOOST_CHECK(service.Find(makeVersion(seqNo)) == installed[seqNo]);
+  }
+  BOOST_CHECK(service.Find(makeVersion(100)) == nullptr);
+
+  // results not held by any router are dropped, except the most recent ones
+  installed.clear();
+  BOOST_CHECK(service.Find(makeVersion(0)) == nullptr);
+  BOOST_CHECK(service.Find(makeVersion(99)) != nullptr);
+
+  service.Clear();
+  BOOST_CHECK(service.Find(makeVersion(99)) == nullptr);
+  BOOST_CHECK_EQUAL(service.GetNCachedResults(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
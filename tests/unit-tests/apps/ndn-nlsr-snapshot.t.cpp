@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/ndn-nlsr-snapshot.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+const boost::filesystem::path TEST_SNAPSHOT = boost::filesystem::path(TEST_CONFIG_PATH) / "snapshot.txt";
+const boost::filesystem::path TEST_SNAPSHOT_COPY = boost::filesystem::path(TEST_CONFIG_PATH) / "snapshot-copy.txt";
+
+// two converged routers, in the order and format written by NlsrSnapshot::Save;
+// r2's route cost is 31/3, written with max_digits10 significant digits
+const std::string SNAPSHOT =
+  "NLSR-SNAPSHOT 1\n"
+  "router /ndn/edu/%C1.Router/r1\n"
+  "seq 3 5 0\n"
+  "adj /ndn/edu/%C1.Router/r2 1\n"
+  "name-lsa /ndn/edu/%C1.Router/r1|name|3|2016-01-01 00:00:00|1|/ndn/edu/r1|\n"
+  "name-lsa /ndn/edu/%C1.Router/r2|name|2|2016-01-01 00:00:00|1|/ndn/edu/r2|\n"
+  "adj-lsa /ndn/edu/%C1.Router/r1|adjacency|5|2016-01-01 00:00:00|1|/ndn/edu/%C1.Router/r2|udp4://10.0.0.2|10|\n"
+  "adj-lsa /ndn/edu/%C1.Router/r2|adjacency|4|2016-01-01 00:00:00|1|/ndn/edu/%C1.Router/r1|udp4://10.0.0.1|10|\n"
+  "route /ndn/edu/%C1.Router/r2 udp4://10.0.0.2 10\n"
+  "end\n"
+  "router /ndn/edu/%C1.Router/r2\n"
+  "seq 2 4 0\n"
+  "adj /ndn/edu/%C1.Router/r1 1\n"
+  "name-lsa /ndn/edu/%C1.Router/r1|name|3|2016-01-01 00:00:00|1|/ndn/edu/r1|\n"
+  "name-lsa /ndn/edu/%C1.Router/r2|name|2|2016-01-01 00:00:00|1|/ndn/edu/r2|\n"
+  "adj-lsa /ndn/edu/%C1.Router/r1|adjacency|5|2016-01-01 00:00:00|1|/ndn/edu/%C1.Router/r2|udp4://10.0.0.2|10|\n"
+  "adj-lsa /ndn/edu/%C1.Router/r2|adjacency|4|2016-01-01 00:00:00|1|/ndn/edu/%C1.Router/r1|udp4://10.0.0.1|10|\n"
+  "route /ndn/edu/%C1.Router/r1 udp4://10.0.0.1 10.333333333333334\n"
+  "end\n";
+
+class NlsrSnapshotFixture : public CleanupFixture
+{
+public:
+  NlsrSnapshotFixture()
+  {
+    boost::filesystem::create_directories(TEST_CONFIG_PATH);
+  }
+
+  ~NlsrSnapshotFixture()
+  {
+    boost::filesystem::remove(TEST_SNAPSHOT);
+    boost::filesystem::remove(TEST_SNAPSHOT_COPY);
+  }
+
+  void
+  write(const boost::filesystem::path& file, const std::string& content)
+  {
+    std::ofstream os(file.string().c_str());
+    os << content;
+  }
+
+  std::string
+  read(const boost::filesystem::path& file)
+  {
+    std::ifstream is(file.string().c_str());
+    std::stringstream buffer;
+    buffer << is.rdbuf();
+    return buffer.str();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(AppsNdnNlsrSnapshot, NlsrSnapshotFixture)
+
+BOOST_AUTO_TEST_CASE(SaveLoadRoundTrip)
+{
+  write(TEST_SNAPSHOT, SNAPSHOT);
+
+  NlsrSnapshot snapshot;
+  BOOST_REQUIRE(snapshot.Load(TEST_SNAPSHOT.string()));
+  BOOST_CHECK_EQUAL(snapshot.GetN(), 2);
+
+  const NlsrSnapshot::RouterState* r1 = snapshot.Find("/ndn/edu/%C1.Router/r1");
+  BOOST_REQUIRE(r1 != nullptr);
+  BOOST_CHECK_EQUAL(r1->nameLsaSeq, 3);
+  BOOST_CHECK_EQUAL(r1->adjLsaSeq, 5);
+  BOOST_CHECK_EQUAL(r1->corLsaSeq, 0);
+  BOOST_REQUIRE_EQUAL(r1->adjacencies.size(), 1);
+  BOOST_CHECK_EQUAL(r1->adjacencies[0].first, "/ndn/edu/%C1.Router/r2");
+  BOOST_CHECK_EQUAL(r1->adjacencies[0].second, 1);
+  BOOST_CHECK_EQUAL(r1->nameLsas.size(), 2);
+  BOOST_CHECK_EQUAL(r1->adjLsas.size(), 2);
+  BOOST_CHECK_EQUAL(r1->corLsas.size(), 0);
+  BOOST_REQUIRE_EQUAL(r1->routes.size(), 1);
+  BOOST_CHECK_EQUAL(r1->routes[0].destination, "/ndn/edu/%C1.Router/r2");
+  BOOST_CHECK_EQUAL(r1->routes[0].faceUri, "udp4://10.0.0.2");
+  BOOST_CHECK_EQUAL(r1->routes[0].cost, 10);
+
+  BOOST_CHECK(snapshot.Find("/ndn/edu/%C1.Router/r3") == nullptr);
+
+  BOOST_REQUIRE(snapshot.Save(TEST_SNAPSHOT_COPY.string()));
+  BOOST_CHECK_EQUAL(read(TEST_SNAPSHOT_COPY), SNAPSHOT);
+
+  NlsrSnapshot copy;
+  BOOST_REQUIRE(copy.Load(TEST_SNAPSHOT_COPY.string()));
+  BOOST_CHECK_EQUAL(copy.GetN(), 2);
+  BOOST_CHECK_EQUAL(copy.Find("/ndn/edu/%C1.Router/r2")->routes[0].faceUri, "udp4://10.0.0.1");
+  // a non-integer cost survives the round trip exactly
+  BOOST_CHECK_EQUAL(snapshot.Find("/ndn/edu/%C1.Router/r2")->routes[0].cost, 31.0 / 3);
+  BOOST_CHECK_EQUAL(copy.Find("/ndn/edu/%C1.Router/r2")->routes[0].cost, 31.0 / 3);
+}
+
+BOOST_AUTO_TEST_CASE(Malformed)
+{
+  NlsrSnapshot snapshot;
+  BOOST_CHECK_EQUAL(snapshot.Load((boost::filesystem::path(TEST_CONFIG_PATH) / "missing.txt").string()),
+                    false);
+
+  write(TEST_SNAPSHOT, "NLSR-SNAPSHOT 2\n");
+  BOOST_CHECK_EQUAL(snapshot.Load(TEST_SNAPSHOT.string()), false);
+
+  write(TEST_SNAPSHOT, "NLSR-SNAPSHOT 1\nseq 1 1 1\n");
+  BOOST_CHECK_EQUAL(snapshot.Load(TEST_SNAPSHOT.string()), false);
+
+  write(TEST_SNAPSHOT, "NLSR-SNAPSHOT 1\nrouter /r1\nroute /r2 udp4://10.0.0.2\nend\n");
+  BOOST_CHECK_EQUAL(snapshot.Load(TEST_SNAPSHOT.string()), false);
+
+  write(TEST_SNAPSHOT, "NLSR-SNAPSHOT 1\nrouter /r1\nunknown record\nend\n");
+  BOOST_CHECK_EQUAL(snapshot.Load(TEST_SNAPSHOT.string()), false);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -18,6 +18,9 @@
  **/
 
 #include "helper/ndn-fib-helper.hpp"
+#include "model/ndn-l3-protocol.hpp"
+
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
 
 #include "../tests-common.hpp"
 
@@ -97,8 +100,65 @@ BOOST_AUTO_TEST_CASE(Helper4)
   FibHelper::AddRoute(getNode("1"), Name("/prefix"), getNode("2"), 10);
 }
 
+// static bool
+// AddRoutes(Ptr<Node> node, const std::vector<Route>& routes, bool useManagement);
+BOOST_AUTO_TEST_CASE(Bulk)
+{
+  BOOST_CHECK(FibHelper::AddRoutes(getNode("1"), {{"/prefix", getFace("1", "2"), 1},
+                                                  {"/other", getFace("1", "2"), 1}}));
+
+  // routes are installed immediately
+  BOOST_CHECK_EQUAL(getNode("1")->GetObject<L3Protocol>()->getForwarder()->getFib().size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(BulkManagement)
+{
+  BOOST_CHECK(FibHelper::AddRoutes(getNode("1"), {{"/prefix", getFace("1", "2"), 1}}, true));
+}
+
 BOOST_AUTO_TEST_SUITE_END() // AddRoute
 
+BOOST_FIXTURE_TEST_CASE(AddRoutesRejected, ScenarioHelperWithCleanupFixture)
+{
+  createTopology({
+      {"1", "2"}
+    });
+
+  nfd::Fib& fib = getNode("1")->GetObject<L3Protocol>()->getForwarder()->getFib();
+  size_t nEntries = fib.size();
+
+  // face of another node
+  BOOST_CHECK(!FibHelper::AddRoutes(getNode("1"), {{"/prefix", getFace("1", "2"), 1},
+                                                   {"/other", getFace("2", "1"), 1}}));
+  // negative metric
+  BOOST_CHECK(!FibHelper::AddRoutes(getNode("1"), {{"/prefix", getFace("1", "2"), 1},
+                                                   {"/other", getFace("1", "2"), -1}}));
+
+  BOOST_CHECK_EQUAL(fib.size(), nEntries);
+}
+
+BOOST_FIXTURE_TEST_CASE(HeadlessRemovedFace, ScenarioHelperWithCleanupFixture)
+{
+  disableManagement();
+
+  createTopology({
+      {"1", "2"}
+    });
+
+  Ptr<L3Protocol> l3 = getNode("1")->GetObject<L3Protocol>();
+  shared_ptr<Face> face = getFace("1", "2");
+  FibHelper::AddRoute(getNode("1"), "/prefix", face, 1);
+  BOOST_CHECK(l3->getForwarder()->getFib().findExactMatch("/prefix") != nullptr);
+
+  l3->removeFace(face);
+  BOOST_CHECK(l3->getForwarder()->getFib().findExactMatch("/prefix") == nullptr);
+
+  // the face no longer belongs to the node, the helper ignores it
+  FibHelper::AddRoute(getNode("1"), "/prefix", face, 1);
+  BOOST_CHECK(l3->getForwarder()->getFib().findExactMatch("/prefix") == nullptr);
+  FibHelper::RemoveRoute(getNode("1"), "/prefix", face);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // HelperNdnFibHelper
 
 } // namespace ndn
@@ -22,6 +22,8 @@
 
 #include "../tests-common.hpp"
 
+#include <tuple>
+
 namespace ns3 {
 namespace ndn {
 
@@ -148,6 +150,64 @@ BOOST_AUTO_TEST_CASE(SixNodeTopology) // Bug #2783
   Simulator::Run();
 }
 
+BOOST_AUTO_TEST_CASE(LinkStateListener)
+{
+  createTopology({
+      {"1", "2"},
+    });
+
+  std::vector<std::tuple<Ptr<Node>, Ptr<Node>, bool>> changes;
+  LinkControlHelper::AddLinkStateListener([&] (Ptr<Node> node1, Ptr<Node> node2, bool isUp) {
+      changes.push_back(std::make_tuple(node1, node2, isUp));
+    });
+
+  Simulator::Schedule(Seconds(1.0), ndn::LinkControlHelper::FailLink, getNode("1"), getNode("2"));
+  Simulator::Schedule(Seconds(2.0), ndn::LinkControlHelper::UpLink, getNode("2"), getNode("1"));
+
+  Simulator::Stop(Seconds(3.0));
+  Simulator::Run();
+
+  LinkControlHelper::RemoveLinkStateListeners();
+
+  BOOST_REQUIRE_EQUAL(changes.size(), 2);
+  BOOST_CHECK(std::get<0>(changes[0]) == getNode("1"));
+  BOOST_CHECK(std::get<1>(changes[0]) == getNode("2"));
+  BOOST_CHECK_EQUAL(std::get<2>(changes[0]), false);
+  BOOST_CHECK(std::get<0>(changes[1]) == getNode("2"));
+  BOOST_CHECK(std::get<1>(changes[1]) == getNode("1"));
+  BOOST_CHECK_EQUAL(std::get<2>(changes[1]), true);
+}
+
+BOOST_AUTO_TEST_CASE(RemoveLinkStateListener)
+{
+  createTopology({
+      {"1", "2"},
+    });
+
+  size_t nChanges1 = 0;
+  size_t nChanges2 = 0;
+  LinkControlHelper::LinkStateListenerId id1 =
+    LinkControlHelper::AddLinkStateListener([&] (Ptr<Node>, Ptr<Node>, bool) { ++nChanges1; });
+  LinkControlHelper::LinkStateListenerId id2 =
+    LinkControlHelper::AddLinkStateListener([&] (Ptr<Node>, Ptr<Node>, bool) { ++nChanges2; });
+  BOOST_CHECK_NE(id1, id2);
+
+  LinkControlHelper::FailLink(getNode("1"), getNode("2"));
+  LinkControlHelper::RemoveLinkStateListener(id1);
+  LinkControlHelper::UpLink(getNode("1"), getNode("2"));
+
+  // removing twice, or an unknown id, has no effect
+  LinkControlHelper::RemoveLinkStateListener(id1);
+  LinkControlHelper::RemoveLinkStateListener(0);
+  LinkControlHelper::FailLink(getNode("1"), getNode("2"));
+
+  LinkControlHelper::RemoveLinkStateListener(id2);
+  LinkControlHelper::UpLink(getNode("1"), getNode("2"));
+
+  BOOST_CHECK_EQUAL(nChanges1, 1);
+  BOOST_CHECK_EQUAL(nChanges2, 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
@@ -24,11 +24,18 @@
 #include <ndn-cxx/interest.hpp>
 #include <ndn-cxx/data.hpp>
 
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <chrono>
+
 #include "../tests-common.hpp"
 
 namespace ns3 {
 namespace ndn {
 
+namespace io = boost::iostreams;
+
 BOOST_FIXTURE_TEST_SUITE(ModelNdnHeader, CleanupFixture)
 
 BOOST_AUTO_TEST_CASE(TypeId)
@@ -47,6 +54,92 @@ BOOST_AUTO_TEST_CASE(TypeId)
  BOOST_CHECK_EQUAL(dataPktHeader.GetSerializedSize(), 1354); // 328 + 1024
 }
 
+BOOST_AUTO_TEST_CASE(DeserializeTruncated)
+{
+  auto data = make_shared<ndn::Data>("/prefix");
+  data->setContent(std::make_shared< ::ndn::Buffer>(1024));
+  ndn::StackHelper::getKeyChain().sign(*data);
+  PacketHeader<Data> header(*data);
+
+  ns3::Buffer buffer;
+  buffer.AddAtStart(header.GetSerializedSize());
+  header.Serialize(buffer.Begin());
+  buffer.RemoveAtEnd(100);
+
+  PacketHeader<Data> decoded;
+  BOOST_CHECK_THROW(decoded.Deserialize(buffer.Begin()), ::ndn::tlv::Error);
+}
+
+// octet-by-octet stream decoding, as PacketHeader::Deserialize used to do
+class Ns3BufferIteratorSource : public io::source {
+public:
+  Ns3BufferIteratorSource(ns3::Buffer::Iterator& is)
+    : m_is(is)
+  {
+  }
+
+  std::streamsize
+  read(char* buf, std::streamsize nMaxRead)
+  {
+    std::streamsize i = 0;
+    for (; i < nMaxRead && !m_is.IsEnd(); ++i) {
+      buf[i] = m_is.ReadU8();
+    }
+    if (i == 0) {
+      return -1;
+    }
+    else {
+      return i;
+    }
+  }
+
+private:
+  ns3::Buffer::Iterator& m_is;
+};
+
+BOOST_AUTO_TEST_CASE(DeserializeBenchmark)
+{
+  const int N_ITERATIONS = 2000;
+
+  for (size_t payloadSize : {1024, 2048, 4096, 8192}) {
+    auto data = make_shared<ndn::Data>("/prefix/benchmark");
+    data->setContent(std::make_shared< ::ndn::Buffer>(payloadSize));
+    ndn::StackHelper::getKeyChain().sign(*data);
+    PacketHeader<Data> header(*data);
+
+    ns3::Buffer buffer;
+    buffer.AddAtStart(header.GetSerializedSize());
+    header.Serialize(buffer.Begin());
+
+    auto startStream = std::chrono::steady_clock::now();
+    for (int i = 0; i < N_ITERATIONS; ++i) {
+      ns3::Buffer::Iterator start = buffer.Begin();
+      io::stream<Ns3BufferIteratorSource> is(start);
+      Data decoded;
+      decoded.wireDecode(::ndn::Block::fromStream(is));
+    }
+    auto startBulk = std::chrono::steady_clock::now();
+    for (int i = 0; i < N_ITERATIONS; ++i) {
+      PacketHeader<Data> decoded;
+      BOOST_REQUIRE_EQUAL(decoded.Deserialize(buffer.Begin()), header.GetSerializedSize());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    PacketHeader<Data> decoded;
+    decoded.Deserialize(buffer.Begin());
+    BOOST_CHECK_EQUAL(*decoded.getPacket(), *data);
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    double streamTime = duration_cast<microseconds>(startBulk - startStream).count();
+    double bulkTime = duration_cast<microseconds>(end - startBulk).count();
+    BOOST_TEST_MESSAGE("Data " << payloadSize << " bytes: stream "
+                       << streamTime / N_ITERATIONS << " us, bulk "
+                       << bulkTime / N_ITERATIONS << " us per decode ("
+                       << streamTime / std::max(bulkTime, 1.0) << "x)");
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
@@ -19,9 +19,12 @@
 
 #include "helper/ndn-scenario-helper.hpp"
 #include "helper/ndn-app-helper.hpp"
+#include "model/ndn-face-counter-table.hpp"
 
 #include <ndn-cxx/face.hpp>
 
+#include <boost/property_tree/ptree.hpp>
+
 #include "../tests-common.hpp"
 
 namespace ns3 {
@@ -147,8 +150,242 @@ BOOST_AUTO_TEST_CASE(DisabledForwarderStatusManager)
                                 receivedDatasets.begin(), receivedDatasets.end());
 }
 
+BOOST_AUTO_TEST_CASE(DisabledManagement)
+{
+  disableManagement();
+
+  setupAndRun();
+
+  BOOST_CHECK_EQUAL(receivedDatasets.size(), 0);
+
+  Ptr<L3Protocol> l3 = getNode("1")->GetObject<L3Protocol>();
+  BOOST_CHECK(l3->isManagementDisabled());
+  BOOST_CHECK(l3->getFibManager() == nullptr);
+  BOOST_CHECK(l3->getStrategyChoiceManager() == nullptr);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // ManagerCheck
 
+BOOST_AUTO_TEST_CASE(HeadlessDataPlane)
+{
+  disableManagement();
+
+  createTopology({
+      {"A", "B"},
+      {"A", "C"}
+    });
+
+  addRoutes({
+      {"A", "B", "/prefix", 200},
+      {"A", "C", "/prefix", 100}
+    });
+
+  addApps({
+      {"A", "ns3::ndn::ConsumerCbr",
+          {{"Prefix", "/prefix"}, {"Frequency", "1"}},
+          "0s", "100s"},
+      {"B", "ns3::ndn::Producer",
+          {{"Prefix", "/prefix"}, {"PayloadSize", "100"}},
+          "0s", "100s"}
+    });
+
+  Ptr<L3Protocol> l3 = getNode("A")->GetObject<L3Protocol>();
+  BOOST_CHECK(l3->setStrategy("/prefix", "/localhost/nfd/strategy/multicast"));
+  BOOST_CHECK(!l3->setStrategy("/prefix", "/localhost/nfd/strategy/unknown"));
+
+  Simulator::Stop(Seconds(5.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("A", "B")->getCounters().nOutInterests, 5);
+  BOOST_CHECK_EQUAL(getFace("A", "C")->getCounters().nOutInterests, 5);
+  BOOST_CHECK_EQUAL(getFace("A", "B")->getCounters().nInData, 5);
+
+  l3->removeRoute("/prefix", getFace("A", "B"));
+  l3->removeRoute("/prefix", getFace("A", "C"));
+  BOOST_CHECK(l3->getForwarder()->getFib().findExactMatch("/prefix") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(FaceByNetDevice)
+{
+  createTopology({
+      {"A", "B"},
+      {"A", "C"}
+    });
+
+  Ptr<Node> node = getNode("A");
+  Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+  BOOST_REQUIRE_EQUAL(node->GetNDevices(), 2);
+
+  shared_ptr<Face> face = l3->getFaceByNetDevice(node->GetDevice(0));
+  BOOST_REQUIRE(face != nullptr);
+  BOOST_CHECK(l3->getFaceByNetDevice(node->GetDevice(1)) != nullptr);
+  BOOST_CHECK(l3->getFaceByNetDevice(node->GetDevice(1)) != face);
+  BOOST_CHECK(l3->getFaceByNetDevice(getNode("B")->GetDevice(0)) == nullptr);
+
+  l3->removeFace(face);
+  BOOST_CHECK(l3->getFaceByNetDevice(node->GetDevice(0)) == nullptr);
+  BOOST_CHECK(l3->getFaceByNetDevice(node->GetDevice(1)) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(FaceCounters)
+{
+  createTopology({
+      {"A", "B"}
+    });
+
+  addRoutes({
+      {"A", "B", "/prefix", 1}
+    });
+
+  addApps({
+      {"A", "ns3::ndn::ConsumerCbr",
+          {{"Prefix", "/prefix"}, {"Frequency", "1"}},
+          "0s", "100s"},
+      {"B", "ns3::ndn::Producer",
+          {{"Prefix", "/prefix"}, {"PayloadSize", "100"}},
+          "0s", "100s"}
+    });
+
+  Ptr<L3Protocol> l3 = getNode("A")->GetObject<L3Protocol>();
+  BOOST_CHECK(l3->getFaceCounters() == nullptr);
+  l3->enableFaceCounters();
+  BOOST_REQUIRE(l3->getFaceCounters() != nullptr);
+
+  Simulator::Stop(Seconds(2.5));
+  Simulator::Run();
+
+  FaceCounterTable snapshot = *l3->getFaceCounters();
+
+  Simulator::Stop(Seconds(2.5));
+  Simulator::Run();
+
+  const FaceCounterTable& counters = *l3->getFaceCounters();
+  nfd::FaceId faceId = getFace("A", "B")->getId();
+  BOOST_CHECK_EQUAL(counters.getPackets(FaceCounterTable::OUT_INTERESTS, faceId),
+                    getFace("A", "B")->getCounters().nOutInterests);
+  BOOST_CHECK_EQUAL(counters.getPackets(FaceCounterTable::IN_DATA, faceId),
+                    getFace("A", "B")->getCounters().nInData);
+  BOOST_CHECK_EQUAL(counters.getPackets(FaceCounterTable::OUT_SATISFIED_INTERESTS, faceId), 5);
+  BOOST_CHECK_EQUAL(counters.getNodeTotal(FaceCounterTable::IN_SATISFIED_INTERESTS), 5);
+  BOOST_CHECK_GT(counters.getBytes(FaceCounterTable::IN_DATA, faceId), 5 * 100);
+
+  FaceCounterTable delta = counters.diff(snapshot);
+  BOOST_CHECK_EQUAL(delta.getPackets(FaceCounterTable::OUT_INTERESTS, faceId), 2);
+  BOOST_CHECK_EQUAL(delta.getPackets(FaceCounterTable::IN_DATA, faceId), 2);
+}
+
+class InterestSink
+{
+public:
+  void
+  OnInterest(const Interest& interest, const Face& face)
+  {
+    ++nInterests;
+  }
+
+public:
+  size_t nInterests = 0;
+};
+
+BOOST_AUTO_TEST_CASE(TraceSinks)
+{
+  createTopology({
+      {"A", "B"}
+    });
+
+  addRoutes({
+      {"A", "B", "/prefix", 1}
+    });
+
+  addApps({
+      {"A", "ns3::ndn::ConsumerCbr",
+          {{"Prefix", "/prefix"}, {"Frequency", "1"}},
+          "0s", "100s"},
+      {"B", "ns3::ndn::Producer",
+          {{"Prefix", "/prefix"}, {"PayloadSize", "100"}},
+          "0s", "100s"}
+    });
+
+  Ptr<L3Protocol> l3 = getNode("B")->GetObject<L3Protocol>();
+  nfd::FaceId faceId = getFace("B", "A")->getId();
+  BOOST_CHECK(!l3->isFaceTraced(faceId));
+
+  // sinks connected after the faces are created receive events
+  InterestSink sink1;
+  InterestSink sink2;
+  auto callback1 = MakeCallback(&InterestSink::OnInterest, &sink1);
+  auto callback2 = MakeCallback(&InterestSink::OnInterest, &sink2);
+  BOOST_REQUIRE(l3->TraceConnectWithoutContext("InInterests", callback1));
+  BOOST_REQUIRE(l3->TraceConnectWithoutContext("InInterests", callback2));
+  BOOST_CHECK(l3->isFaceTraced(faceId));
+
+  Simulator::Stop(Seconds(2.5));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(sink1.nInterests, 3);
+  BOOST_CHECK_EQUAL(sink2.nInterests, 3);
+
+  // face signals stay connected until the last sink is disconnected
+  BOOST_REQUIRE(l3->TraceDisconnectWithoutContext("InInterests", callback1));
+  BOOST_CHECK(l3->isFaceTraced(faceId));
+  BOOST_REQUIRE(l3->TraceDisconnectWithoutContext("InInterests", callback2));
+  BOOST_CHECK(!l3->isFaceTraced(faceId));
+
+  Simulator::Stop(Seconds(2.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(sink1.nInterests, 3);
+  BOOST_CHECK_EQUAL(sink2.nInterests, 3);
+  BOOST_CHECK_EQUAL(getFace("B", "A")->getCounters().nInInterests, 5);
+}
+
+BOOST_AUTO_TEST_CASE(ConfigValues)
+{
+  Ptr<L3Protocol> l3a = CreateObject<L3Protocol>();
+  Ptr<L3Protocol> l3b = CreateObject<L3Protocol>();
+
+  // values come from the shared default config until overridden
+  BOOST_CHECK_EQUAL(l3a->getConfigValue("tables.cs_max_packets"), "100");
+  BOOST_CHECK_EQUAL(l3a->getConfigValue("ndnSIM.disable_management"), "");
+  BOOST_CHECK_EQUAL(l3a->getConfigValue("ndnSIM.disable_management", "false"), "false");
+
+  l3a->setConfigValue("tables.cs_max_packets", "42");
+  l3a->setConfigValue("ndnSIM.disable_management", "true");
+  BOOST_CHECK_EQUAL(l3a->getConfigValue("tables.cs_max_packets"), "42");
+  BOOST_CHECK_EQUAL(l3a->getConfigValue("ndnSIM.disable_management", "false"), "true");
+  BOOST_CHECK(l3a->isManagementDisabled());
+
+  // overrides of one node do not leak into the shared default config
+  BOOST_CHECK_EQUAL(l3b->getConfigValue("tables.cs_max_packets"), "100");
+  BOOST_CHECK(!l3b->isManagementDisabled());
+}
+
+BOOST_AUTO_TEST_CASE(PrivateConfig)
+{
+  Ptr<L3Protocol> l3a = CreateObject<L3Protocol>();
+  Ptr<L3Protocol> l3b = CreateObject<L3Protocol>();
+
+  l3a->setConfigValue("tables.cs_max_packets", "42");
+
+  // the private copy contains the default config with the values set before
+  nfd::ConfigSection& config = l3a->getConfig();
+  BOOST_CHECK_EQUAL(config.get<std::string>("tables.cs_max_packets"), "42");
+  BOOST_CHECK_EQUAL(config.get<std::string>("tables.strategy_choice./"),
+                    "/localhost/nfd/strategy/best-route");
+  BOOST_CHECK(&l3a->getConfig() == &config);
+
+  // from then on, the private copy is read and updated
+  config.put("tables.cs_max_packets", "7");
+  BOOST_CHECK_EQUAL(l3a->getConfigValue("tables.cs_max_packets"), "7");
+  l3a->setConfigValue("ndnSIM.disable_management", "true");
+  BOOST_CHECK_EQUAL(config.get<std::string>("ndnSIM.disable_management"), "true");
+  BOOST_CHECK(l3a->isManagementDisabled());
+
+  BOOST_CHECK_EQUAL(l3b->getConfigValue("tables.cs_max_packets"), "100");
+  BOOST_CHECK(!l3b->isManagementDisabled());
+  BOOST_CHECK(!l3b->getConfig().get_optional<std::string>("ndnSIM.disable_management"));
+}
+
 BOOST_AUTO_TEST_SUITE_END() // ModelNdnL3Protocol
 
 } // namespace ndn
@@ -19,9 +19,20 @@
 
 
 #include "model/ndn-net-device-link-service.hpp"
+#include "model/ndn-l3-protocol.hpp"
+#include "helper/ndn-stack-helper.hpp"
+#include "apps/ndn-app.hpp"
+
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/queue.h"
+
+#include <ndn-cxx/lp/packet.hpp>
+#include <ndn-cxx/lp/fields.hpp>
 
 #include "../tests-common.hpp"
 
+#include <tuple>
+
 namespace ns3 {
 namespace ndn {
 
@@ -139,6 +150,372 @@ BOOST_FIXTURE_TEST_CASE(Basic, FixtureWithTracers)
   BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(getFace("2", "1")->getRemoteUri()), "netdev://[00:00:00:ff:ff:01]");
 }
 
+BOOST_FIXTURE_TEST_CASE(SharedPackets, FixtureWithTracers)
+{
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+  Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("20"));
+
+  createTopology({
+      {"1", "2"},
+      {"2", "3"},
+    }, false);
+
+  getStackHelper().enableSharedPackets();
+  getStackHelper().InstallAll();
+
+  addRoutes({
+      {"1", "2", "/prefix", 1},
+      {"2", "3", "/prefix", 1},
+    });
+
+  addApps({
+      {"1", "ns3::ndn::ConsumerCbr",
+          {{"Prefix", "/prefix"}, {"Frequency", "10"}},
+          "0s", "9.99s"},
+      {"3", "ns3::ndn::Producer",
+          {{"Prefix", "/prefix"}, {"PayloadSize", "1024"}},
+          "0s", "100s"}
+    });
+
+  auto linkService = dynamic_cast<NetDeviceLinkService*>(getFace("1", "2")->getLinkService());
+  BOOST_REQUIRE(linkService != nullptr);
+  BOOST_CHECK(linkService->isSharedPacketEnabled());
+
+  Simulator::Stop(Seconds(20.001));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("1", "2")->getCounters().nOutInterests, 100);
+  BOOST_CHECK_EQUAL(getFace("1", "2")->getCounters().nInData, 100);
+  BOOST_CHECK_EQUAL(getFace("2", "3")->getCounters().nOutInterests, 100);
+  BOOST_CHECK_EQUAL(getFace("2", "3")->getCounters().nInData, 100);
+  BOOST_CHECK_EQUAL(getFace("3", "2")->getCounters().nInInterests, 100);
+  BOOST_CHECK_EQUAL(getFace("3", "2")->getCounters().nOutData, 100);
+}
+
+class HopCountFixture : public ScenarioHelperWithCleanupFixture
+{
+public:
+  void
+  DataReceived(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount)
+  {
+    hopCounts[Names::FindName(app->GetNode())].push_back(hopCount);
+  }
+
+public:
+  std::map<std::string, std::vector<int32_t>> hopCounts;
+};
+
+BOOST_FIXTURE_TEST_CASE(SharedPacketsHopCount, HopCountFixture)
+{
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+  Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("20"));
+
+  // the router caches Data from the producer, so the second consumer is served from its
+  // content store with the same Data object that the router also sent to the first consumer
+  createTopology({
+      {"C1", "R"},
+      {"C2", "R"},
+      {"R", "P"},
+    }, false);
+
+  getStackHelper().enableSharedPackets();
+  getStackHelper().InstallAll();
+
+  addRoutes({
+      {"C1", "R", "/prefix", 1},
+      {"C2", "R", "/prefix", 1},
+      {"R", "P", "/prefix", 1},
+    });
+
+  addApps({
+      {"C1", "ns3::ndn::ConsumerCbr",
+          {{"Prefix", "/prefix"}, {"Frequency", "1"}},
+          "0s", "4.99s"},
+      {"C2", "ns3::ndn::ConsumerCbr",
+          {{"Prefix", "/prefix"}, {"Frequency", "1"}},
+          "0.5s", "5.49s"},
+      {"P", "ns3::ndn::Producer",
+          {{"Prefix", "/prefix"}, {"PayloadSize", "1024"}},
+          "0s", "100s"}
+    });
+
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::Consumer/LastRetransmittedInterestDataDelay",
+                                MakeCallback(&HopCountFixture::DataReceived, this));
+
+  Simulator::Stop(Seconds(10.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("R", "P")->getCounters().nOutInterests, 5);
+  BOOST_CHECK_EQUAL(getFace("R", "C2")->getCounters().nOutData, 5);
+
+  // tags set by one receiver are not seen by the others: every Data travelled two links
+  const std::vector<int32_t> expected(5, 2);
+  BOOST_CHECK_EQUAL_COLLECTIONS(hopCounts["C1"].begin(), hopCounts["C1"].end(),
+                                expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(hopCounts["C2"].begin(), hopCounts["C2"].end(),
+                                expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(Fragmentation, FixtureWithTracers)
+{
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+  Config::SetDefault("ns3::PointToPointNetDevice::Mtu", UintegerValue(1500));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+  Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("100"));
+
+  createTopology({
+      {"1", "2"},
+      {"2", "3"},
+    });
+
+  addRoutes({
+      {"1", "2", "/prefix", 1},
+      {"2", "3", "/prefix", 1},
+    });
+
+  addApps({
+      {"1", "ns3::ndn::ConsumerCbr",
+          {{"Prefix", "/prefix"}, {"Frequency", "10"}},
+          "0s", "9.99s"},
+      {"3", "ns3::ndn::Producer",
+          {{"Prefix", "/prefix"}, {"PayloadSize", "5000"}},
+          "0s", "100s"}
+    });
+
+  Simulator::Stop(Seconds(20.001));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("3", "2")->getCounters().nOutData, 100);
+  BOOST_CHECK_EQUAL(getFace("2", "3")->getCounters().nInData, 100);
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nOutData, 100);
+  BOOST_CHECK_EQUAL(getFace("1", "2")->getCounters().nInData, 100);
+}
+
+class FragmentFixture : public ScenarioHelperWithCleanupFixture
+{
+public:
+  FragmentFixture()
+  {
+    Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+    Config::SetDefault("ns3::PointToPointNetDevice::Mtu", UintegerValue(1500));
+    Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("100"));
+
+    createTopology({
+        {"1", "2"},
+      });
+
+    data = make_shared<Data>(Name("/prefix/data"));
+    std::vector<uint8_t> content(5000);
+    data->setContent(content.data(), content.size());
+    StackHelper::getKeyChain().sign(*data);
+
+    bool isOk = false;
+    std::tie(isOk, fragments) = nfd::face::LpFragmenter().fragmentPacket(lp::Packet(data->wireEncode()),
+                                                                         1500);
+    BOOST_REQUIRE(isOk);
+    BOOST_REQUIRE_EQUAL(fragments.size(), 4);
+    for (size_t i = 0; i < fragments.size(); ++i) {
+      fragments[i].add<lp::SequenceField>(1000 + i);
+    }
+
+    receiver = dynamic_cast<NetDeviceLinkService*>(getFace("2", "1")->getLinkService());
+    BOOST_REQUIRE(receiver != nullptr);
+  }
+
+  /// \brief send fragments with \p indices from node 1 directly on its NetDevice
+  void
+  sendFragments(std::vector<size_t> indices)
+  {
+    for (size_t index : indices) {
+      sendFragment(fragments.at(index));
+    }
+  }
+
+  /// \brief send the first fragment of \p nPackets other packets, each starts a partial packet
+  void
+  sendFirstFragments(size_t nPackets)
+  {
+    for (size_t i = 1; i <= nPackets; ++i) {
+      lp::Packet fragment = fragments.front();
+      fragment.set<lp::SequenceField>(1000 + i * fragments.size());
+      sendFragment(fragment);
+    }
+  }
+
+  void
+  sendFragment(const lp::Packet& fragment)
+  {
+    Ptr<NetDevice> device = getNetDevice("1", "2");
+    Block wire = fragment.wireEncode();
+    device->Send(Create<Packet>(wire.wire(), wire.size()), device->GetBroadcast(),
+                 L3Protocol::ETHERNET_FRAME_TYPE);
+  }
+
+public:
+  shared_ptr<Data> data;
+  std::vector<lp::Packet> fragments;
+  NetDeviceLinkService* receiver;
+};
+
+BOOST_FIXTURE_TEST_SUITE(Reassembly, FragmentFixture)
+
+BOOST_AUTO_TEST_CASE(OutOfOrder)
+{
+  Simulator::Schedule(Seconds(0.1), &FragmentFixture::sendFragments, this,
+                      std::vector<size_t>{3, 1, 0, 2});
+
+  Simulator::Stop(Seconds(1.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 1);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Duplicates)
+{
+  Simulator::Schedule(Seconds(0.1), &FragmentFixture::sendFragments, this,
+                      std::vector<size_t>{0, 0, 1, 2, 1, 3});
+  // fragments of a reassembled packet start a new partial packet, which times out
+  Simulator::Schedule(Seconds(0.2), &FragmentFixture::sendFragments, this,
+                      std::vector<size_t>{3});
+
+  Simulator::Stop(Seconds(0.3));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 1);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 1);
+
+  Simulator::Stop(Seconds(1.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 1);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LostFragmentAndTimeout)
+{
+  NetDeviceLinkService::Options options = receiver->getOptions();
+  options.reassemblerOptions.reassemblyTimeout = time::milliseconds(200);
+  receiver->setOptions(options);
+
+  // fragment 2 is lost
+  Simulator::Schedule(Seconds(0.1), &FragmentFixture::sendFragments, this,
+                      std::vector<size_t>{0, 1, 3});
+
+  Simulator::Stop(Seconds(0.25));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 0);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 1);
+
+  // after the timeout the partial packet is dropped and the late fragment starts a new one
+  Simulator::Schedule(Seconds(0.25), &FragmentFixture::sendFragments, this,
+                      std::vector<size_t>{2});
+
+  Simulator::Stop(Seconds(0.3));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 0);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 1);
+
+  Simulator::Stop(Seconds(1.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 0);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TooManyFragments)
+{
+  // the receiver does not buffer packets of more fragments than it allows
+  NetDeviceLinkService::Options options = receiver->getOptions();
+  options.reassemblerOptions.nMaxFragments = 3;
+  receiver->setOptions(options);
+
+  Simulator::Schedule(Seconds(0.1), &FragmentFixture::sendFragments, this,
+                      std::vector<size_t>{0, 1, 2, 3});
+
+  Simulator::Stop(Seconds(1.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 0);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 0);
+
+  // the sender does not send them
+  auto sender = dynamic_cast<NetDeviceLinkService*>(getFace("1", "2")->getLinkService());
+  BOOST_REQUIRE(sender != nullptr);
+  options = sender->getOptions();
+  options.fragmenterOptions.nMaxFragments = 3;
+  sender->setOptions(options);
+
+  getFace("1", "2")->sendData(*data);
+
+  Simulator::Stop(Seconds(1.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 0);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TooManyPartialPackets)
+{
+  NetDeviceLinkService::Options options = receiver->getOptions();
+  options.nMaxPartialPackets = 2;
+  receiver->setOptions(options);
+
+  Simulator::Schedule(Seconds(0.1), &FragmentFixture::sendFragments, this,
+                      std::vector<size_t>{0, 1});
+  // the second of these packets exceeds the limit and is not buffered
+  Simulator::Schedule(Seconds(0.1), &FragmentFixture::sendFirstFragments, this, 2);
+
+  Simulator::Stop(Seconds(0.2));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 0);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 2);
+
+  // fragments of a buffered packet are accepted at the limit
+  Simulator::Schedule(Seconds(0.1), &FragmentFixture::sendFragments, this,
+                      std::vector<size_t>{2, 3});
+
+  Simulator::Stop(Seconds(0.2));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 1);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 1);
+
+  // the remaining partial packet times out
+  Simulator::Stop(Seconds(1.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FragmentationDisabled)
+{
+  auto sender = dynamic_cast<NetDeviceLinkService*>(getFace("1", "2")->getLinkService());
+  BOOST_REQUIRE(sender != nullptr);
+  NetDeviceLinkService::Options options = sender->getOptions();
+  options.allowFragmentation = false;
+  sender->setOptions(options);
+
+  // a packet larger than the MTU is dropped by the sender
+  getFace("1", "2")->sendData(*data);
+
+  Simulator::Stop(Seconds(1.0));
+  Simulator::Run();
+
+  Ptr<PointToPointNetDevice> device = DynamicCast<PointToPointNetDevice>(getNetDevice("1", "2"));
+  BOOST_REQUIRE(device != nullptr);
+  BOOST_CHECK_EQUAL(device->GetQueue()->GetTotalReceivedPackets(), 0);
+  BOOST_CHECK_EQUAL(getFace("2", "1")->getCounters().nInData, 0);
+  BOOST_CHECK_EQUAL(receiver->getNPartialPackets(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // Reassembly
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
@@ -21,6 +21,7 @@
 #include "helper/ndn-stack-helper.hpp"
 #include "model/ndn-header.hpp"
 #include "utils/ndn-ns3-packet-tag.hpp"
+#include "utils/ndn-fw-hop-count-tag.hpp"
 
 #include <ndn-cxx/encoding/block.hpp>
 #include <ndn-cxx/interest.hpp>
@@ -54,6 +55,32 @@ BOOST_AUTO_TEST_CASE(ToPacket)
   BOOST_CHECK_EQUAL(type2, ::ndn::tlv::Data);
 }
 
+BOOST_AUTO_TEST_CASE(ToPacketAfterFromPacket)
+{
+  auto data = std::make_shared<ndn::Data>("/prefix");
+  data->setContent(std::make_shared< ::ndn::Buffer>(1024));
+  ndn::StackHelper::getKeyChain().sign(*data);
+
+  Ptr<Packet> received = Convert::ToPacket(*data);
+  FwHopCountTag hopCountTag;
+  hopCountTag.Increment();
+  hopCountTag.Increment();
+  received->AddPacketTag(hopCountTag);
+
+  shared_ptr<const Data> decoded = Convert::FromPacket<Data>(received);
+  BOOST_CHECK_EQUAL(*decoded, *data);
+  // the packet is neither modified nor kept alive by the decoded Data
+  BOOST_CHECK_EQUAL(received->GetSize(), data->wireEncode().size());
+  BOOST_CHECK_EQUAL(received->GetReferenceCount(), 1);
+
+  Ptr<Packet> forwarded = Convert::ToPacket(*decoded);
+  BOOST_CHECK_EQUAL(forwarded->GetSize(), data->wireEncode().size());
+
+  FwHopCountTag forwardedHopCountTag;
+  BOOST_REQUIRE(forwarded->PeekPacketTag(forwardedHopCountTag));
+  BOOST_CHECK_EQUAL(forwardedHopCountTag.Get(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/ndn-binary-log.hpp"
+
+#include "../tests-common.hpp"
+
+#include <cstdio>
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_FIXTURE_TEST_SUITE(UtilsNdnBinaryLog, CleanupFixture)
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  const std::string file = "ndn-binary-log-test.bin";
+  BOOST_REQUIRE(BinaryLog::Instance().Open(file));
+
+  static BinaryLog::Site debugSite = {"ndn.Test", LOG_DEBUG, "Run", 0};
+  static BinaryLog::Site functionSite = {"ndn.Other", LOG_FUNCTION, "Send", 0};
+
+  char buffer[8] = "buf";
+  for (int i = 0; i < 3; ++i) {
+    BinaryLog::Record(debugSite) << "value " << i << " of " << 3u << ", rate " << 0.5 << ' '
+                                 << std::string("text") << " " << buffer << " " << -7L;
+    BinaryLog::Record(functionSite, true) << "a" << 42;
+  }
+  BinaryLog::Record(functionSite, true);
+
+  BinaryLog::Instance().Close();
+
+  std::ifstream is(file.c_str(), std::ios_base::binary);
+  std::ostringstream os;
+  BOOST_REQUIRE(BinaryLog::Decode(is, os));
+  std::remove(file.c_str());
+
+  std::string expected;
+  for (int i = 0; i < 3; ++i) {
+    expected += "+0.000000000s -1 ndn.Test:Run(): [DEBUG] value " + std::to_string(i) +
+                " of 3, rate 0.5 text buf -7\n";
+    expected += "+0.000000000s -1 ndn.Other:Send(a, 42)\n";
+  }
+  expected += "+0.000000000s -1 ndn.Other:Send()\n";
+  BOOST_CHECK_EQUAL(os.str(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(InterleavedComponents)
+{
+  const std::string file = "ndn-binary-log-test.bin";
+  BOOST_REQUIRE(BinaryLog::Instance().Open(file));
+
+  static BinaryLog::Site bulkSite = {"ndn.Bulk", LOG_INFO, "Send", 0};
+  static BinaryLog::Site rareSite = {"ndn.Rare", LOG_INFO, "Tick", 0};
+
+  // bulk records fill several chunks while the rare component still buffers its records
+  const std::string payload(1000, 'x');
+  std::string expected;
+  for (int i = 0; i < 300; ++i) {
+    BinaryLog::Record(bulkSite) << "bulk " << i << " " << payload;
+    expected += "+0.000000000s -1 ndn.Bulk:Send(): [INFO] bulk " + std::to_string(i) + " " +
+                payload + "\n";
+    if (i % 100 == 0) {
+      BinaryLog::Record(rareSite) << "rare " << i;
+      expected += "+0.000000000s -1 ndn.Rare:Tick(): [INFO] rare " + std::to_string(i) + "\n";
+    }
+  }
+
+  BinaryLog::Instance().Close();
+
+  std::ifstream is(file.c_str(), std::ios_base::binary);
+  std::ostringstream os;
+  BOOST_REQUIRE(BinaryLog::Decode(is, os));
+  std::remove(file.c_str());
+  BOOST_CHECK(os.str() == expected);
+}
+
+BOOST_AUTO_TEST_CASE(Reopen)
+{
+  const std::string file1 = "ndn-binary-log-test1.bin";
+  const std::string file2 = "ndn-binary-log-test2.bin";
+  static BinaryLog::Site site = {"ndn.Test", LOG_DEBUG, "Run", 0};
+
+  // literal ids cached by the call site stay valid in the next file
+  BOOST_REQUIRE(BinaryLog::Instance().Open(file1));
+  BinaryLog::Record(site) << "first " << 1;
+  BOOST_REQUIRE(BinaryLog::Instance().Open(file2));
+  BinaryLog::Record(site) << "first " << 2;
+  BinaryLog::Instance().Close();
+
+  for (const std::string& file : {file1, file2}) {
+    std::ifstream is(file.c_str(), std::ios_base::binary);
+    std::ostringstream os;
+    BOOST_REQUIRE(BinaryLog::Decode(is, os));
+    std::remove(file.c_str());
+
+    std::string value = file == file1 ? "1" : "2";
+    BOOST_CHECK_EQUAL(os.str(), "+0.000000000s -1 ndn.Test:Run(): [DEBUG] first " + value + "\n");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(NotALog)
+{
+  std::istringstream is("NS_LOG text");
+  std::ostringstream os;
+  BOOST_CHECK(!BinaryLog::Decode(is, os));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/topology/nlsr-conf-generator.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/info_parser.hpp>
+
+#include <fstream>
+#include <map>
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+const boost::filesystem::path TEST_CONF_DIR = boost::filesystem::path(TEST_CONFIG_PATH) / "nlsr-conf-generator";
+
+class NlsrConfGeneratorFixture : public CleanupFixture
+{
+public:
+  NlsrConfGeneratorFixture()
+    : generator(TEST_CONF_DIR.string(), "ls", "/home/test")
+  {
+    boost::filesystem::create_directories(TEST_CONF_DIR);
+  }
+
+  ~NlsrConfGeneratorFixture()
+  {
+    boost::filesystem::remove_all(TEST_CONF_DIR);
+  }
+
+  // Square 0-1-2-3 with chord 0-2.  Node 1 announces one edge more than it has, node 3 one
+  // edge less.
+  std::string
+  writeBriteFile() const
+  {
+    std::string file = (TEST_CONF_DIR / "topo.brite").string();
+    std::ofstream os(file.c_str());
+    os << "Topology: ( 4 Nodes, 5 Edges )\n"
+       << "Model (1 - RTWaxman):  4 100 100 1  2  0.15000000596046448 0.20000000298023224 1 1 10.0 1024.0\n"
+       << "\n"
+       << "Nodes: ( 4 )\n"
+       << "0 10.00 20.00 3 3 -1 RT_NODE\n"
+       << "1 30.00 40.00 3 3 -1 RT_NODE\n"
+       << "2 50.00 60.00 3 3 -1 RT_NODE\n"
+       << "3 70.00 80.00 1 1 -1 RT_NODE\n"
+       << "\n"
+       << "Edges: ( 5 )\n"
+       << "0 0 1 28.28 0.09 10.0 -1 -1 E_RT U\n"
+       << "1 1 2 28.28 0.09 10.0 -1 -1 E_RT U\n"
+       << "2 2 3 28.28 0.09 10.0 -1 -1 E_RT U\n"
+       << "3 3 0 84.85 0.28 10.0 -1 -1 E_RT U\n"
+       << "4 0 2 56.57 0.18 10.0 -1 -1 E_RT U\n";
+    return file;
+  }
+
+  NlsrConfGenerator::ConfigSection
+  readNodeConfig(const std::string& nodeId) const
+  {
+    NlsrConfGenerator::ConfigSection config;
+    boost::property_tree::read_info(generator.GetNodeConfigFileName(nodeId), config);
+    return config;
+  }
+
+  // Neighbor node ids of \p nodeId, in file order.
+  std::vector<std::string>
+  readNeighbors(const std::string& nodeId) const
+  {
+    NlsrConfGenerator::ConfigSection config = readNodeConfig(nodeId);
+    std::vector<std::string> neighbors;
+    for (const auto& entry : config.get_child("neighbors")) {
+      if (entry.first == "neighbor") {
+        neighbors.push_back(entry.second.get<std::string>("node-id"));
+      }
+    }
+    return neighbors;
+  }
+
+  // (node-id, nlsr-config) entries of nlsr_sim.conf.
+  std::vector<std::pair<std::string, std::string>>
+  readSimConfig() const
+  {
+    NlsrConfGenerator::ConfigSection sim;
+    boost::property_tree::read_info(generator.GetSimConfigFileName(), sim);
+
+    std::vector<std::pair<std::string, std::string>> nodes;
+    for (const auto& entry : sim) {
+      BOOST_CHECK_EQUAL(entry.first, "ndn-node");
+      nodes.push_back(std::make_pair(entry.second.get<std::string>("node-id"),
+                                     entry.second.get<std::string>("nlsr-config")));
+    }
+    return nodes;
+  }
+
+  void
+  checkBriteOutput() const
+  {
+    std::map<std::string, std::vector<std::string>> expected = {
+      {"N0", {"N1", "N3", "N2"}},
+      {"N1", {"N0", "N2"}},
+      {"N2", {"N1", "N3", "N0"}},
+      {"N3", {"N2", "N0"}}};
+
+    for (const auto& node : expected) {
+      std::vector<std::string> neighbors = readNeighbors(node.first);
+      BOOST_CHECK_EQUAL_COLLECTIONS(neighbors.begin(), neighbors.end(),
+                                    node.second.begin(), node.second.end());
+    }
+
+    NlsrConfGenerator::ConfigSection config = readNodeConfig("N2");
+    BOOST_CHECK_EQUAL(config.get<std::string>("general.node-id"), "N2");
+    BOOST_CHECK_EQUAL(config.get<std::string>("general.router"), "/%C1r2");
+    BOOST_CHECK_EQUAL(config.get<std::string>("general.log-dir"), "/home/test/log/N2/nlsr");
+    BOOST_CHECK_EQUAL(config.get<std::string>("hyperbolic.state"), "off");
+    BOOST_CHECK_EQUAL(config.get<std::string>("neighbors.neighbor.face-uri"),
+                      "tcp4://10.0.0.1:6363");
+
+    std::vector<std::pair<std::string, std::string>> sim = readSimConfig();
+    BOOST_REQUIRE_EQUAL(sim.size(), 4);
+    for (size_t i = 0; i < sim.size(); ++i) {
+      std::string nodeId = "N" + std::to_string(i);
+      BOOST_CHECK_EQUAL(sim[i].first, nodeId);
+      BOOST_CHECK_EQUAL(sim[i].second, generator.GetNodeConfigFileName(nodeId));
+    }
+  }
+
+public:
+  NlsrConfGenerator generator;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsTopologyNlsrConfGenerator, NlsrConfGeneratorFixture)
+
+BOOST_AUTO_TEST_CASE(Brite)
+{
+  BOOST_REQUIRE(generator.ProcessBriteTopology(writeBriteFile()));
+  checkBriteOutput();
+}
+
+BOOST_AUTO_TEST_CASE(BriteStreaming)
+{
+  std::string file = writeBriteFile();
+
+  BOOST_REQUIRE(generator.ProcessBriteTopology(file));
+  std::map<std::string, NlsrConfGenerator::ConfigSection> expected;
+  for (std::string nodeId : {"N0", "N1", "N2", "N3"}) {
+    expected[nodeId] = readNodeConfig(nodeId);
+    boost::filesystem::remove(generator.GetNodeConfigFileName(nodeId));
+  }
+  boost::filesystem::remove(generator.GetSimConfigFileName());
+
+  for (size_t nThreads : {1, 3}) {
+    BOOST_REQUIRE(generator.ProcessBriteTopologyStreaming(file, nThreads));
+    checkBriteOutput();
+    for (const auto& node : expected) {
+      BOOST_CHECK(readNodeConfig(node.first) == node.second);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Bulk)
+{
+  std::string file = (TEST_CONF_DIR / "bulk.conf").string();
+  {
+    std::ofstream os(file.c_str());
+    os << "ndn-routers\n"
+       << ";node-id city latitude longitude network site router ...\n";
+    for (std::string nodeId : {"rtrB", "rtrA", "rtrC"}) {
+      os << nodeId << " NA 3 1 /ndn /edu/" << nodeId << " /%C1.Router/" << nodeId
+         << " 1800 3600 4 INFO /log /seq 2 5 60 5 10 off 123.456 1.45 3 15 /p1/" << nodeId
+         << " /p2/" << nodeId << "\n";
+    }
+    os << "\n"
+       << "adjacency-matrix\n"
+       << ";src-node-id dst-node-id name face-uri link-cost bandwidth metric delay queue\n"
+       << "rtrA rtrB /ndn/rtrB tcp4://10.0.0.2:6363 25 100 1 0 1000\n"
+       << "rtrA rtrC /ndn/rtrC tcp4://10.0.0.3:6363 30 100 1 0 1000\n"
+       << "rtrB rtrA /ndn/rtrA tcp4://10.0.0.1:6363 25 100 1 0 1000\n"
+       << "rtrX rtrA /ndn/rtrA tcp4://10.0.0.1:6363 25 100 1 0 1000\n"
+       << ";comment\n"
+       << "rtrA rtrX /ndn/rtrX tcp4://10.0.0.9:6363 40 100 1 0 1000\n"
+       << "rtrC rtrA /ndn/rtrA tcp4://10.0.0.1:6363 30 100 1 5 1000";
+  }
+
+  BOOST_REQUIRE(generator.ProcessBulkConfig(file));
+
+  std::vector<std::string> neighborsA = readNeighbors("rtrA");
+  std::vector<std::string> expectedA = {"rtrB", "rtrC", "rtrX"};
+  BOOST_CHECK_EQUAL_COLLECTIONS(neighborsA.begin(), neighborsA.end(),
+                                expectedA.begin(), expectedA.end());
+
+  NlsrConfGenerator::ConfigSection configC = readNodeConfig("rtrC");
+  BOOST_CHECK_EQUAL(configC.get<std::string>("general.site"), "/edu/rtrC");
+  BOOST_CHECK_EQUAL(configC.get<std::string>("advertising.prefix"), "/p1/rtrC");
+  BOOST_CHECK_EQUAL(configC.get<std::string>("neighbors.neighbor.node-id"), "rtrA");
+  BOOST_CHECK_EQUAL(configC.get<std::string>("neighbors.neighbor.link-cost"), "30");
+  BOOST_CHECK_EQUAL(configC.get<std::string>("neighbors.neighbor.delay"), "5");
+
+  std::vector<std::pair<std::string, std::string>> sim = readSimConfig();
+  BOOST_REQUIRE_EQUAL(sim.size(), 3);
+  BOOST_CHECK_EQUAL(sim[0].first, "rtrA");
+  BOOST_CHECK_EQUAL(sim[1].first, "rtrB");
+  BOOST_CHECK_EQUAL(sim[2].first, "rtrC");
+  BOOST_CHECK(!boost::filesystem::exists(generator.GetNodeConfigFileName("rtrX")));
+}
+
+BOOST_AUTO_TEST_CASE(BulkWithoutAdjacency)
+{
+  std::string file = (TEST_CONF_DIR / "bulk.conf").string();
+  {
+    std::ofstream os(file.c_str());
+    os << "ndn-routers\n"
+       << "rtrA NA 3 1 /ndn /edu/rtrA /%C1.Router/rtrA 1800 3600 4 INFO /log /seq 2 5 60 5 10 "
+       << "off 123.456 1.45 3 15 /p1 /p2\n";
+  }
+
+  BOOST_CHECK(!generator.ProcessBulkConfig(file));
+  BOOST_CHECK(!boost::filesystem::exists(generator.GetNodeConfigFileName("rtrA")));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
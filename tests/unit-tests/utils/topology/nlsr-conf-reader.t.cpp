@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/topology/nlsr-conf-reader.hpp"
+
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/info_parser.hpp>
+
+#include <fstream>
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+const boost::filesystem::path TEST_CONF_DIR = boost::filesystem::path(TEST_CONFIG_PATH) / "nlsr-conf-reader";
+
+class NlsrConfReaderFixture : public CleanupFixture
+{
+public:
+  // ring of N_NODES routers, one per-node file each, and one ndn-node without a file
+  NlsrConfReaderFixture()
+  {
+    boost::filesystem::create_directories(TEST_CONF_DIR);
+
+    std::ofstream top((TEST_CONF_DIR / "nlsr_sim.conf").string().c_str());
+    for (size_t i = 0; i < N_NODES; ++i) {
+      top << "ndn-node\n{\n  node-id R" << i << "\n  nlsr-config " << nodeFile(i) << "\n}\n";
+      writeNodeFile(i);
+    }
+    top << "ndn-node\n{\n  node-id R" << N_NODES << "\n  nlsr-config "
+        << (TEST_CONF_DIR / "missing.conf").string() << "\n}\n";
+  }
+
+  ~NlsrConfReaderFixture()
+  {
+    boost::filesystem::remove_all(TEST_CONF_DIR);
+  }
+
+  std::string
+  nodeFile(size_t i) const
+  {
+    return (TEST_CONF_DIR / ("nlsr_node_R" + std::to_string(i) + ".conf")).string();
+  }
+
+  void
+  writeNodeFile(size_t i) const
+  {
+    std::ofstream os(nodeFile(i).c_str());
+    os << "general\n{\n"
+       << "  node-id R" << i << "\n"
+       << "  city city" << i << "\n"
+       << "  latitude " << i << "\n"
+       << "  longitude " << 2 * i << "\n"
+       << "  network /ndn\n  site /site" << i << "\n  router /%C1.Router/R" << i << "\n"
+       << "}\n"
+       << "neighbors\n{\n"
+       << "  hello-retries 3\n";
+    for (size_t neighbor : {(i + N_NODES - 1) % N_NODES, (i + 1) % N_NODES}) {
+      os << "  neighbor\n  {\n"
+         << "    node-id R" << neighbor << "\n"
+         << "    name /ndn/site" << neighbor << "/%C1.Router/R" << neighbor << "\n"
+         << "    face-uri udp4://10.0." << neighbor << ".1\n"
+         << "    link-cost " << 10 + neighbor << "\n"
+         << "    bandwidth 100\n    metric 1\n    delay 0\n    queue 1000\n"
+         << "  }\n";
+    }
+    os << "}\n"
+       << "advertising\n{\n  prefix /ndn/site" << i << "/data\n}\n";
+  }
+
+public:
+  static const size_t N_NODES = 20;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsTopologyNlsrConfReader, NlsrConfReaderFixture)
+
+BOOST_AUTO_TEST_CASE(ParallelMatchesSequential)
+{
+  NlsrConfReader reader((TEST_CONF_DIR / "nlsr_sim.conf").string());
+  BOOST_REQUIRE(reader.ProcessConfFile());
+
+  for (size_t i = 0; i < N_NODES; ++i) {
+    shared_ptr<const NlsrConfReader::ConfigSection> config =
+      reader.GetNodeConfig("R" + std::to_string(i));
+    BOOST_REQUIRE(config != nullptr);
+
+    // same tree as a sequential read of the node's file
+    NlsrConfReader::ConfigSection expected;
+    boost::property_tree::read_info(nodeFile(i), expected);
+    BOOST_CHECK(*config == expected);
+  }
+
+  // a missing node file is skipped
+  BOOST_CHECK(reader.GetNodeConfig("R" + std::to_string(N_NODES)) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Topology)
+{
+  NlsrConfReader reader((TEST_CONF_DIR / "nlsr_sim.conf").string());
+  NodeContainer nodes = reader.Read();
+
+  BOOST_CHECK_EQUAL(nodes.GetN(), N_NODES);
+  BOOST_CHECK_EQUAL(reader.GetLinks().size(), N_NODES);
+  for (const TopologyReader::Link& link : reader.GetLinks()) {
+    uint32_t from = std::stoul(link.GetFromNodeName().substr(1));
+    uint32_t to = std::stoul(link.GetToNodeName().substr(1));
+    BOOST_CHECK((from + 1) % N_NODES == to || (to + 1) % N_NODES == from);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(AutoPartitioningZeroDelay)
+{
+  // links have "delay 0", as in ndn-nlsr-confgen output, and the channel default is 0s
+  NlsrConfReader reader((TEST_CONF_DIR / "nlsr_sim.conf").string());
+  reader.SetAutoPartitioning(2);
+  NodeContainer nodes = reader.Read();
+  BOOST_CHECK_EQUAL(nodes.GetN(), N_NODES);
+
+  size_t nCutLinks = 0;
+  for (const TopologyReader::Link& link : reader.GetLinks()) {
+    TimeValue delay;
+    link.GetFromNetDevice()->GetChannel()->GetAttribute("Delay", delay);
+    if (link.GetFromNode()->GetSystemId() != link.GetToNode()->GetSystemId()) {
+      // links between partitions get the default lookahead instead of aborting the run
+      ++nCutLinks;
+      BOOST_CHECK_EQUAL(delay.Get(), Seconds(TopologyPartitioner::DEFAULT_LOOKAHEAD));
+    }
+    else {
+      BOOST_CHECK_EQUAL(delay.Get(), Seconds(0));
+    }
+  }
+  BOOST_CHECK_GT(nCutLinks, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
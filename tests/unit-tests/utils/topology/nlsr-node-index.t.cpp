@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/topology/nlsr-node-index.hpp"
+
+#include "ns3/node.h"
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_FIXTURE_TEST_SUITE(UtilsTopologyNlsrNodeIndex, CleanupFixture)
+
+BOOST_AUTO_TEST_CASE(FindAddedNodes)
+{
+  const size_t N_NODES = 100;
+  NlsrNodeIndex index(N_NODES);
+
+  std::vector<Ptr<Node>> nodes;
+  for (size_t i = 0; i < N_NODES; ++i) {
+    nodes.push_back(CreateObject<Node>());
+    index.Add("/ndn/site/%C1.Router/router" + std::to_string(i), nodes.back());
+  }
+  BOOST_CHECK_EQUAL(index.GetN(), N_NODES);
+
+  for (size_t i = 0; i < N_NODES; ++i) {
+    BOOST_CHECK_EQUAL(index.Find("/ndn/site/%C1.Router/router" + std::to_string(i)), nodes[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(UnknownName)
+{
+  NlsrNodeIndex index(2);
+  BOOST_CHECK(index.Find("/ndn/site/%C1.Router/router0") == nullptr);
+
+  index.Add("/ndn/site/%C1.Router/router0", CreateObject<Node>());
+  BOOST_CHECK(index.Find("/ndn/site/%C1.Router/router1") == nullptr);
+  BOOST_CHECK(index.Find("") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(AddTwiceReplaces)
+{
+  NlsrNodeIndex index(1);
+  Ptr<Node> first = CreateObject<Node>();
+  Ptr<Node> second = CreateObject<Node>();
+
+  index.Add("/ndn/site/%C1.Router/router0", first);
+  index.Add("/ndn/site/%C1.Router/router0", second);
+
+  BOOST_CHECK_EQUAL(index.GetN(), 1);
+  BOOST_CHECK_EQUAL(index.Find("/ndn/site/%C1.Router/router0"), second);
+}
+
+BOOST_AUTO_TEST_CASE(FullAtMinimumCapacity)
+{
+  // smallest table has 16 slots and accepts 8 names; probing must wrap around
+  NlsrNodeIndex index(0);
+  std::vector<Ptr<Node>> nodes;
+  for (size_t i = 0; i < 8; ++i) {
+    nodes.push_back(CreateObject<Node>());
+    index.Add(std::to_string(i), nodes.back());
+  }
+
+  for (size_t i = 0; i < 8; ++i) {
+    BOOST_CHECK_EQUAL(index.Find(std::to_string(i)), nodes[i]);
+  }
+  BOOST_CHECK(index.Find("8") == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
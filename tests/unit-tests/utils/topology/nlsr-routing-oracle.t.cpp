@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/topology/nlsr-routing-oracle.hpp"
+
+#include <cmath>
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class NlsrRoutingOracleFixture : public CleanupFixture
+{
+public:
+  // ring 0-1-2-3-0 with cost 1 links and a cost 5 diagonal 0-2
+  void
+  createTopology(uint32_t maxFacesPerPrefix)
+  {
+    for (uint32_t i = 0; i < 4; ++i) {
+      oracle.AddRouter(maxFacesPerPrefix);
+    }
+    addLink(0, 1, 1);
+    addLink(1, 2, 1);
+    addLink(2, 3, 1);
+    addLink(3, 0, 1);
+    addLink(0, 2, 5);
+  }
+
+  void
+  addLink(uint32_t a, uint32_t b, double cost)
+  {
+    oracle.AddLink(a, b, cost);
+    oracle.AddLink(b, a, cost);
+  }
+
+public:
+  NlsrRoutingOracle oracle;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsTopologyNlsrRoutingOracle, NlsrRoutingOracleFixture)
+
+BOOST_AUTO_TEST_CASE(SinglePath)
+{
+  createTopology(1);
+
+  NlsrRoutingOracle::RoutingTable table = oracle.ComputeRoutingTable(0);
+  BOOST_REQUIRE_EQUAL(table.size(), 4);
+  BOOST_CHECK(table[0].empty());
+
+  BOOST_REQUIRE_EQUAL(table[1].size(), 1);
+  BOOST_CHECK_EQUAL(table[1][0].neighbor, 1);
+  BOOST_CHECK_EQUAL(table[1][0].cost, 1);
+
+  BOOST_REQUIRE_EQUAL(table[2].size(), 1);
+  BOOST_CHECK_EQUAL(table[2][0].cost, 2);
+
+  BOOST_REQUIRE_EQUAL(table[3].size(), 1);
+  BOOST_CHECK_EQUAL(table[3][0].neighbor, 3);
+}
+
+BOOST_AUTO_TEST_CASE(MultiPath)
+{
+  createTopology(0);
+
+  NlsrRoutingOracle::RoutingTable table = oracle.ComputeRoutingTable(0);
+
+  // every neighbor is a next hop, ranked by path cost through that neighbor only
+  BOOST_REQUIRE_EQUAL(table[1].size(), 3);
+  BOOST_CHECK_EQUAL(table[1][0].neighbor, 1);
+  BOOST_CHECK_EQUAL(table[1][0].cost, 1);
+  BOOST_CHECK_EQUAL(table[1][1].neighbor, 3);
+  BOOST_CHECK_EQUAL(table[1][1].cost, 3);
+  BOOST_CHECK_EQUAL(table[1][2].neighbor, 2);
+  BOOST_CHECK_EQUAL(table[1][2].cost, 6);
+}
+
+BOOST_AUTO_TEST_CASE(MaxFacesPerPrefix)
+{
+  createTopology(2);
+
+  NlsrRoutingOracle::RoutingTable table = oracle.ComputeRoutingTable(0);
+  BOOST_REQUIRE_EQUAL(table[2].size(), 2);
+  BOOST_CHECK_EQUAL(table[2][0].cost, 2);
+  BOOST_CHECK_EQUAL(table[2][1].cost, 2);
+}
+
+BOOST_AUTO_TEST_CASE(Unreachable)
+{
+  createTopology(1);
+  oracle.AddRouter(1);
+
+  NlsrRoutingOracle::RoutingTable table = oracle.ComputeRoutingTable(0);
+  BOOST_REQUIRE_EQUAL(table.size(), 5);
+  BOOST_CHECK(table[4].empty());
+}
+
+BOOST_AUTO_TEST_CASE(Hyperbolic)
+{
+  oracle.AddHyperbolicRouter(0, 1.0, 0.0);
+  oracle.AddHyperbolicRouter(0, 1.0, 1.0);
+  oracle.AddHyperbolicRouter(0, 1.0, 2.0);
+  oracle.AddHyperbolicRouter(0, 1.0, 2.5);
+  addLink(0, 1, 1);
+  addLink(0, 3, 1);
+  addLink(1, 2, 1);
+  addLink(2, 3, 1);
+
+  NlsrRoutingOracle::RoutingTable table = oracle.ComputeRoutingTable(0);
+  BOOST_REQUIRE_EQUAL(table[2].size(), 2);
+  BOOST_CHECK_EQUAL(table[2][0].neighbor, 3); // angle 2.5 is closer to 2 than angle 1
+  BOOST_CHECK_CLOSE(table[2][0].cost, NlsrRoutingOracle::GetHyperbolicDistance(1, 2.5, 1, 2),
+                    0.001);
+
+  // direct neighbor has zero distance
+  BOOST_CHECK_EQUAL(table[1][0].neighbor, 1);
+  BOOST_CHECK_EQUAL(table[1][0].cost, 0);
+}
+
+BOOST_AUTO_TEST_CASE(ComputeAllInOrder)
+{
+  createTopology(0);
+
+  std::vector<uint32_t> visited;
+  oracle.ComputeAll([&] (uint32_t router, const NlsrRoutingOracle::RoutingTable& table) {
+      visited.push_back(router);
+      NlsrRoutingOracle::RoutingTable expected = oracle.ComputeRoutingTable(router);
+      BOOST_REQUIRE_EQUAL(table.size(), expected.size());
+      for (size_t i = 0; i < table.size(); ++i) {
+        BOOST_CHECK_EQUAL(table[i].size(), expected[i].size());
+      }
+    }, 3);
+
+  BOOST_CHECK_EQUAL(visited.size(), 4);
+  BOOST_CHECK(std::is_sorted(visited.begin(), visited.end()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/topology/topology-partitioner.hpp"
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class TopologyPartitionerFixture : public CleanupFixture
+{
+public:
+  TopologyPartitionerFixture()
+  {
+    // 8x8 grid, 1ms links except for the 20ms links in the middle of every row
+    for (uint32_t i = 0; i < SIZE * SIZE; ++i) {
+      partitioner.AddNode(i / SIZE, i % SIZE);
+    }
+    for (uint32_t row = 0; row < SIZE; ++row) {
+      for (uint32_t column = 0; column < SIZE; ++column) {
+        uint32_t node = row * SIZE + column;
+        if (column + 1 < SIZE)
+          partitioner.AddLink(node, node + 1, column == SIZE / 2 - 1 ? 0.020 : 0.001);
+        if (row + 1 < SIZE)
+          partitioner.AddLink(node, node + SIZE, 0.001);
+      }
+    }
+  }
+
+  std::vector<uint32_t>
+  count(const std::vector<uint32_t>& partitions, uint32_t nPartitions)
+  {
+    std::vector<uint32_t> sizes(nPartitions, 0);
+    for (uint32_t partition : partitions) {
+      BOOST_REQUIRE_LT(partition, nPartitions);
+      ++sizes[partition];
+    }
+    return sizes;
+  }
+
+public:
+  static const uint32_t SIZE = 8;
+  TopologyPartitioner partitioner;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsTopologyTopologyPartitioner, TopologyPartitionerFixture)
+
+BOOST_AUTO_TEST_CASE(SinglePartition)
+{
+  std::vector<uint32_t> partitions = partitioner.Partition(1);
+  BOOST_CHECK_EQUAL(partitions.size(), SIZE * SIZE);
+  BOOST_CHECK(std::all_of(partitions.begin(), partitions.end(), [] (uint32_t p) { return p == 0; }));
+  BOOST_CHECK_EQUAL(partitioner.GetLookahead(partitions), -1);
+}
+
+BOOST_AUTO_TEST_CASE(MinEdgeCut)
+{
+  std::vector<uint32_t> partitions = partitioner.Partition(2, TopologyPartitioner::MIN_EDGE_CUT);
+  std::vector<uint32_t> sizes = count(partitions, 2);
+  BOOST_CHECK_EQUAL(sizes[0], SIZE * SIZE / 2);
+  BOOST_CHECK_EQUAL(sizes[1], SIZE * SIZE / 2);
+
+  // only the long links are cut
+  BOOST_CHECK_CLOSE(partitioner.GetLookahead(partitions), 0.020, 0.001);
+
+  BOOST_CHECK(partitions == partitioner.Partition(2, TopologyPartitioner::MIN_EDGE_CUT));
+}
+
+BOOST_AUTO_TEST_CASE(Geographic)
+{
+  std::vector<uint32_t> partitions = partitioner.Partition(4, TopologyPartitioner::GEOGRAPHIC);
+  std::vector<uint32_t> sizes = count(partitions, 4);
+  for (uint32_t size : sizes) {
+    BOOST_CHECK_EQUAL(size, SIZE * SIZE / 4);
+  }
+
+  // quadrants of the grid
+  BOOST_CHECK_EQUAL(partitions[0], partitions[SIZE + 1]);
+  BOOST_CHECK_NE(partitions[0], partitions[SIZE * SIZE - 1]);
+}
+
+BOOST_AUTO_TEST_CASE(MorePartitionsThanNodes)
+{
+  TopologyPartitioner small;
+  small.AddNode();
+  small.AddNode();
+  small.AddLink(0, 1, 0.010);
+
+  std::vector<uint32_t> partitions = small.Partition(4);
+  BOOST_CHECK_NE(partitions[0], partitions[1]);
+  BOOST_CHECK_CLOSE(small.GetLookahead(partitions), 0.010, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(ParseDelay)
+{
+  BOOST_CHECK_CLOSE(TopologyPartitioner::ParseDelay("10ms"), 0.010, 0.001);
+  BOOST_CHECK_CLOSE(TopologyPartitioner::ParseDelay("250us"), 0.000250, 0.001);
+  BOOST_CHECK_CLOSE(TopologyPartitioner::ParseDelay("2"), 2.0, 0.001);
+  BOOST_CHECK_EQUAL(TopologyPartitioner::ParseDelay("0"), 0);
+  BOOST_CHECK_EQUAL(TopologyPartitioner::ParseDelay(""), -1);
+  BOOST_CHECK_EQUAL(TopologyPartitioner::ParseDelay("fast"), -1);
+}
+
+BOOST_AUTO_TEST_CASE(DefaultLinkDelay)
+{
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("7ms"));
+  BOOST_CHECK_CLOSE(TopologyPartitioner::GetDefaultLinkDelay(), 0.007, 0.001);
+  Config::Reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
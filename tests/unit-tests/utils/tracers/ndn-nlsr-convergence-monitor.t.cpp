@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/tracers/ndn-nlsr-convergence-monitor.hpp"
+
+#include <map>
+#include <sstream>
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+// routing tables are replaced by digests set from the test
+class TestConvergenceMonitor : public NlsrConvergenceMonitor
+{
+public:
+  TestConvergenceMonitor(const NodeContainer& nodes, shared_ptr<std::ostream> os)
+    : NlsrConvergenceMonitor(nodes, os, Seconds(1.0), Seconds(3.0))
+  {
+  }
+
+  void
+  SetDigest(Ptr<Node> node, size_t digest)
+  {
+    m_digests[node->GetId()] = digest;
+  }
+
+protected:
+  virtual size_t
+  ComputeRoutingTableDigest(Ptr<Node> node) const override
+  {
+    auto it = m_digests.find(node->GetId());
+    return it == m_digests.end() ? 0 : it->second;
+  }
+
+private:
+  std::map<uint32_t, size_t> m_digests;
+};
+
+static void
+trace(NlsrTraceKind kind, uint64_t packets, uint64_t bytes)
+{
+  NlsrTracer::Instance().Trace(kind, 0, 0, 0, packets, bytes);
+}
+
+class NlsrConvergenceMonitorFixture : public ScenarioHelperWithCleanupFixture
+{
+public:
+  NlsrConvergenceMonitorFixture()
+    : output(make_shared<std::ostringstream>())
+  {
+    createTopology({
+        {"1", "2"}
+      });
+
+    NodeContainer nodes;
+    nodes.Add(getNode("1"));
+    nodes.Add(getNode("2"));
+    monitor = Create<TestConvergenceMonitor>(nodes, output);
+  }
+
+  ~NlsrConvergenceMonitorFixture()
+  {
+    monitor = nullptr;
+    NlsrTracer::Instance().SetEventListener(NlsrTracer::EventListener());
+  }
+
+  void
+  changeRoutingTable(const std::string& node, double time, size_t digest)
+  {
+    Simulator::Schedule(Seconds(time), &TestConvergenceMonitor::SetDigest, monitor,
+                        getNode(node), digest);
+  }
+
+public:
+  shared_ptr<std::ostringstream> output;
+  Ptr<TestConvergenceMonitor> monitor;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsTracersNdnNlsrConvergenceMonitor, NlsrConvergenceMonitorFixture)
+
+BOOST_AUTO_TEST_CASE(Episodes)
+{
+  // startup: last routing table change observed at 3s
+  changeRoutingTable("1", 0.5, 1);
+  changeRoutingTable("2", 2.5, 7);
+  Simulator::ScheduleWithContext(getNode("1")->GetId(), Seconds(0.2), &trace,
+                                 NLSR_TRACE_HELLO, 1, 512);
+
+  // announced topology change at 7s, routing table changes until 8s
+  Simulator::Schedule(Seconds(7.0), &NlsrConvergenceMonitor::NotifyTopologyChange,
+                      monitor, std::string("link-failure"));
+  Simulator::ScheduleWithContext(getNode("2")->GetId(), Seconds(7.2), &trace,
+                                 NLSR_TRACE_FIB, 3, 0);
+  changeRoutingTable("1", 7.5, 2);
+
+  // change without announcement, detected at 13s
+  changeRoutingTable("2", 12.5, 8);
+
+  Simulator::Stop(Seconds(5.5));
+  Simulator::Run();
+  BOOST_CHECK_EQUAL(monitor->IsConverged(), false);
+
+  Simulator::Stop(Seconds(1.0));
+  Simulator::Run();
+  BOOST_CHECK_EQUAL(monitor->IsConverged(), true);
+  BOOST_CHECK_EQUAL(monitor->GetLastConvergenceTime(), Seconds(3.0));
+
+  Simulator::Stop(Seconds(10.0));
+  Simulator::Run();
+  BOOST_CHECK_EQUAL(monitor->IsConverged(), true);
+  BOOST_CHECK_EQUAL(monitor->GetLastConvergenceTime(), Seconds(1.0));
+
+  std::ostringstream report;
+  monitor->Report(report);
+  BOOST_CHECK_EQUAL(report.str(),
+    "Episode	Cause	Start	Converged	ConvergenceTime	HelloPackets	HelloKBytes	NameLsaPackets	NameLsaKBytes	LinkLsaPackets	LinkLsaKBytes	SyncPackets	SyncKBytes	FibPackets	FibKBytes\n"
+    "0	startup	0	3	3	1	0.5	0	0	0	0	0	0	0	0\n"
+    "1	link-failure	7	8	1	0	0	0	0	0	0	0	0	1	0\n"
+    "2	unannounced	12	13	1	0	0	0	0	0	0	0	0	0	0\n"
+    "\n"
+    "Type	Packets	KBytes\n"
+    "Hello	1	0.5\n"
+    "NameLsa	0	0\n"
+    "LinkLsa	0	0\n"
+    "Sync	0	0\n"
+    "Fib	1	0\n"
+    "\n"
+    "Node	FibUpdates	RoutingRecalculations\n"
+    "1	0	2\n"
+    "2	1	2\n");
+}
+
+BOOST_AUTO_TEST_CASE(NoNlsr)
+{
+  // without NLSR, routing tables never change and startup converges after the quiet period
+  Simulator::Stop(Seconds(3.5));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(monitor->IsConverged(), true);
+  BOOST_CHECK_EQUAL(monitor->GetLastConvergenceTime(), Seconds(0));
+}
+
+BOOST_AUTO_TEST_CASE(ReportOnDestroy)
+{
+  Simulator::Stop(Seconds(3.5));
+  Simulator::Run();
+
+  // the report is written once, when the monitor is destroyed
+  BOOST_CHECK_EQUAL(output->str(), "");
+  std::ostringstream report;
+  monitor->Report(report);
+  monitor = nullptr;
+  BOOST_CHECK_EQUAL(output->str(), report.str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/tracers/ndn-nlsr-tracer.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include "../../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+// NlsrTracer places its files relative to the current directory
+const std::string TEST_PREFIX = "ndn-nlsr-tracer-test";
+const boost::filesystem::path TEST_SUMMARY = TEST_PREFIX + "-nlsr-summary-trace.txt";
+
+static void
+trace(NlsrTraceKind kind, uint64_t packets, uint64_t bytes)
+{
+  NlsrTracer::Instance().Trace(kind, 0, 0, 0, packets, bytes);
+}
+
+static void
+traceLinkLsa()
+{
+  NlsrTracer::Instance().LinkLsaTrace("256", "netdev://[00:00:00:00:00:01]", "SENT", "4", "1.5",
+                                      "-");
+}
+
+class NlsrTracerFixture : public ScenarioHelperWithCleanupFixture
+{
+public:
+  NlsrTracerFixture()
+  {
+    createTopology({
+        {"1", "2"}
+      });
+  }
+
+  ~NlsrTracerFixture()
+  {
+    NlsrTracer::Instance().Flush();
+    boost::filesystem::remove(TEST_SUMMARY);
+  }
+
+  void
+  traceAt(const std::string& node, double time, NlsrTraceKind kind, uint64_t packets,
+          uint64_t bytes)
+  {
+    Simulator::ScheduleWithContext(getNode(node)->GetId(), Seconds(time), &trace,
+                                   kind, packets, bytes);
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(UtilsTracersNdnNlsrTracer, NlsrTracerFixture)
+
+BOOST_AUTO_TEST_CASE(SummaryAggregation)
+{
+  NlsrTracer::Instance().InitializeSummaryTracer(TEST_PREFIX, Seconds(1.0));
+
+  // first period: typed events on node 1, string API link LSA event on node 2
+  traceAt("1", 0.2, NLSR_TRACE_HELLO, 1, 1024);
+  traceAt("1", 0.4, NLSR_TRACE_HELLO, 1, 1024);
+  traceAt("1", 0.5, NLSR_TRACE_NAME_LSA, 1, 512);
+  traceAt("1", 0.6, NLSR_TRACE_FIB, 3, 0); // FIB events count once, whatever the attempt
+  Simulator::ScheduleWithContext(getNode("2")->GetId(), Seconds(0.7), &traceLinkLsa);
+
+  // second period: counters start again from zero
+  traceAt("1", 1.5, NLSR_TRACE_NSYNC, 2, 512);
+
+  Simulator::Stop(Seconds(2.5));
+  Simulator::Run();
+
+  NlsrTracer::Instance().Flush(); // to force the summary to be written
+
+  std::ifstream t(TEST_SUMMARY.string().c_str());
+  std::stringstream buffer;
+  buffer << t.rdbuf();
+
+  BOOST_CHECK_EQUAL(buffer.str(),
+    "Time	Node	HelloPackets	HelloKBytes	NameLsaPackets	NameLsaKBytes	LinkLsaPackets	LinkLsaKBytes	SyncPackets	SyncKBytes	FibUpdates\n"
+    "1	1	2	2	1	0.5	0	0	0	0	1\n"
+    "1	2	0	0	0	0	4	1.5	0	0	0\n"
+    "2	1	0	0	0	0	0	0	2	0.5	0\n"
+    "2	2	0	0	0	0	0	0	0	0	0\n");
+}
+
+BOOST_AUTO_TEST_CASE(SummaryListener)
+{
+  std::vector<uint64_t> packets(NLSR_TRACE_N_KINDS, 0);
+  NlsrTracer::Instance().SetEventListener([&] (uint8_t kind, uint32_t, uint64_t n, uint64_t) {
+      packets[kind] += n;
+    });
+  NlsrTracer::Instance().InitializeSummaryTracer(TEST_PREFIX, Seconds(1.0));
+
+  traceAt("1", 0.2, NLSR_TRACE_HELLO, 3, 0);
+  traceAt("2", 0.4, NLSR_TRACE_FIB, 5, 0);
+
+  Simulator::Stop(Seconds(0.5));
+  Simulator::Run();
+  NlsrTracer::Instance().SetEventListener(NlsrTracer::EventListener());
+
+  BOOST_CHECK_EQUAL(packets[NLSR_TRACE_HELLO], 3);
+  BOOST_CHECK_EQUAL(packets[NLSR_TRACE_FIB], 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,575 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-binary-log.hpp"
+
+#include "ns3/simulator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <queue>
+
+namespace ns3 {
+namespace ndn {
+
+static const char BINARY_LOG_MAGIC[] = "NDNBLOG1";
+static const size_t CHUNK_SIZE = 64 * 1024;
+
+// top-level entries of the log file
+enum EntryType : uint8_t {
+  ENTRY_SITE = 'S',
+  ENTRY_LITERAL = 'L',
+  ENTRY_CHUNK = 'R'
+};
+
+// argument types of a record
+enum ArgumentType : uint8_t {
+  ARGUMENT_END = 0,
+  ARGUMENT_SIGNED,
+  ARGUMENT_UNSIGNED,
+  ARGUMENT_CHAR,
+  ARGUMENT_DOUBLE,
+  ARGUMENT_STRING,
+  ARGUMENT_LITERAL,
+  ARGUMENT_POINTER,
+  ARGUMENT_SEPARATOR
+};
+
+static void
+WriteVarNumber(std::vector<uint8_t>& buffer, uint64_t value)
+{
+  while (value >= 0x80) {
+    buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<uint8_t>(value));
+}
+
+static void
+WriteString(std::vector<uint8_t>& buffer, const char* value, size_t length)
+{
+  WriteVarNumber(buffer, length);
+  buffer.insert(buffer.end(), value, value + length);
+}
+
+static bool
+ReadVarNumber(std::istream& is, uint64_t& value)
+{
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int byte = is.get();
+    if (byte == std::char_traits<char>::eof()) {
+      return false;
+    }
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool
+ReadString(std::istream& is, std::string& value)
+{
+  uint64_t length;
+  if (!ReadVarNumber(is, length)) {
+    return false;
+  }
+  value.resize(length);
+  return length == 0 || static_cast<bool>(is.read(&value[0], length));
+}
+
+static std::vector<uint8_t>&
+GetScratchBuffer()
+{
+  static thread_local std::vector<uint8_t> buffer;
+  return buffer;
+}
+
+BinaryLog::Record::Record(Site& site, bool isFunction)
+  : m_site(site)
+  , m_isFunction(isFunction)
+  , m_nArguments(0)
+  , m_nLiterals(0)
+  , m_buffer(GetScratchBuffer())
+{
+  m_buffer.clear();
+}
+
+BinaryLog::Record::~Record()
+{
+  m_buffer.push_back(ARGUMENT_END);
+  BinaryLog::Instance().Commit(m_site, m_buffer);
+}
+
+void
+BinaryLog::Record::BeginArgument()
+{
+  // NS_LOG_FUNCTION separates parameters with ", "
+  if (m_isFunction && m_nArguments > 0) {
+    m_buffer.push_back(ARGUMENT_SEPARATOR);
+  }
+  ++m_nArguments;
+}
+
+BinaryLog::Record&
+BinaryLog::Record::AppendSigned(int64_t value)
+{
+  BeginArgument();
+  m_buffer.push_back(ARGUMENT_SIGNED);
+  WriteVarNumber(m_buffer, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  return *this;
+}
+
+BinaryLog::Record&
+BinaryLog::Record::AppendUnsigned(uint64_t value)
+{
+  BeginArgument();
+  m_buffer.push_back(ARGUMENT_UNSIGNED);
+  WriteVarNumber(m_buffer, value);
+  return *this;
+}
+
+BinaryLog::Record&
+BinaryLog::Record::AppendChar(char value)
+{
+  BeginArgument();
+  m_buffer.push_back(ARGUMENT_CHAR);
+  m_buffer.push_back(static_cast<uint8_t>(value));
+  return *this;
+}
+
+BinaryLog::Record&
+BinaryLog::Record::AppendDouble(double value)
+{
+  BeginArgument();
+  m_buffer.push_back(ARGUMENT_DOUBLE);
+  uint8_t bytes[sizeof(double)];
+  std::memcpy(bytes, &value, sizeof(double));
+  m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(double));
+  return *this;
+}
+
+BinaryLog::Record&
+BinaryLog::Record::operator<<(const char* value)
+{
+  if (value == nullptr) {
+    return AppendPointer(value);
+  }
+  return AppendString(value, std::strlen(value));
+}
+
+BinaryLog::Record&
+BinaryLog::Record::AppendString(const char* value, size_t length)
+{
+  BeginArgument();
+  m_buffer.push_back(ARGUMENT_STRING);
+  WriteString(m_buffer, value, length);
+  return *this;
+}
+
+BinaryLog::Record&
+BinaryLog::Record::AppendLiteral(const char* literal)
+{
+  BeginArgument();
+  m_buffer.push_back(ARGUMENT_LITERAL);
+
+  // literals of a statement are at fixed positions; the global table is only used on the
+  // first execution of the statement
+  uint32_t position = m_nLiterals++;
+  if (position < N_SITE_LITERALS &&
+      m_site.literals[position].literal.load(std::memory_order_acquire) == literal) {
+    WriteVarNumber(m_buffer, m_site.literals[position].id);
+  }
+  else {
+    WriteVarNumber(m_buffer, BinaryLog::Instance().GetLiteralId(m_site, position, literal));
+  }
+  return *this;
+}
+
+BinaryLog::Record&
+BinaryLog::Record::AppendPointer(const void* pointer)
+{
+  BeginArgument();
+  m_buffer.push_back(ARGUMENT_POINTER);
+  WriteVarNumber(m_buffer, reinterpret_cast<uintptr_t>(pointer));
+  return *this;
+}
+
+BinaryLog&
+BinaryLog::Instance()
+{
+  static BinaryLog instance;
+  return instance;
+}
+
+BinaryLog::BinaryLog()
+  : m_isOpen(false)
+  , m_nRecords(0)
+{
+  m_siteBuffers.push_back(nullptr); // site id 0 is "not assigned"
+}
+
+BinaryLog::~BinaryLog()
+{
+  Close();
+}
+
+bool
+BinaryLog::Open(const std::string& file)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return DoOpen(file);
+}
+
+bool
+BinaryLog::DoOpen(const std::string& file)
+{
+  if (m_isOpen) {
+    DoClose();
+  }
+
+  m_os.open(file.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!m_os.is_open()) {
+    std::cerr << "Cannot open binary log " << file << std::endl;
+    return false;
+  }
+  m_os.write(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC) - 1);
+  m_isOpen = true;
+  m_nRecords = 0;
+
+  // a new file needs all definitions again.  Literal ids are cached by the call sites, so
+  // literals keep their ids and are defined upfront.
+  for (Site* site : m_sites) {
+    site->id = 0;
+  }
+  m_sites.clear();
+  m_siteBuffers.resize(1);
+  for (uint32_t id = 0; id < m_literalTexts.size(); ++id) {
+    WriteLiteral(id);
+  }
+  return true;
+}
+
+void
+BinaryLog::Flush()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  DoFlush();
+}
+
+void
+BinaryLog::DoFlush()
+{
+  for (auto& buffer : m_buffers) {
+    WriteChunk(buffer.second);
+  }
+  m_os.flush();
+}
+
+void
+BinaryLog::Close()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  DoClose();
+}
+
+void
+BinaryLog::DoClose()
+{
+  if (m_isOpen) {
+    DoFlush();
+    m_os.close();
+    m_isOpen = false;
+  }
+}
+
+void
+BinaryLog::EnsureOpen()
+{
+  if (!m_isOpen) {
+    const char* file = std::getenv("NS_BINARY_LOG");
+    DoOpen(file != nullptr ? file : "ns3-log.bin");
+  }
+}
+
+void
+BinaryLog::WriteEntry(uint8_t type, const std::vector<uint8_t>& entry)
+{
+  m_os.put(static_cast<char>(type));
+  m_os.write(reinterpret_cast<const char*>(entry.data()), entry.size());
+}
+
+void
+BinaryLog::WriteLiteral(uint32_t id)
+{
+  const std::string& literal = m_literalTexts[id];
+  std::vector<uint8_t> entry;
+  WriteVarNumber(entry, id);
+  WriteString(entry, literal.data(), literal.size());
+  WriteEntry(ENTRY_LITERAL, entry);
+}
+
+uint32_t
+BinaryLog::GetLiteralId(Site& site, uint32_t position, const char* literal)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  EnsureOpen();
+
+  uint32_t id;
+  auto it = m_literals.find(literal);
+  if (it != m_literals.end()) {
+    id = it->second;
+  }
+  else {
+    id = m_literalTexts.size();
+    m_literals[literal] = id;
+    m_literalTexts.push_back(literal);
+    WriteLiteral(id);
+  }
+
+  // a position of the statement is cached once; a statement that passes different character
+  // arrays at the same position keeps using the global table
+  if (position < N_SITE_LITERALS &&
+      site.literals[position].literal.load(std::memory_order_relaxed) == nullptr) {
+    site.literals[position].id = id;
+    site.literals[position].literal.store(literal, std::memory_order_release);
+  }
+  return id;
+}
+
+void
+BinaryLog::Commit(Site& site, const std::vector<uint8_t>& arguments)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  EnsureOpen();
+
+  if (site.id == 0) {
+    site.id = m_siteBuffers.size();
+    m_sites.push_back(&site);
+
+    ComponentBuffer& buffer = m_buffers[site.component];
+    m_siteBuffers.push_back(&buffer);
+
+    std::vector<uint8_t> entry;
+    WriteVarNumber(entry, site.id);
+    WriteVarNumber(entry, site.level);
+    WriteString(entry, site.component.data(), site.component.size());
+    WriteString(entry, site.function, std::strlen(site.function));
+    WriteEntry(ENTRY_SITE, entry);
+  }
+
+  ComponentBuffer& buffer = *m_siteBuffers[site.id];
+  int64_t time = Simulator::Now().GetNanoSeconds();
+  WriteVarNumber(buffer.records, m_nRecords++);
+  WriteVarNumber(buffer.records, site.id);
+  WriteVarNumber(buffer.records, (static_cast<uint64_t>(time) << 1) ^ static_cast<uint64_t>(time >> 63));
+  WriteVarNumber(buffer.records, Simulator::GetContext());
+  buffer.records.insert(buffer.records.end(), arguments.begin(), arguments.end());
+
+  if (buffer.records.size() >= CHUNK_SIZE) {
+    WriteChunk(buffer);
+  }
+}
+
+void
+BinaryLog::WriteChunk(ComponentBuffer& buffer)
+{
+  if (buffer.records.empty()) {
+    return;
+  }
+
+  std::vector<uint8_t> length;
+  WriteVarNumber(length, buffer.records.size());
+  m_os.put(static_cast<char>(ENTRY_CHUNK));
+  m_os.write(reinterpret_cast<const char*>(length.data()), length.size());
+  m_os.write(reinterpret_cast<const char*>(buffer.records.data()), buffer.records.size());
+  buffer.records.clear();
+}
+
+static const char*
+GetLevelName(uint64_t level)
+{
+  switch (level) {
+  case LOG_ERROR:
+    return "ERROR";
+  case LOG_WARN:
+    return "WARN";
+  case LOG_DEBUG:
+    return "DEBUG";
+  case LOG_INFO:
+    return "INFO";
+  case LOG_FUNCTION:
+    return "FUNCT";
+  case LOG_LOGIC:
+    return "LOGIC";
+  default:
+    return "LOG";
+  }
+}
+
+bool
+BinaryLog::Decode(std::istream& is, std::ostream& os)
+{
+  struct SiteInfo
+  {
+    uint64_t level;
+    std::string component;
+    std::string function;
+  };
+
+  char magic[sizeof(BINARY_LOG_MAGIC) - 1];
+  if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) != 0) {
+    std::cerr << "Not a binary log" << std::endl;
+    return false;
+  }
+
+  typedef std::pair<uint64_t, std::string> Line;
+
+  std::map<uint64_t, SiteInfo> sites;
+  std::map<uint64_t, std::string> literals;
+  // decoded records that follow a record not decoded yet, smallest number first
+  std::priority_queue<Line, std::vector<Line>, std::greater<Line>> pending;
+  uint64_t nextSeq = 0;
+
+  for (int type = is.get(); type != std::char_traits<char>::eof(); type = is.get()) {
+    if (type == ENTRY_SITE) {
+      uint64_t id;
+      SiteInfo site;
+      if (!ReadVarNumber(is, id) || !ReadVarNumber(is, site.level) ||
+          !ReadString(is, site.component) || !ReadString(is, site.function)) {
+        break;
+      }
+      sites[id] = site;
+    }
+    else if (type == ENTRY_LITERAL) {
+      uint64_t id;
+      std::string literal;
+      if (!ReadVarNumber(is, id) || !ReadString(is, literal)) {
+        break;
+      }
+      literals[id] = literal;
+    }
+    else if (type == ENTRY_CHUNK) {
+      std::string chunk;
+      if (!ReadString(is, chunk)) {
+        break;
+      }
+
+      std::istringstream records(chunk);
+      uint64_t seq, siteId, time, context;
+      while (ReadVarNumber(records, seq) && ReadVarNumber(records, siteId) &&
+             ReadVarNumber(records, time) && ReadVarNumber(records, context)) {
+        const SiteInfo& site = sites[siteId];
+        int64_t nanoseconds = static_cast<int64_t>(time >> 1) ^ -static_cast<int64_t>(time & 1);
+
+        std::ostringstream line;
+        line << "+" << std::fixed << std::setprecision(9) << nanoseconds / 1e9 << "s ";
+        line.unsetf(std::ios_base::floatfield);
+        line << std::setprecision(6);
+        if (context == 0xffffffff) {
+          line << "-1 ";
+        }
+        else {
+          line << context << " ";
+        }
+
+        bool isFunction = site.level == LOG_FUNCTION;
+        line << site.component << ":" << site.function << (isFunction ? "(" : "(): ");
+        if (!isFunction) {
+          line << "[" << GetLevelName(site.level) << "] ";
+        }
+
+        bool isOk = true;
+        for (int argument = records.get(); argument != ARGUMENT_END; argument = records.get()) {
+          uint64_t value = 0;
+          std::string text;
+          if (argument == ARGUMENT_SIGNED && ReadVarNumber(records, value)) {
+            line << (static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+          }
+          else if (argument == ARGUMENT_UNSIGNED && ReadVarNumber(records, value)) {
+            line << value;
+          }
+          else if (argument == ARGUMENT_CHAR) {
+            line << static_cast<char>(records.get());
+          }
+          else if (argument == ARGUMENT_DOUBLE) {
+            double number;
+            char bytes[sizeof(double)];
+            records.read(bytes, sizeof(double));
+            std::memcpy(&number, bytes, sizeof(double));
+            line << number;
+          }
+          else if (argument == ARGUMENT_STRING && ReadString(records, text)) {
+            line << text;
+          }
+          else if (argument == ARGUMENT_LITERAL && ReadVarNumber(records, value)) {
+            line << literals[value];
+          }
+          else if (argument == ARGUMENT_POINTER && ReadVarNumber(records, value)) {
+            line << reinterpret_cast<const void*>(static_cast<uintptr_t>(value));
+          }
+          else if (argument == ARGUMENT_SEPARATOR) {
+            line << ", ";
+          }
+          else {
+            isOk = false;
+            break;
+          }
+        }
+        if (!isOk) {
+          std::cerr << "Corrupted record " << seq << std::endl;
+          break;
+        }
+
+        if (isFunction) {
+          line << ")";
+        }
+
+        if (seq > nextSeq) {
+          pending.push(std::make_pair(seq, line.str()));
+          continue;
+        }
+        os << line.str() << "\n";
+        if (seq == nextSeq) {
+          for (++nextSeq; !pending.empty() && pending.top().first == nextSeq; ++nextSeq) {
+            os << pending.top().second << "\n";
+            pending.pop();
+          }
+        }
+      }
+    }
+    else {
+      std::cerr << "Corrupted binary log entry" << std::endl;
+      return false;
+    }
+  }
+
+  // records missing from a truncated or corrupted log leave gaps
+  for (; !pending.empty(); pending.pop()) {
+    os << pending.top().second << "\n";
+  }
+  return static_cast<bool>(os);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,368 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_BINARY_LOG_HPP
+#define NDN_BINARY_LOG_HPP
+
+#include "ns3/log.h"
+
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Deferred-format binary sink for NS_LOG
+ *
+ * With --enable-binary-log, NS_LOG_* statements of ndnSIM do not format text.  Every enabled
+ * statement appends a record with the id of its call site and its raw arguments to a
+ * per-component buffer; format strings (string literals) are written once and referenced by
+ * id afterwards, and each call site caches the ids of its literals.  Buffers are written to
+ * the log file in chunks and decoded offline into the familiar NS_LOG text, see Decode().
+ *
+ * The binary path replaces the NS_LOG_* macros in every translation unit that includes this
+ * header, usually through ndn-common.hpp.  NLSR's _LOG_* macros expand to NS_LOG_*, so an
+ * NLSR source file is covered only if it includes ndn-common.hpp (directly or through another
+ * ndnSIM header) before its log statements; other NLSR files keep logging text.
+ *
+ * Runtime selection of components and levels is unchanged (NS_LOG environment variable).
+ * Arguments without a raw encoding, such as ndn::Name, are formatted with operator<<.
+ *
+ * The log file is NS_BINARY_LOG from the environment, "ns3-log.bin" by default, unless Open()
+ * is called before the first record.
+ */
+class BinaryLog
+{
+public:
+  /**
+   * @brief Number of literals per log statement whose ids are cached at the call site
+   */
+  static const size_t N_SITE_LITERALS = 8;
+
+  /**
+   * @brief Call site of a log statement, a static variable of the statement
+   */
+  struct Site
+  {
+    /**
+     * @brief Id of the literal at one position of the statement, set once
+     */
+    struct Literal
+    {
+      std::atomic<const char*> literal; ///< @brief nullptr until set, published after id
+      uint32_t id;
+    };
+
+    std::string component;
+    LogLevel level;
+    const char* function;
+    uint32_t id; ///< @brief assigned on first use, 0 before
+    Literal literals[N_SITE_LITERALS]; ///< @brief ids of the first literals of the statement
+  };
+
+  /**
+   * @brief Log record under construction, committed when destroyed
+   */
+  class Record
+  {
+  public:
+    explicit
+    Record(Site& site, bool isFunction = false);
+
+    ~Record();
+
+    Record& operator<<(bool value)               { return AppendUnsigned(value); }
+    Record& operator<<(char value)               { return AppendChar(value); }
+    Record& operator<<(signed char value)        { return AppendChar(value); }
+    Record& operator<<(unsigned char value)      { return AppendUnsigned(value); }
+    Record& operator<<(short value)              { return AppendSigned(value); }
+    Record& operator<<(unsigned short value)     { return AppendUnsigned(value); }
+    Record& operator<<(int value)                { return AppendSigned(value); }
+    Record& operator<<(unsigned int value)       { return AppendUnsigned(value); }
+    Record& operator<<(long value)               { return AppendSigned(value); }
+    Record& operator<<(unsigned long value)      { return AppendUnsigned(value); }
+    Record& operator<<(long long value)          { return AppendSigned(value); }
+    Record& operator<<(unsigned long long value) { return AppendUnsigned(value); }
+    Record& operator<<(float value)              { return AppendDouble(value); }
+    Record& operator<<(double value)             { return AppendDouble(value); }
+
+    Record&
+    operator<<(const std::string& value)
+    {
+      return AppendString(value.data(), value.size());
+    }
+
+    Record&
+    operator<<(const char* value);
+
+    /**
+     * @brief String literal, stored once in the log and referenced by id
+     */
+    template<size_t N>
+    Record&
+    operator<<(const char (&literal)[N])
+    {
+      return AppendLiteral(literal);
+    }
+
+    template<size_t N>
+    Record&
+    operator<<(char (&buffer)[N])
+    {
+      return *this << static_cast<const char*>(buffer);
+    }
+
+    Record&
+    operator<<(char* value)
+    {
+      return *this << static_cast<const char*>(value);
+    }
+
+    template<class T>
+    Record&
+    operator<<(const T& value)
+    {
+      return Append(value, std::is_pointer<T>());
+    }
+
+  private:
+    template<class T>
+    Record&
+    Append(const T& pointer, std::true_type)
+    {
+      return AppendPointer(pointer);
+    }
+
+    template<class T>
+    Record&
+    Append(const T& value, std::false_type)
+    {
+      std::ostringstream os;
+      os << value;
+      std::string text = os.str();
+      return AppendString(text.data(), text.size());
+    }
+
+    void
+    BeginArgument();
+
+    Record&
+    AppendSigned(int64_t value);
+
+    Record&
+    AppendUnsigned(uint64_t value);
+
+    Record&
+    AppendChar(char value);
+
+    Record&
+    AppendDouble(double value);
+
+    Record&
+    AppendString(const char* value, size_t length);
+
+    Record&
+    AppendLiteral(const char* literal);
+
+    Record&
+    AppendPointer(const void* pointer);
+
+  private:
+    Site& m_site;
+    bool m_isFunction;
+    uint32_t m_nArguments;
+    uint32_t m_nLiterals;
+    std::vector<uint8_t>& m_buffer;
+  };
+
+public:
+  static BinaryLog&
+  Instance();
+
+  ~BinaryLog();
+
+  /**
+   * @brief Write the log to \p file instead of the default file
+   */
+  bool
+  Open(const std::string& file);
+
+  /**
+   * @brief Write all buffered records to the log file
+   */
+  void
+  Flush();
+
+  /**
+   * @brief Flush and close the log file
+   */
+  void
+  Close();
+
+  /**
+   * @brief Convert a binary log into NS_LOG text, one line per record in logging order
+   *
+   * Lines have the NS_LOG format with prefix_time, prefix_node, prefix_func and prefix_level.
+   *
+   * Records are numbered in logging order, and the chunks of each component hold increasing
+   * numbers.  The chunk streams of the components are merged by record number: a record is
+   * written as soon as all records before it are decoded, so only records that are ahead of
+   * a not yet written chunk are held in memory.
+   */
+  static bool
+  Decode(std::istream& is, std::ostream& os);
+
+private:
+  BinaryLog();
+
+  struct ComponentBuffer
+  {
+    std::vector<uint8_t> records;
+  };
+
+  bool
+  DoOpen(const std::string& file);
+
+  void
+  DoFlush();
+
+  void
+  DoClose();
+
+  void
+  EnsureOpen();
+
+  void
+  Commit(Site& site, const std::vector<uint8_t>& arguments);
+
+  uint32_t
+  GetLiteralId(Site& site, uint32_t position, const char* literal);
+
+  void
+  WriteEntry(uint8_t type, const std::vector<uint8_t>& entry);
+
+  void
+  WriteLiteral(uint32_t id);
+
+  void
+  WriteChunk(ComponentBuffer& buffer);
+
+private:
+  std::mutex m_mutex;
+  std::ofstream m_os;
+  bool m_isOpen;
+  uint64_t m_nRecords;
+  std::vector<Site*> m_sites;
+  std::vector<ComponentBuffer*> m_siteBuffers; ///< @brief buffer of each site, by site id
+  std::map<std::string, ComponentBuffer> m_buffers;
+  std::map<const char*, uint32_t> m_literals;
+  std::vector<std::string> m_literalTexts; ///< @brief text of each literal, by literal id
+};
+
+} // namespace ndn
+} // namespace ns3
+
+/**
+ * NS_LOG levels above NDN_LOG_COMPILE_LEVEL (--log-compile-level) are removed at compile time:
+ * 1 error, 2 warn, 3 debug, 4 info, 5 function, 6 logic, 7 all (default)
+ */
+#ifndef NDN_LOG_COMPILE_LEVEL
+#define NDN_LOG_COMPILE_LEVEL 7
+#endif
+
+#ifdef NS3_LOG_ENABLE
+
+// `arguments` is empty or a chain of `<< argument`
+#define NDN_BINARY_LOG(level, isFunction, arguments)                                           \
+  do {                                                                                         \
+    if (g_log.IsEnabled(level)) {                                                              \
+      static ::ns3::ndn::BinaryLog::Site ndnBinaryLogSite = {g_log.Name(), level,              \
+                                                             __FUNCTION__, 0};                 \
+      ::ns3::ndn::BinaryLog::Record(ndnBinaryLogSite, isFunction) arguments;                   \
+    }                                                                                          \
+  } while (false)
+
+#define NDN_LOG_DISABLED(msg) do { } while (false)
+
+#if NDN_LOG_COMPILE_LEVEL < 1
+#undef NS_LOG_ERROR
+#define NS_LOG_ERROR(msg) NDN_LOG_DISABLED(msg)
+#elif defined(NS3_BINARY_LOG)
+#undef NS_LOG_ERROR
+#define NS_LOG_ERROR(msg) NDN_BINARY_LOG(::ns3::LOG_ERROR, false, << msg)
+#endif
+
+#if NDN_LOG_COMPILE_LEVEL < 2
+#undef NS_LOG_WARN
+#define NS_LOG_WARN(msg) NDN_LOG_DISABLED(msg)
+#elif defined(NS3_BINARY_LOG)
+#undef NS_LOG_WARN
+#define NS_LOG_WARN(msg) NDN_BINARY_LOG(::ns3::LOG_WARN, false, << msg)
+#endif
+
+#if NDN_LOG_COMPILE_LEVEL < 3
+#undef NS_LOG_DEBUG
+#define NS_LOG_DEBUG(msg) NDN_LOG_DISABLED(msg)
+#elif defined(NS3_BINARY_LOG)
+#undef NS_LOG_DEBUG
+#define NS_LOG_DEBUG(msg) NDN_BINARY_LOG(::ns3::LOG_DEBUG, false, << msg)
+#endif
+
+#if NDN_LOG_COMPILE_LEVEL < 4
+#undef NS_LOG_INFO
+#define NS_LOG_INFO(msg) NDN_LOG_DISABLED(msg)
+#elif defined(NS3_BINARY_LOG)
+#undef NS_LOG_INFO
+#define NS_LOG_INFO(msg) NDN_BINARY_LOG(::ns3::LOG_INFO, false, << msg)
+#endif
+
+#if NDN_LOG_COMPILE_LEVEL < 5
+#undef NS_LOG_FUNCTION
+#undef NS_LOG_FUNCTION_NOARGS
+#define NS_LOG_FUNCTION(parameters) NDN_LOG_DISABLED(parameters)
+#define NS_LOG_FUNCTION_NOARGS() NDN_LOG_DISABLED()
+#elif defined(NS3_BINARY_LOG)
+#undef NS_LOG_FUNCTION
+#undef NS_LOG_FUNCTION_NOARGS
+#define NS_LOG_FUNCTION(parameters) NDN_BINARY_LOG(::ns3::LOG_FUNCTION, true, << parameters)
+#define NS_LOG_FUNCTION_NOARGS() NDN_BINARY_LOG(::ns3::LOG_FUNCTION, true, )
+#endif
+
+#if NDN_LOG_COMPILE_LEVEL < 6
+#undef NS_LOG_LOGIC
+#define NS_LOG_LOGIC(msg) NDN_LOG_DISABLED(msg)
+#elif defined(NS3_BINARY_LOG)
+#undef NS_LOG_LOGIC
+#define NS_LOG_LOGIC(msg) NDN_BINARY_LOG(::ns3::LOG_LOGIC, false, << msg)
+#endif
+
+#endif // NS3_LOG_ENABLE
+
+#endif // NDN_BINARY_LOG_HPP
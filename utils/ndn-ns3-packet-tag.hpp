@@ -24,9 +24,18 @@
 #include "ns3/ptr.h"
 #include <ndn-cxx/tag.hpp>
 
+#include "ndn-fw-hop-count-tag.hpp"
+
 namespace ns3 {
 namespace ndn {
 
+/**
+ * \brief Per-hop metadata of the ns-3 packet from which Interest or Data has been decoded
+ *
+ * The tag copies only the metadata ndnSIM uses (FwHopCountTag) and does not reference the
+ * ns-3 packet, so the packet is released as soon as it has been decoded, even when the
+ * Interest or Data stays in the PIT or CS.
+ */
 class Ns3PacketTag : public ::ndn::Tag {
 public:
   static size_t
@@ -36,18 +45,26 @@ public:
   }
 
   Ns3PacketTag(Ptr<const Packet> packet)
-    : m_packet(packet)
+    : m_hasHopCountTag(packet->PeekPacketTag(m_hopCountTag))
   {
   }
 
-  Ptr<const Packet>
-  getPacket() const
+  /**
+   * \brief Get FwHopCountTag of the packet
+   * \return false if the packet did not have FwHopCountTag
+   */
+  bool
+  peekHopCountTag(FwHopCountTag& tag) const
   {
-    return m_packet;
+    if (m_hasHopCountTag) {
+      tag = m_hopCountTag;
+    }
+    return m_hasHopCountTag;
   }
 
 private:
-  Ptr<const Packet> m_packet;
+  FwHopCountTag m_hopCountTag;
+  bool m_hasHopCountTag;
 };
 
 } // namespace ndn
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDNSIM_UTILS_NDN_OBSERVED_TRACED_CALLBACK_HPP
+#define NDNSIM_UTILS_NDN_OBSERVED_TRACED_CALLBACK_HPP
+
+#include "ns3/traced-callback.h"
+
+#include <functional>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief TracedCallback that reports when it gains its first sink or loses its last one
+ *
+ * Allows the owner of a trace source to produce the traced values only while someone
+ * listens, e.g., to connect per-packet signals lazily.  MakeTraceSourceAccessor uses the
+ * declared type of the member, so sinks connected by the config path are counted as well.
+ *
+ * Disconnecting a sink that was never connected is not detected and counts as a removal.
+ */
+template<typename T1 = empty, typename T2 = empty, typename T3 = empty>
+class ObservedTracedCallback : public TracedCallback<T1, T2, T3> {
+public:
+  typedef std::function<void()> SinksChangedCallback;
+
+  ObservedTracedCallback()
+    : m_nSinks(0)
+  {
+  }
+
+  /**
+   * \brief Set callback invoked after the first sink is connected or the last one removed
+   */
+  void
+  SetSinksChangedCallback(const SinksChangedCallback& callback)
+  {
+    m_sinksChanged = callback;
+  }
+
+  bool
+  HasSinks() const
+  {
+    return m_nSinks > 0;
+  }
+
+  void
+  ConnectWithoutContext(const CallbackBase& callback)
+  {
+    TracedCallback<T1, T2, T3>::ConnectWithoutContext(callback);
+    AddSink();
+  }
+
+  void
+  Connect(const CallbackBase& callback, std::string path)
+  {
+    TracedCallback<T1, T2, T3>::Connect(callback, path);
+    AddSink();
+  }
+
+  void
+  DisconnectWithoutContext(const CallbackBase& callback)
+  {
+    TracedCallback<T1, T2, T3>::DisconnectWithoutContext(callback);
+    RemoveSink();
+  }
+
+  void
+  Disconnect(const CallbackBase& callback, std::string path)
+  {
+    TracedCallback<T1, T2, T3>::Disconnect(callback, path);
+    RemoveSink();
+  }
+
+private:
+  void
+  AddSink()
+  {
+    if (m_nSinks++ == 0 && m_sinksChanged) {
+      m_sinksChanged();
+    }
+  }
+
+  void
+  RemoveSink()
+  {
+    if (m_nSinks > 0 && --m_nSinks == 0 && m_sinksChanged) {
+      m_sinksChanged();
+    }
+  }
+
+private:
+  uint32_t m_nSinks;
+  SinksChangedCallback m_sinksChanged;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_UTILS_NDN_OBSERVED_TRACED_CALLBACK_HPP
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-shared-packet-tag.hpp"
+
+#include <unordered_map>
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+struct SharedPacket
+{
+  shared_ptr<const Interest> interest;
+  shared_ptr<const Data> data;
+  Time expiry;
+};
+
+// number of registered packets between purges of expired references
+const uint64_t PURGE_INTERVAL = 4096;
+
+// lifetime of references in seconds of simulation time
+const double MAX_LIFETIME = 60.0;
+
+uint64_t g_lastId = 0;
+
+std::unordered_map<uint64_t, SharedPacket>&
+getRegistry()
+{
+  static std::unordered_map<uint64_t, SharedPacket> registry;
+  return registry;
+}
+
+uint64_t
+registerPacket(shared_ptr<const Interest> interest, shared_ptr<const Data> data)
+{
+  auto& registry = getRegistry();
+
+  uint64_t id = ++g_lastId;
+  if (id % PURGE_INTERVAL == 0) {
+    Time now = Simulator::Now();
+    for (auto i = registry.begin(); i != registry.end();) {
+      if (i->second.expiry < now) {
+        i = registry.erase(i);
+      }
+      else {
+        ++i;
+      }
+    }
+  }
+
+  registry[id] = SharedPacket{interest, data, Simulator::Now() + Seconds(MAX_LIFETIME)};
+  return id;
+}
+
+template<class Pkt>
+shared_ptr<const Pkt>
+releasePacket(uint64_t id, shared_ptr<const Pkt> SharedPacket::*field)
+{
+  auto& registry = getRegistry();
+
+  auto i = registry.find(id);
+  if (i == registry.end() || i->second.*field == nullptr) {
+    return nullptr;
+  }
+
+  shared_ptr<const Pkt> packet = std::move(i->second.*field);
+  registry.erase(i);
+  return packet;
+}
+
+} // namespace
+
+TypeId
+SharedPacketTag::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::SharedPacketTag").SetParent<Tag>().AddConstructor<SharedPacketTag>();
+  return tid;
+}
+
+TypeId
+SharedPacketTag::GetInstanceTypeId() const
+{
+  return SharedPacketTag::GetTypeId();
+}
+
+SharedPacketTag::SharedPacketTag()
+  : m_id(0)
+{
+}
+
+SharedPacketTag::SharedPacketTag(const Interest& interest)
+  : m_id(registerPacket(interest.shared_from_this(), nullptr))
+{
+}
+
+SharedPacketTag::SharedPacketTag(const Data& data)
+  : m_id(registerPacket(nullptr, data.shared_from_this()))
+{
+}
+
+shared_ptr<const Interest>
+SharedPacketTag::releaseInterest() const
+{
+  return releasePacket(m_id, &SharedPacket::interest);
+}
+
+shared_ptr<const Data>
+SharedPacketTag::releaseData() const
+{
+  return releasePacket(m_id, &SharedPacket::data);
+}
+
+uint32_t
+SharedPacketTag::GetSerializedSize() const
+{
+  return sizeof(uint64_t);
+}
+
+void
+SharedPacketTag::Serialize(TagBuffer i) const
+{
+  i.WriteU64(m_id);
+}
+
+void
+SharedPacketTag::Deserialize(TagBuffer i)
+{
+  m_id = i.ReadU64();
+}
+
+void
+SharedPacketTag::Print(std::ostream& os) const
+{
+  os << m_id;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_SHARED_PACKET_TAG_HPP
+#define NDN_SHARED_PACKET_TAG_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-face
+ * @brief Packet tag that references an already decoded Interest or Data
+ *
+ * Used by NetDeviceLinkService in the shared-packet mode: instead of the encoded packet,
+ * the ns-3 packet carries zero padding of the same size and this tag, and the receiving
+ * node uses the referenced object without decoding it.  Only a number is serialized into
+ * the tag, the referenced packet is kept by a process-wide registry until the receiver
+ * releases it, so the tag is valid only within one simulator process.
+ *
+ * References of packets that never reach the receiver (e.g., dropped by a queue or by an
+ * error model) are purged from the registry after 60 seconds of simulation time.
+ */
+class SharedPacketTag : public Tag {
+public:
+  static TypeId
+  GetTypeId(void);
+
+  /**
+   * @brief Default constructor (empty tag, to be deserialized)
+   */
+  SharedPacketTag();
+
+  /**
+   * @brief Create tag referencing the Interest
+   */
+  explicit
+  SharedPacketTag(const Interest& interest);
+
+  /**
+   * @brief Create tag referencing the Data
+   */
+  explicit
+  SharedPacketTag(const Data& data);
+
+  /**
+   * @brief Get the referenced Interest and release it from the registry
+   * @return the Interest, or nullptr if the tag does not reference an Interest or the
+   *         reference has already been released
+   */
+  shared_ptr<const Interest>
+  releaseInterest() const;
+
+  /**
+   * @brief Get the referenced Data and release it from the registry
+   * @return the Data, or nullptr if the tag does not reference a Data or the reference
+   *         has already been released
+   */
+  shared_ptr<const Data>
+  releaseData() const;
+
+  ////////////////////////////////////////////////////////
+  // from ObjectBase
+  ////////////////////////////////////////////////////////
+  virtual TypeId
+  GetInstanceTypeId() const;
+
+  ////////////////////////////////////////////////////////
+  // from Tag
+  ////////////////////////////////////////////////////////
+
+  virtual uint32_t
+  GetSerializedSize() const;
+
+  virtual void
+  Serialize(TagBuffer i) const;
+
+  virtual void
+  Deserialize(TagBuffer i);
+
+  virtual void
+  Print(std::ostream& os) const;
+
+private:
+  uint64_t m_id;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_SHARED_PACKET_TAG_HPP
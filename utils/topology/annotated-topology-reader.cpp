@@ -69,6 +69,9 @@ AnnotatedTopologyReader::AnnotatedTopologyReader(const std::string& path, double
   , m_randY(CreateObject<UniformRandomVariable>())
   , m_scale(scale)
   , m_requiredPartitions(1)
+  , m_autoPartitioning(false)
+  , m_nPartitions(0)
+  , m_partitioningMode(TopologyPartitioner::MIN_EDGE_CUT)
 {
   NS_LOG_FUNCTION(this);
 
@@ -100,6 +103,15 @@ AnnotatedTopologyReader::SetMobilityModel(const std::string& model)
   m_mobilityFactory.SetTypeId(model);
 }
 
+void
+AnnotatedTopologyReader::SetAutoPartitioning(uint32_t nPartitions, TopologyPartitioner::Mode mode)
+{
+  NS_LOG_FUNCTION(this << nPartitions << mode);
+  m_autoPartitioning = true;
+  m_nPartitions = nPartitions;
+  m_partitioningMode = mode;
+}
+
 AnnotatedTopologyReader::~AnnotatedTopologyReader()
 {
   NS_LOG_FUNCTION(this);
@@ -174,6 +186,14 @@ AnnotatedTopologyReader::Read(void)
     return m_nodes;
   }
 
+  struct Router {
+    string name;
+    double latitude;
+    double longitude;
+    uint32_t systemId;
+  };
+  vector<Router> routers;
+
   while (!topgen.eof()) {
     string line;
     getline(topgen, line);
@@ -183,41 +203,87 @@ AnnotatedTopologyReader::Read(void)
       break; // stop reading nodes
 
     istringstream lineBuffer(line);
-    string name, city;
-    double latitude = 0, longitude = 0;
-    uint32_t systemId = 0;
+    string city;
+    Router router = {"", 0, 0, 0};
+
+    lineBuffer >> router.name >> city >> router.latitude >> router.longitude >> router.systemId;
+    if (router.name.empty())
+      continue;
+
+    routers.push_back(router);
+  }
 
-    lineBuffer >> name >> city >> latitude >> longitude >> systemId;
-    if (name.empty())
+  bool hasLinks = !topgen.eof();
+  vector<string> linkLines;
+  while (!topgen.eof()) {
+    string line;
+    getline(topgen, line);
+    if (line == "")
       continue;
+    if (line[0] == '#')
+      continue; // comments
+
+    linkLines.push_back(line);
+  }
+
+  if (m_autoPartitioning) {
+    TopologyPartitioner partitioner;
+    map<string, uint32_t> index;
+    for (const Router& router : routers) {
+      index[router.name] = partitioner.AddNode(router.latitude, router.longitude);
+    }
+
+    // links without a delay get the channel default
+    double defaultDelay = TopologyPartitioner::GetDefaultLinkDelay();
+    for (const string& line : linkLines) {
+      istringstream lineBuffer(line);
+      string from, to, capacity, metric, delay;
+      lineBuffer >> from >> to >> capacity >> metric >> delay;
+
+      map<string, uint32_t>::iterator fromIt = index.find(from);
+      map<string, uint32_t>::iterator toIt = index.find(to);
+      if (fromIt == index.end() || toIt == index.end())
+        continue; // reported when links are created
+
+      double linkDelay = TopologyPartitioner::ParseDelay(delay);
+      partitioner.AddLink(fromIt->second, toIt->second, linkDelay >= 0 ? linkDelay : defaultDelay);
+    }
+
+    uint32_t nPartitions =
+      m_nPartitions > 0 ? m_nPartitions : TopologyPartitioner::GetDefaultPartitions();
+    vector<uint32_t> systemIds = partitioner.Partition(nPartitions, m_partitioningMode);
+    if (partitioner.GetLookahead(systemIds) == 0) {
+      NS_FATAL_ERROR("Automatic partitioning of " << GetFileName()
+                     << " cuts links with zero delay, the MPI simulator would have no lookahead");
+    }
+    for (size_t i = 0; i < routers.size(); ++i) {
+      routers[i].systemId = systemIds[i];
+    }
+  }
 
+  for (const Router& router : routers) {
     Ptr<Node> node;
 
-    if (abs(latitude) > 0.001 && abs(latitude) > 0.001)
-      node = CreateNode(name, m_scale * longitude, -m_scale * latitude, systemId);
+    if (abs(router.latitude) > 0.001 && abs(router.latitude) > 0.001)
+      node = CreateNode(router.name, m_scale * router.longitude, -m_scale * router.latitude,
+                        router.systemId);
     else {
       Ptr<UniformRandomVariable> var = CreateObject<UniformRandomVariable>();
-      node = CreateNode(name, var->GetValue(0, 200), var->GetValue(0, 200), systemId);
+      node = CreateNode(router.name, var->GetValue(0, 200), var->GetValue(0, 200),
+                        router.systemId);
       // node = CreateNode (name, systemId);
     }
   }
 
   map<string, set<string>> processedLinks; // to eliminate duplications
 
-  if (topgen.eof()) {
+  if (!hasLinks) {
     NS_LOG_ERROR("Topology file " << GetFileName() << " does not have \"link\" section");
     return m_nodes;
   }
 
   // SeekToSection ("link");
-  while (!topgen.eof()) {
-    string line;
-    getline(topgen, line);
-    if (line == "")
-      continue;
-    if (line[0] == '#')
-      continue; // comments
-
+  for (const string& line : linkLines) {
     // NS_LOG_DEBUG ("Input: [" << line << "]");
 
     istringstream lineBuffer(line);
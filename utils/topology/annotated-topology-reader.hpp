@@ -26,6 +26,8 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/object-factory.h"
 
+#include "topology-partitioner.hpp"
+
 namespace ns3 {
 
 /**
@@ -97,6 +99,21 @@ public:
   virtual void
   SetMobilityModel(const std::string& model);
 
+  /**
+   * \brief Assign nodes to MPI partitions automatically instead of using systemId column
+   *
+   * Must be called before Read().
+   *
+   * \param nPartitions number of partitions; 0 selects the number of MPI ranks (1 without MPI)
+   * \param mode balanced minimum edge cut weighted by link delay, or geographic bisection
+   *             using latitude/longitude columns
+   *
+   * \see TopologyPartitioner
+   */
+  void
+  SetAutoPartitioning(uint32_t nPartitions = 0,
+                      TopologyPartitioner::Mode mode = TopologyPartitioner::MIN_EDGE_CUT);
+
   /**
    * \brief Apply OSPF metric on Ipv4 (if exists) and Ccnx (if exists) stacks
    */
@@ -147,6 +164,10 @@ private:
   double m_scale;
 
   uint32_t m_requiredPartitions;
+
+  bool m_autoPartitioning;
+  uint32_t m_nPartitions;
+  TopologyPartitioner::Mode m_partitioningMode;
 };
 }
 
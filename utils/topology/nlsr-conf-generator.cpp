@@ -0,0 +1,766 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "nlsr-conf-generator.hpp"
+
+#include "ns3/log.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/info_parser.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+NS_LOG_COMPONENT_DEFINE("ndn.NlsrConfGenerator");
+
+namespace ns3 {
+namespace ndn {
+
+namespace pt = boost::property_tree;
+
+// Pool of threads that build and write per-node NLSR configuration files.
+class NlsrConfGenerator::NodeConfigWriter
+{
+public:
+  NodeConfigWriter(const NlsrConfGenerator& generator, size_t nThreads)
+    : m_generator(generator)
+    , m_isDone(false)
+  {
+    for (size_t i = 0; i < nThreads; ++i) {
+      m_workers.push_back(std::thread(&NodeConfigWriter::Run, this));
+    }
+  }
+
+  ~NodeConfigWriter()
+  {
+    Finish();
+  }
+
+  // Queue file of BRITE router \p id with its neighbors, blocks while the queue is full.
+  void
+  Write(const std::string& id, std::vector<std::string> neighbors)
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [this] { return m_queue.size() < MAX_QUEUE_SIZE; });
+    m_queue.push_back(std::make_pair(id, std::move(neighbors)));
+    m_notEmpty.notify_one();
+  }
+
+  // Wait until all queued files are written.
+  void
+  Finish()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isDone = true;
+    }
+    m_notEmpty.notify_all();
+    for (std::thread& worker : m_workers) {
+      worker.join();
+    }
+    m_workers.clear();
+  }
+
+private:
+  void
+  Run()
+  {
+    while (true) {
+      std::pair<std::string, std::vector<std::string> > job;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return !m_queue.empty() || m_isDone; });
+        if (m_queue.empty()) {
+          return;
+        }
+        job = std::move(m_queue.front());
+        m_queue.pop_front();
+      }
+      m_notFull.notify_one();
+
+      m_generator.WriteBriteNodeConfig(job.first, job.second);
+    }
+  }
+
+private:
+  static const size_t MAX_QUEUE_SIZE = 1024;
+
+  const NlsrConfGenerator& m_generator;
+  std::mutex m_mutex;
+  std::condition_variable m_notEmpty;
+  std::condition_variable m_notFull;
+  std::deque<std::pair<std::string, std::vector<std::string> > > m_queue;
+  std::vector<std::thread> m_workers;
+  bool m_isDone;
+};
+
+NlsrConfGenerator::NlsrConfGenerator(const std::string& outputDir, const std::string& rtType,
+                                     const std::string& homeDir)
+  : m_outputDir(outputDir)
+  , m_rtType(rtType)
+  , m_homeDir(homeDir)
+{
+}
+
+std::string
+NlsrConfGenerator::GetNodeConfigFileName(const std::string& nodeId) const
+{
+  return (boost::filesystem::path(m_outputDir) / ("nlsr_node_" + nodeId + ".conf")).string();
+}
+
+std::string
+NlsrConfGenerator::GetSimConfigFileName() const
+{
+  return (boost::filesystem::path(m_outputDir) / "nlsr_sim.conf").string();
+}
+
+NlsrConfGenerator::ConfigSection
+NlsrConfGenerator::MakeBriteNodeConfig(const std::string& id) const
+{
+  std::string nodeId = "N" + id;
+  std::string city = "NA";
+  std::string latitude = "3";
+  std::string longitude = "1";
+  std::string network = "/n";
+  std::string site = "/e";
+  std::string router = "/%C1r" + id;
+  std::string lsaRefreshTime = "1800";
+  std::string routerDeadInterval = "3600";
+  std::string lsaInterestLifetime = "4";
+  std::string logLevel = "INFO";
+  std::string logDir = m_homeDir + "/log/" + nodeId + "/nlsr";
+  std::string seqDir = m_homeDir + "/log/" + nodeId + "/nlsr";
+  std::string helloRetries = "2";
+  std::string helloTimeout = "5";
+  std::string helloInterval = "60";
+  std::string adjLsaBuildInterval = "5";
+  std::string firstHelloInterval = "10";
+  std::string state;
+  std::string radius;
+  std::string angle;
+
+  if (m_rtType.compare("hb") == 0) {
+    state = "on";
+    radius = std::string("10") + id;
+    angle = id;
+  }
+  else {
+    state = "off";
+    radius = "123.456";
+    angle = "1.45";
+  }
+  std::string maxFacesPerPrefix = "3";
+  std::string routingCalcInterval = "15";
+  std::string prefix1 = "/n/e/" + nodeId + "/p1";
+  std::string prefix2 = "/n/e/" + nodeId + "/p2";
+
+  NS_LOG_DEBUG("Router: " << nodeId << " " << city << " " << latitude << " " << longitude << " "
+               << network << " " << site << " " << router << " " << lsaRefreshTime << " "
+               << routerDeadInterval << " " << lsaInterestLifetime << " " << logLevel << " "
+               << logDir << " " << seqDir << " " << helloRetries << " " << helloTimeout << " "
+               << helloInterval << " " << adjLsaBuildInterval << " " << firstHelloInterval << " "
+               << state << " " << radius << " " << angle << " " << maxFacesPerPrefix << " "
+               << routingCalcInterval << " " << prefix1 << " " << prefix2);
+
+  // Add General config
+  ConfigSection nt;
+  nt.put("general.node-id", nodeId);
+  nt.put("general.city", city);
+  nt.put("general.latitude", latitude);
+  nt.put("general.longitude", longitude);
+  nt.put("general.network", network);
+  nt.put("general.site", site);
+  nt.put("general.router", router);
+  nt.put("general.lsa-refresh-time", lsaRefreshTime);
+  nt.put("general.router-dead-interval", routerDeadInterval);
+  nt.put("general.lsa-interest-lifetime", lsaInterestLifetime);
+  nt.put("general.log-level", logLevel);
+  nt.put("general.log-dir", logDir);
+  nt.put("general.seq-dir", seqDir);
+
+  // Add Neighbors config
+  nt.put("neighbors.hello-retries", helloRetries);
+  nt.put("neighbors.hello-timeout", helloTimeout);
+  nt.put("neighbors.hello-interval", helloInterval);
+  nt.put("neighbors.adj-lsa-build-interval", adjLsaBuildInterval);
+  nt.put("neighbors.first-hello-interval", firstHelloInterval);
+
+  // Add Hyperbolic config
+  nt.put("hyperbolic.state", state);
+  nt.put("hyperbolic.radius", radius);
+  nt.put("hyperbolic.angle", angle);
+
+  // Add Fib config
+  nt.put("fib.max-faces-per-prefix", maxFacesPerPrefix);
+  nt.put("fib.routing-calc-interval", routingCalcInterval);
+
+  // Add Advertising config
+  nt.add("advertising.prefix", prefix1);
+  nt.add("advertising.prefix", prefix2);
+
+  // Add Security config
+  nt.put("security.validator.trust-anchor.type", "any");
+  nt.put("security.prefix-update-validator.trust-anchor.type", "any");
+
+  return nt;
+}
+
+void
+NlsrConfGenerator::AddBriteNeighbor(ConfigSection& nt, const std::string& id)
+{
+  std::string nodeId = "N" + id;
+  std::string name = "/n/e/%C1r" + id;
+  std::string faceUri = "tcp4://10.0.0." + id + ":6363";
+  std::string linkCost = "25";
+  std::string bandwidth = "100";
+  std::string metric = "1";
+  std::string delay = "0";
+  std::string queue = "1000";
+
+  ConfigSection& nbr = nt.get_child("neighbors");
+
+  // Add neighbor
+  ConfigSection nb;
+  nb.add("node-id", nodeId);
+  nb.add("name", name);
+  nb.add("face-uri", faceUri);
+  nb.add("link-cost", linkCost);
+  nb.add("bandwidth", bandwidth);
+  nb.add("metric", metric);
+  nb.add("delay", delay);
+  nb.add("queue", queue);
+  nbr.add_child("neighbor", nb);
+}
+
+void
+NlsrConfGenerator::WriteBriteNodeConfig(const std::string& id,
+                                        const std::vector<std::string>& neighbors) const
+{
+  ConfigSection nt = MakeBriteNodeConfig(id);
+  for (const std::string& neighbor : neighbors) {
+    AddBriteNeighbor(nt, neighbor);
+  }
+  pt::write_info(GetNodeConfigFileName("N" + id), nt);
+}
+
+void
+NlsrConfGenerator::WriteSimConfig(std::vector<std::string> nodeIds) const
+{
+  // Same order as a std::map keyed by node id.
+  std::sort(nodeIds.begin(), nodeIds.end());
+  nodeIds.erase(std::unique(nodeIds.begin(), nodeIds.end()), nodeIds.end());
+
+  ConfigSection simTree;
+  for (const std::string& nodeId : nodeIds) {
+    ConfigSection nodeTree;
+    nodeTree.add("node-id", nodeId);
+    nodeTree.add("nlsr-config", GetNodeConfigFileName(nodeId));
+    simTree.add_child("ndn-node", nodeTree);
+  }
+
+  pt::write_info(GetSimConfigFileName(), simTree);
+}
+
+bool
+NlsrConfGenerator::ProcessBriteTopology(const std::string& file) const
+{
+  std::ifstream topgen(file.c_str());
+  typedef std::map<std::string, ConfigSection> NodeConfigMap;
+  NodeConfigMap nodeMap;
+
+  if (!topgen.is_open() || !topgen.good()) {
+    NS_FATAL_ERROR("Cannot open file " << file << " for reading");
+    return false;
+  }
+
+  while (!topgen.eof()) {
+    std::string line;
+    getline(topgen, line);
+    NS_LOG_INFO("Brite config line: " << line);
+
+    if (line.compare(0, 6, "Nodes:") == 0)
+      break;
+  }
+
+  if (topgen.eof()) {
+    NS_FATAL_ERROR("BRITE topology config file " << file << " does not have \"Nodes\" section");
+    return false;
+  }
+
+  // Read network 'Node' configuration.
+  while (!topgen.eof()) {
+    std::string line;
+    getline(topgen, line);
+
+    if (line[0] == ';')
+      continue;
+    if (line.compare(0, 6, "Edges:") == 0)
+      break;
+
+    std::istringstream linebuffer(line);
+    std::string nodeId;
+    linebuffer >> nodeId;
+
+    if (nodeId.empty())
+      continue;
+
+    // Save the tree object for later on.
+    nodeMap["N" + nodeId] = MakeBriteNodeConfig(nodeId);
+
+    if (topgen.eof()) {
+      NS_FATAL_ERROR("BRITE topology config file " << file << " does not have \"Edge\" section");
+      return false;
+    }
+  }
+
+  // Read network 'Link' configuration.
+  while (!topgen.eof()) {
+    std::string line;
+    getline(topgen, line);
+
+    if (line[0] == ';')
+      continue;
+
+    std::istringstream linebuffer(line);
+    std::string edgeId, srcId, dstId;
+    linebuffer >> edgeId >> srcId >> dstId;
+
+    if (edgeId.empty())
+      continue;
+
+    NS_LOG_DEBUG("Adjacent router: N" << srcId << " N" << dstId);
+
+    // Establish full-duplex link between adjacent nodes.
+    NodeConfigMap::iterator it = nodeMap.find("N" + srcId);
+    if (it != nodeMap.end()) {
+      AddBriteNeighbor(it->second, dstId);
+    }
+
+    it = nodeMap.find("N" + dstId);
+    if (it != nodeMap.end()) {
+      AddBriteNeighbor(it->second, srcId);
+    }
+  }
+
+  // Generate the NLSR configuration file
+  std::vector<std::string> nodeIds;
+  for (NodeConfigMap::iterator it = nodeMap.begin(); it != nodeMap.end(); ++it) {
+    pt::write_info(GetNodeConfigFileName(it->first), it->second);
+    nodeIds.push_back(it->first);
+  }
+
+  WriteSimConfig(nodeIds);
+
+  return true;
+}
+
+// A node's file is handed to the writer pool as soon as the number of edges read for it
+// reaches the degree given in the BRITE "Nodes" section.  A node that receives more edges than
+// announced is rewritten after all edges are read, its neighbors are then collected by reading
+// the "Edges" section again.
+bool
+NlsrConfGenerator::ProcessBriteTopologyStreaming(const std::string& file, size_t nThreads) const
+{
+  struct BriteNode
+  {
+    std::string id;
+    uint32_t degree;
+    uint32_t nEdges;
+    std::vector<std::string> neighbors;
+    bool isWritten;
+    bool isStale;
+  };
+
+  std::ifstream topgen(file.c_str());
+  std::vector<BriteNode> nodes;
+  std::map<std::string, size_t> nodeIndex;
+
+  if (!topgen.is_open() || !topgen.good()) {
+    NS_FATAL_ERROR("Cannot open file " << file << " for reading");
+    return false;
+  }
+
+  while (!topgen.eof()) {
+    std::string line;
+    getline(topgen, line);
+
+    if (line.compare(0, 6, "Nodes:") == 0)
+      break;
+  }
+
+  if (topgen.eof()) {
+    NS_FATAL_ERROR("BRITE topology config file " << file << " does not have \"Nodes\" section");
+    return false;
+  }
+
+  NodeConfigWriter writer(*this, nThreads);
+
+  // Read network 'Node' configuration.
+  while (!topgen.eof()) {
+    std::string line;
+    getline(topgen, line);
+
+    if (line[0] == ';')
+      continue;
+    if (line.compare(0, 6, "Edges:") == 0)
+      break;
+
+    std::istringstream linebuffer(line);
+    std::string nodeId;
+    double xpos = 0, ypos = 0;
+    uint32_t indegree = 0, outdegree = 0;
+    linebuffer >> nodeId >> xpos >> ypos >> indegree >> outdegree;
+
+    if (nodeId.empty())
+      continue;
+
+    if (topgen.eof()) {
+      NS_FATAL_ERROR("BRITE topology config file " << file << " does not have \"Edge\" section");
+      return false;
+    }
+
+    if (nodeIndex.count(nodeId) > 0)
+      continue;
+
+    nodeIndex[nodeId] = nodes.size();
+    BriteNode node = {nodeId, outdegree, 0, std::vector<std::string>(), false, false};
+    nodes.push_back(node);
+
+    if (outdegree == 0) {
+      writer.Write(nodeId, std::vector<std::string>());
+      nodes.back().isWritten = true;
+    }
+  }
+
+  std::streampos edgesPos = topgen.tellg();
+  bool hasStaleNodes = false;
+
+  // Read network 'Link' configuration.
+  auto addNeighbor = [&] (const std::string& nodeId, const std::string& neighborId) {
+    std::map<std::string, size_t>::iterator it = nodeIndex.find(nodeId);
+    if (it == nodeIndex.end())
+      return;
+
+    BriteNode& node = nodes[it->second];
+    ++node.nEdges;
+    if (node.isWritten) {
+      node.isStale = true;
+      hasStaleNodes = true;
+      return;
+    }
+
+    node.neighbors.push_back(neighborId);
+    if (node.nEdges == node.degree) {
+      writer.Write(node.id, std::move(node.neighbors));
+      std::vector<std::string>().swap(node.neighbors);
+      node.isWritten = true;
+    }
+  };
+
+  while (!topgen.eof()) {
+    std::string line;
+    getline(topgen, line);
+
+    if (line[0] == ';')
+      continue;
+
+    std::istringstream linebuffer(line);
+    std::string edgeId, srcId, dstId;
+    linebuffer >> edgeId >> srcId >> dstId;
+
+    if (edgeId.empty())
+      continue;
+
+    // Establish full-duplex link between adjacent nodes.
+    addNeighbor(srcId, dstId);
+    addNeighbor(dstId, srcId);
+  }
+
+  // Nodes with fewer edges than announced.
+  for (BriteNode& node : nodes) {
+    if (!node.isWritten) {
+      writer.Write(node.id, std::move(node.neighbors));
+      std::vector<std::string>().swap(node.neighbors);
+      node.isWritten = true;
+    }
+  }
+
+  // Nodes with more edges than announced.
+  if (hasStaleNodes) {
+    NS_LOG_INFO("BRITE degrees in " << file << " do not match the edges, reading edges again");
+
+    std::map<size_t, std::vector<std::string> > staleNeighbors;
+    auto addStaleNeighbor = [&] (const std::string& nodeId, const std::string& neighborId) {
+      std::map<std::string, size_t>::iterator it = nodeIndex.find(nodeId);
+      if (it != nodeIndex.end() && nodes[it->second].isStale) {
+        staleNeighbors[it->second].push_back(neighborId);
+      }
+    };
+
+    topgen.clear();
+    topgen.seekg(edgesPos);
+    while (!topgen.eof()) {
+      std::string line;
+      getline(topgen, line);
+
+      if (line[0] == ';')
+        continue;
+
+      std::istringstream linebuffer(line);
+      std::string edgeId, srcId, dstId;
+      linebuffer >> edgeId >> srcId >> dstId;
+
+      if (edgeId.empty())
+        continue;
+
+      addStaleNeighbor(srcId, dstId);
+      addStaleNeighbor(dstId, srcId);
+    }
+
+    // The first, incomplete file of a stale node may still be queued.
+    writer.Finish();
+    for (auto& stale : staleNeighbors) {
+      WriteBriteNodeConfig(nodes[stale.first].id, stale.second);
+    }
+  }
+  writer.Finish();
+
+  std::vector<std::string> nodeIds;
+  for (const BriteNode& node : nodes) {
+    nodeIds.push_back("N" + node.id);
+  }
+
+  WriteSimConfig(nodeIds);
+
+  return true;
+}
+
+bool
+NlsrConfGenerator::ProcessBulkConfig(const std::string& file) const
+{
+  // Adjacency lines [offset, offset + nLines) of one source router.
+  struct LineRun
+  {
+    std::streampos offset;
+    size_t nLines;
+  };
+  typedef std::map<std::string, std::vector<LineRun> > AdjacencyRuns;
+
+  std::ifstream topgen(file.c_str());
+
+  if (!topgen.is_open() || !topgen.good()) {
+    NS_FATAL_ERROR("Cannot open file " << file << " for reading");
+    return false;
+  }
+
+  while (!topgen.eof()) {
+    std::string line;
+    getline(topgen, line);
+
+    if (line == "ndn-routers")
+      break;
+  }
+
+  if (topgen.eof()) {
+    NS_FATAL_ERROR("Bulk config file " << file << " does not have \"ndn-routers\" section");
+    return false;
+  }
+
+  std::streampos routersPos = topgen.tellg();
+
+  // First pass: offsets of the adjacency lines of every source router.  Lines of the same
+  // router are usually consecutive and are recorded as one run.
+  while (!topgen.eof()) {
+    std::string line;
+    getline(topgen, line);
+
+    if (line == "adjacency-matrix")
+      break;
+  }
+
+  if (topgen.eof()) {
+    NS_LOG_ERROR("Bulk config file " << file << " does not have \"adjacency matrix\" section");
+    return false;
+  }
+
+  AdjacencyRuns adjacencyRuns;
+  std::string lastSrcNodeId;
+  while (!topgen.eof()) {
+    std::streampos offset = topgen.tellg();
+    std::string line;
+    getline(topgen, line);
+
+    if (line[0] == ';')
+      continue;
+
+    std::istringstream linebuffer(line);
+    std::string srcNodeId;
+    linebuffer >> srcNodeId;
+
+    if (srcNodeId.empty())
+      continue;
+
+    std::vector<LineRun>& runs = adjacencyRuns[srcNodeId];
+    if (srcNodeId == lastSrcNodeId) {
+      ++runs.back().nLines;
+    }
+    else {
+      LineRun run = {offset, 1};
+      runs.push_back(run);
+    }
+    lastSrcNodeId = srcNodeId;
+  }
+
+  // Second pass: build and write one router at a time.
+  std::ifstream adjacency(file.c_str());
+  std::vector<std::string> nodeIds;
+
+  topgen.clear();
+  topgen.seekg(routersPos);
+  while (!topgen.eof()) {
+    std::string line;
+    getline(topgen, line);
+
+    if (line[0] == ';')
+      continue;
+    if (line == "adjacency-matrix")
+      break;
+
+    std::istringstream linebuffer(line);
+    std::string nodeId, city, latitude, longitude, network, site, router, lsaRefreshTime,
+      routerDeadInterval, lsaInterestLifetime, logLevel, logDir, seqDir, helloRetries,
+      helloTimeout, helloInterval, adjLsaBuildInterval, firstHelloInterval, state, radius,
+      angle, maxFacesPerPrefix, routingCalcInterval, prefix1, prefix2;
+
+    linebuffer >> nodeId >> city >> latitude >> longitude >> network >> site >> router
+               >> lsaRefreshTime >> routerDeadInterval >> lsaInterestLifetime >> logLevel
+               >> logDir >> seqDir >> helloRetries >> helloTimeout >> helloInterval
+               >> adjLsaBuildInterval >> firstHelloInterval >> state >> radius >> angle
+               >> maxFacesPerPrefix >> routingCalcInterval >> prefix1 >> prefix2;
+
+    if (nodeId.empty())
+      continue;
+
+    NS_LOG_DEBUG("Router: " << nodeId << " " << city << " " << latitude << " " << longitude << " "
+                 << network << " " << site << " " << router << " " << lsaRefreshTime << " "
+                 << routerDeadInterval << " " << lsaInterestLifetime << " " << logLevel << " "
+                 << logDir << " " << seqDir << " " << helloRetries << " " << helloTimeout << " "
+                 << helloInterval << " " << adjLsaBuildInterval << " " << firstHelloInterval
+                 << " " << state << " " << radius << " " << angle << " " << maxFacesPerPrefix
+                 << " " << routingCalcInterval << " " << prefix1 << " " << prefix2);
+
+    // Add General config
+    ConfigSection nt;
+    nt.put("general.node-id", nodeId);
+    nt.put("general.city", city);
+    nt.put("general.latitude", latitude);
+    nt.put("general.longitude", longitude);
+    nt.put("general.network", network);
+    nt.put("general.site", site);
+    nt.put("general.router", router);
+    nt.put("general.lsa-refresh-time", lsaRefreshTime);
+    nt.put("general.router-dead-interval", routerDeadInterval);
+    nt.put("general.lsa-interest-lifetime", lsaInterestLifetime);
+    nt.put("general.log-level", logLevel);
+    nt.put("general.log-dir", logDir);
+    nt.put("general.seq-dir", seqDir);
+
+    // Add Neighbors config
+    nt.put("neighbors.hello-retries", helloRetries);
+    nt.put("neighbors.hello-timeout", helloTimeout);
+    nt.put("neighbors.hello-interval", helloInterval);
+    nt.put("neighbors.adj-lsa-build-interval", adjLsaBuildInterval);
+    nt.put("neighbors.first-hello-interval", firstHelloInterval);
+
+    // Add Hyperbolic config
+    nt.put("hyperbolic.state", state);
+    nt.put("hyperbolic.radius", radius);
+    nt.put("hyperbolic.angle", angle);
+
+    // Add Fib config
+    nt.put("fib.max-faces-per-prefix", maxFacesPerPrefix);
+    nt.put("fib.routing-calc-interval", routingCalcInterval);
+
+    // Add Advertising config
+    nt.add("advertising.prefix", prefix1);
+    nt.add("advertising.prefix", prefix2);
+
+    // Add Security config
+    nt.put("security.validator.trust-anchor.type", "any");
+    nt.put("security.prefix-update-validator.trust-anchor.type", "any");
+
+    ConfigSection& nbr = nt.get_child("neighbors");
+    AdjacencyRuns::const_iterator runs = adjacencyRuns.find(nodeId);
+    for (size_t r = 0; runs != adjacencyRuns.end() && r < runs->second.size(); ++r) {
+      const LineRun& run = runs->second[r];
+      adjacency.clear();
+      adjacency.seekg(run.offset);
+      for (size_t i = 0; i < run.nLines; ) {
+        std::string adjLine;
+        getline(adjacency, adjLine);
+
+        if (adjLine[0] == ';')
+          continue;
+
+        std::istringstream adjbuffer(adjLine);
+        std::string srcNodeId, dstNodeId, name, faceUri, linkCost, bandwidth, metric, delay,
+          queue;
+        adjbuffer >> srcNodeId >> dstNodeId >> name >> faceUri >> linkCost >> bandwidth
+                  >> metric >> delay >> queue;
+
+        if (srcNodeId.empty())
+          continue;
+        ++i;
+
+        NS_LOG_DEBUG("Adjacent router: " << srcNodeId << " " << dstNodeId << " " << name << " "
+                     << faceUri << " " << linkCost << " " << bandwidth << " " << metric << " "
+                     << delay << " " << queue);
+
+        // Add neighbor
+        ConfigSection nb;
+        nb.add("node-id", dstNodeId);
+        nb.add("name", name);
+        nb.add("face-uri", faceUri);
+        nb.add("link-cost", linkCost);
+        nb.add("bandwidth", bandwidth);
+        nb.add("metric", metric);
+        nb.add("delay", delay);
+        nb.add("queue", queue);
+        nbr.add_child("neighbor", nb);
+      }
+    }
+
+    // Generate the NLSR configuration file
+    pt::write_info(GetNodeConfigFileName(nodeId), nt);
+    nodeIds.push_back(nodeId);
+  }
+
+  WriteSimConfig(nodeIds);
+
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NLSR_CONF_GENERATOR_HPP
+#define NLSR_CONF_GENERATOR_HPP
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Generates per-node NLSR configuration files and the NlsrConfReader topology file
+ *
+ * Router \c N<id> gets the file \c nlsr_node_N<id>.conf in the output directory, and
+ * \c nlsr_sim.conf lists all generated routers in node id order.
+ *
+ * ProcessBriteTopology keeps the configuration of every router in memory until all edges are
+ * read.  ProcessBriteTopologyStreaming and ProcessBulkConfig produce the same files, but write
+ * each router's file as soon as its neighbors are known:
+ *
+ * - BRITE files list all edges after all nodes, so the streaming reader keeps the ids and
+ *   degrees of all nodes (O(V)) and the neighbor lists of nodes whose edges are not all read
+ *   yet.  A node's neighbor list is released when its file is queued.
+ * - Bulk configuration files are read twice.  The first pass records file offsets of the
+ *   adjacency lines of every router, the second pass writes the router files one at a time.
+ */
+class NlsrConfGenerator
+{
+public:
+  typedef boost::property_tree::ptree ConfigSection;
+
+  /**
+   * \param outputDir directory for the generated files
+   * \param rtType routing type, "hb" for hyperbolic, otherwise link-state
+   * \param homeDir base of the log and sequence number directories of generated BRITE routers
+   */
+  NlsrConfGenerator(const std::string& outputDir, const std::string& rtType,
+                    const std::string& homeDir);
+
+  /**
+   * \brief Generate configuration files for routers of a BRITE topology
+   */
+  bool
+  ProcessBriteTopology(const std::string& file) const;
+
+  /**
+   * \brief Same output as ProcessBriteTopology, files are written by \p nThreads threads
+   *        while the topology is read
+   */
+  bool
+  ProcessBriteTopologyStreaming(const std::string& file, size_t nThreads) const;
+
+  /**
+   * \brief Generate configuration files for routers of a bulk configuration file
+   *
+   * The file has an "ndn-routers" section with one router per line, followed by an
+   * "adjacency-matrix" section with one directed link per line.
+   */
+  bool
+  ProcessBulkConfig(const std::string& file) const;
+
+  std::string
+  GetNodeConfigFileName(const std::string& nodeId) const;
+
+  std::string
+  GetSimConfigFileName() const;
+
+private:
+  class NodeConfigWriter;
+
+  // NLSR configuration of BRITE router \p id, with an empty neighbor list.
+  ConfigSection
+  MakeBriteNodeConfig(const std::string& id) const;
+
+  // Add BRITE router \p id as a neighbor to NLSR configuration \p nt.
+  static void
+  AddBriteNeighbor(ConfigSection& nt, const std::string& id);
+
+  void
+  WriteBriteNodeConfig(const std::string& id, const std::vector<std::string>& neighbors) const;
+
+  void
+  WriteSimConfig(std::vector<std::string> nodeIds) const;
+
+private:
+  std::string m_outputDir;
+  std::string m_rtType;
+  std::string m_homeDir;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NLSR_CONF_GENERATOR_HPP
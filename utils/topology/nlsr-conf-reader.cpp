@@ -22,6 +22,9 @@
 #include <iostream>
 #include <fstream>
 #include <stdlib.h>
+#include <cmath>
+#include <atomic>
+#include <thread>
 
 #include <ndn-cxx/name.hpp>
 #include <ndn-cxx/util/face-uri.hpp>
@@ -50,6 +53,8 @@
 #include "ns3/uinteger.h"
 #include "ns3/ipv4-address.h"
 #include "model/ndn-l3-protocol.hpp"
+#include "helper/ndn-fib-helper.hpp"
+#include "daemon/fw/forwarder.hpp"
 #include "ns3/random-variable-stream.h"
 #include "ns3/error-model.h"
 #include "ns3/double.h"
@@ -72,6 +77,11 @@
 #include "apps/ndn-nlsr-app.hpp"
 
 #include "nlsr-conf-reader.hpp"
+#include "nlsr-routing-oracle.hpp"
+
+#ifdef NS3_MPI
+#include <ns3/mpi-interface.h>
+#endif
 
 NS_LOG_COMPONENT_DEFINE("ndn.NlsrConfReader");
 
@@ -186,6 +196,9 @@ NlsrConfReader::NlsrConfReader (const std::string &path, double scale/*=1.0*/)
   , m_randY(CreateObject<UniformRandomVariable>())
   , m_scale (scale)
   , m_requiredPartitions (1)
+  , m_autoPartitioning (false)
+  , m_nPartitions (0)
+  , m_partitioningMode (TopologyPartitioner::MIN_EDGE_CUT)
 {
   m_path = m_confFileName;
 
@@ -200,6 +213,15 @@ NlsrConfReader::NlsrConfReader (const std::string &path, double scale/*=1.0*/)
   SetMobilityModel ("ns3::ConstantPositionMobilityModel");
 }
 
+void
+NlsrConfReader::SetAutoPartitioning (uint32_t nPartitions, TopologyPartitioner::Mode mode)
+{
+  NS_LOG_FUNCTION (this << nPartitions << mode);
+  m_autoPartitioning = true;
+  m_nPartitions = nPartitions;
+  m_partitioningMode = mode;
+}
+
 NlsrConfReader::~NlsrConfReader ()
 {
   NS_LOG_FUNCTION (this);
@@ -220,14 +242,79 @@ NlsrConfReader::ProcessConfFile()
   ret = Load(inputFile);
   inputFile.close();
 
+  // Per-node files referenced by ndn-node sections.
+  while (ret && !m_nodeConfigFiles.empty()) {
+    LoadNodeConfigs();
+  }
+
   return ret;
 }
 
+void
+NlsrConfReader::LoadNodeConfigs()
+{
+  struct ParsedConfig
+  {
+    bool isOpen = false;
+    bool isParsed = false;
+    ConfigSection pt;
+  };
+
+  std::vector<std::string> files;
+  files.swap(m_nodeConfigFiles);
+  std::vector<ParsedConfig> configs(files.size());
+
+  // Parsing is independent per file, so spread it over a worker pool.
+  std::atomic<size_t> next(0);
+  auto worker = [&] {
+    for (size_t i = next++; i < files.size(); i = next++) {
+      ifstream inputFile(files[i].c_str());
+      if (!inputFile.is_open()) {
+        continue;
+      }
+      configs[i].isOpen = true;
+      try {
+        boost::property_tree::read_info(inputFile, configs[i].pt);
+        configs[i].isParsed = true;
+      }
+      catch (const boost::property_tree::info_parser_error& error) {
+        // reported while merging
+      }
+    }
+  };
+
+  size_t nThreads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                     files.size());
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < nThreads; ++i) {
+    workers.push_back(std::thread(worker));
+  }
+  worker();
+  for (std::thread& thread : workers) {
+    thread.join();
+  }
+
+  // Merge in the order of ndn-node sections, so the result does not depend on scheduling.
+  // As before, a broken node file is reported but does not stop loading of the others.
+  for (size_t i = 0; i < files.size(); ++i) {
+    m_confFileName = files[i];
+    if (!configs[i].isOpen) {
+      cerr << "Failed to read configuration file: " << m_confFileName << endl;
+      continue;
+    }
+    if (!configs[i].isParsed) {
+      std::cerr << "Failed to parse configuration file " << std::endl;
+      std::cerr << m_confFileName << std::endl;
+      continue;
+    }
+    ProcessConfig(configs[i].pt);
+  }
+}
+
 bool
 NlsrConfReader::Load(istream& input)
 {
   ConfigSection pt;
-  bool ret = true;
   try {
     boost::property_tree::read_info(input, pt);
   }
@@ -238,6 +325,13 @@ NlsrConfReader::Load(istream& input)
     return false;
   }
 
+  return ProcessConfig(pt);
+}
+
+bool
+NlsrConfReader::ProcessConfig(ConfigSection& pt)
+{
+  bool ret = true;
   for (ConfigSection::const_iterator tn = pt.begin();
        tn != pt.end(); ++tn) {
     ret = ProcessSection(tn->first, tn->second);
@@ -245,6 +339,11 @@ NlsrConfReader::Load(istream& input)
       break;
     }
   }
+
+  // Keep the parsed per-node configuration, so NlsrExec does not need to read it again.
+  if (ret && pt.count("general") > 0) {
+    m_conf_map[m_srcNodeId] = make_shared<const ConfigSection>(std::move(pt));
+  }
   return ret;
 }
 
@@ -304,8 +403,7 @@ NlsrConfReader::ProcessNlsrConfig(const ConfigSection& section)
     }
 
     //m_srcNodeId = nodeId;
-    m_confFileName = nlsrConfigFile;
-    this->ProcessConfFile();
+    m_nodeConfigFiles.push_back(nlsrConfigFile);
   }
   catch (const std::exception& ex) {
     cerr << ex.what() << endl;
@@ -430,32 +528,152 @@ NlsrConfReader::PrintConfig()
   }
 }
 
+shared_ptr<const NlsrConfReader::ConfigSection>
+NlsrConfReader::GetNodeConfig(const std::string& nodeId) const
+{
+  CONFIG_MAP::const_iterator it = m_conf_map.find(nodeId);
+  if (it == m_conf_map.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
 void
 NlsrConfReader::InitializeNlsr()
 {
-  // Copy over the NLSR config object from node to the application.
+  // Hand over the already parsed NLSR config from node to the application.
   for (NodeContainer::Iterator it = m_nodes.Begin(); it != m_nodes.End(); ++it) {
     NetworkNode node = m_node_map[Names::FindName (*it)];
-    std::string nodeConfig = node.GetConfigPath();
-    NS_ASSERT (!nodeConfig.empty());
+    shared_ptr<const ConfigSection> nodeConfig = GetNodeConfig(node.GetNodeId());
+    NS_ASSERT_MSG (nodeConfig != nullptr, "No NLSR configuration for " << node.GetNodeId());
 
     Ptr<ndn::NlsrApp> nlsrApp = (*it)->GetApplication(0)->GetObject<ndn::NlsrApp> ();
     NS_ASSERT (nlsrApp != 0);
 
-    // Set the node name Id mapping in NLSR.
-    NODE_MAP::iterator nodeIt;
-    for (nodeIt = m_node_map.begin(); nodeIt != m_node_map.end(); ++nodeIt) {
-      std::string nodeId = nodeIt->first;
-      NetworkNode& srcNode = nodeIt->second;
-      nlsrApp->SetNodeNameToIdMapping(srcNode.GetNodeId(), srcNode.GetNdnNodeId());
-    }
+    // All applications share the same node name index.
+    nlsrApp->SetNodeIndex(m_nodeIndex);
 
     nlsrApp->SetNodeName(node.GetNodeId());
-    nlsrApp->Initialize(nodeConfig);
+    nlsrApp->Initialize(node.GetConfigPath(), nodeConfig);
+    nlsrApp->SetWarmStart(m_warmStart);
     nlsrApp->SetStartTime(Seconds (1.0));
   }
 }
 
+static const double HYPERBOLIC_COST_FACTOR = 1000.0;
+
+void
+NlsrConfReader::InstallOracleRoutes(uint32_t nThreads)
+{
+  NlsrRoutingOracle oracle;
+  std::vector<std::string> nodeIds;
+  std::map<std::string, uint32_t> index;
+  std::vector<std::vector<Name> > prefixes;
+  std::vector<bool> isHyperbolic;
+
+  for (NODE_MAP::const_iterator nodeIt = m_node_map.begin(); nodeIt != m_node_map.end(); ++nodeIt) {
+    shared_ptr<const ConfigSection> config = GetNodeConfig(nodeIt->first);
+    NS_ASSERT_MSG (config != nullptr, "No NLSR configuration for " << nodeIt->first);
+
+    uint32_t maxFaces = config->get<uint32_t>("fib.max-faces-per-prefix", 0);
+    uint32_t router;
+    if (config->get<std::string>("hyperbolic.state", "off") == "on") {
+      router = oracle.AddHyperbolicRouter(maxFaces, config->get<double>("hyperbolic.radius"),
+                                          config->get<double>("hyperbolic.angle"));
+    }
+    else {
+      router = oracle.AddRouter(maxFaces);
+    }
+    index[nodeIt->first] = router;
+    nodeIds.push_back(nodeIt->first);
+    isHyperbolic.push_back(config->get<std::string>("hyperbolic.state", "off") == "on");
+
+    // Same router prefix as nlsr::ConfParameter: network + site + router.
+    std::vector<Name> routerPrefixes;
+    Name routerPrefix(config->get<std::string>("general.network"));
+    routerPrefix.append(Name(config->get<std::string>("general.site")));
+    routerPrefix.append(Name(config->get<std::string>("general.router")));
+    routerPrefixes.push_back(routerPrefix);
+
+    boost::optional<const ConfigSection&> advertising = config->get_child_optional("advertising");
+    if (advertising) {
+      for (ConfigSection::const_iterator it = advertising->begin(); it != advertising->end(); ++it) {
+        if (it->first == "prefix") {
+          routerPrefixes.push_back(Name(it->second.get_value<std::string>()));
+        }
+      }
+    }
+    prefixes.push_back(routerPrefixes);
+  }
+
+  // Face of every (node, neighbor) adjacency.
+  std::map<std::pair<uint32_t, uint32_t>, shared_ptr<Face> > faces;
+  for (std::list<Link>::const_iterator link = m_linksList.begin(); link != m_linksList.end(); ++link) {
+    uint32_t from = index[link->GetFromNodeName()];
+    uint32_t to = index[link->GetToNodeName()];
+
+    Ptr<L3Protocol> fromL3 = link->GetFromNode()->GetObject<L3Protocol>();
+    Ptr<L3Protocol> toL3 = link->GetToNode()->GetObject<L3Protocol>();
+    NS_ASSERT_MSG (fromL3 != 0 && toL3 != 0, "NDN stack must be installed before oracle routing");
+
+    faces[std::make_pair(from, to)] = fromL3->getFaceByNetDevice(link->GetFromNetDevice());
+    faces[std::make_pair(to, from)] = toL3->getFaceByNetDevice(link->GetToNetDevice());
+  }
+
+  for (ADJACENCY_MAP::const_iterator adjIt = m_adj_map.begin(); adjIt != m_adj_map.end(); ++adjIt) {
+    std::map<std::string, uint32_t>::const_iterator fromIt = index.find (adjIt->first);
+    if (fromIt == index.end())
+      continue;
+
+    for (const NetworkLink& link : adjIt->second) {
+      std::map<std::string, uint32_t>::const_iterator toIt = index.find (link.GetNodeId());
+      if (toIt == index.end())
+        continue;
+
+      oracle.AddLink (fromIt->second, toIt->second,
+                      boost::lexical_cast<double>(link.GetLinkCost()));
+    }
+  }
+
+  size_t nRoutes = 0;
+  oracle.ComputeAll([&] (uint32_t router, const NlsrRoutingOracle::RoutingTable& table) {
+      Ptr<Node> node = m_nodeIndex->Find(nodeIds[router]);
+      std::vector<FibHelper::Route> routes;
+
+      for (uint32_t destination = 0; destination < table.size(); ++destination) {
+        for (const Name& prefix : prefixes[destination]) {
+          for (const NlsrRoutingOracle::NextHop& nextHop : table[destination]) {
+            shared_ptr<Face> face = faces[std::make_pair(router, nextHop.neighbor)];
+            if (face == nullptr) {
+              continue;
+            }
+            // NFD costs are integers; scale fractional hyperbolic distances to keep their order.
+            double cost = isHyperbolic[router] ? nextHop.cost * HYPERBOLIC_COST_FACTOR : nextHop.cost;
+            routes.push_back({prefix, face, static_cast<int32_t>(std::llround(cost))});
+          }
+        }
+      }
+
+      if (FibHelper::AddRoutes(node, routes)) {
+        nRoutes += routes.size();
+      }
+    }, nThreads);
+
+  NS_LOG_INFO ("Oracle routing installed " << nRoutes << " next hops on " << nodeIds.size() << " nodes");
+}
+
+bool
+NlsrConfReader::SetWarmStart(const std::string& snapshotFile)
+{
+  shared_ptr<NlsrSnapshot> snapshot = make_shared<NlsrSnapshot>();
+  if (!snapshot->Load(snapshotFile)) {
+    cerr << "Failed to load NLSR snapshot: " << snapshotFile << endl;
+    return false;
+  }
+  m_warmStart = snapshot;
+  return true;
+}
+
 Ptr<Node>
 NlsrConfReader::CreateNode (const std::string name, uint32_t systemId)
 {
@@ -1004,7 +1222,13 @@ NlsrConfReader::WriteGraphviz (const std::string &file)
 NodeContainer
 NlsrConfReader::BuildTopology()
 {
+  std::map<std::string, uint32_t> systemIds;
+  if (m_autoPartitioning) {
+    systemIds = ComputePartitions ();
+  }
+
   // Create nodes.
+  m_nodeIndex = make_shared<NlsrNodeIndex>(m_node_map.size());
   try {
     NODE_MAP::iterator nodeIt;
 
@@ -1015,7 +1239,7 @@ NlsrConfReader::BuildTopology()
       // Create a Node
       double longitude = srcNode.GetLongitude();
       double latitude = srcNode.GetLatitude();
-      uint32_t systemId = 0;
+      uint32_t systemId = m_autoPartitioning ? systemIds[nodeId] : 0;
       Ptr<Node> node;
 
       if (abs(longitude) > 0.001 && abs(latitude) > 0.001) {
@@ -1031,6 +1255,7 @@ NlsrConfReader::BuildTopology()
 
       // Map the NDN Node object to its name
       srcNode.SetNdnNodeId(node->GetId());
+      m_nodeIndex->Add(srcNode.GetNodeId(), node);
       NS_LOG_INFO ("Node name is: " + srcNode.GetNodeId());
       //Names::Add(srcNode.GetNodeId(), node);
     }
@@ -1041,6 +1266,7 @@ NlsrConfReader::BuildTopology()
 
   // Create links.
   map<string, set<string> > processedLinks; // to eliminate duplications
+  bool hasZeroDefaultDelay = TopologyPartitioner::GetDefaultLinkDelay () == 0;
   try {
     NODE_MAP::iterator nodeIt;
 
@@ -1071,8 +1297,13 @@ NlsrConfReader::BuildTopology()
         //link.SetAttribute ("DataRate", dstLink.GetBandwidth());
         //link.SetAttribute ("OSPF", dstLink.GetMetric());
 
-        //if (!dstLink.GetDelay().empty())
-        //  link.SetAttribute ("Delay", dstLink.GetDelay());
+        // ndn-nlsr-confgen writes "delay 0" for links without a delay, these keep the
+        // channel default, except links between partitions, which need a lookahead
+        if (TopologyPartitioner::ParseDelay (dstLink.GetDelay()) > 0)
+          link.SetAttribute ("Delay", dstLink.GetDelay());
+        else if (m_autoPartitioning && hasZeroDefaultDelay &&
+                 systemIds[srcNode.GetNodeId()] != systemIds[dstLink.GetNodeId()])
+          link.SetAttribute ("Delay", std::to_string (TopologyPartitioner::DEFAULT_LOOKAHEAD) + "s");
         //if (!dstLink.GetQueue().empty ())
         //  link.SetAttribute ("MaxPackets", dstLink.GetQueue());
 
@@ -1095,23 +1326,71 @@ NlsrConfReader::BuildTopology()
   return m_nodes;
 }
 
+std::map<std::string, uint32_t>
+NlsrConfReader::ComputePartitions () const
+{
+  TopologyPartitioner partitioner;
+  double defaultDelay = TopologyPartitioner::GetDefaultLinkDelay ();
+  std::map<std::string, uint32_t> index;
+  for (NODE_MAP::const_iterator nodeIt = m_node_map.begin(); nodeIt != m_node_map.end(); ++nodeIt) {
+    index[nodeIt->first] = partitioner.AddNode (nodeIt->second.GetLatitude(),
+                                                nodeIt->second.GetLongitude());
+  }
+
+  for (ADJACENCY_MAP::const_iterator adjIt = m_adj_map.begin(); adjIt != m_adj_map.end(); ++adjIt) {
+    std::map<std::string, uint32_t>::const_iterator fromIt = index.find (adjIt->first);
+    if (fromIt == index.end())
+      continue;
+
+    for (const NetworkLink& link : adjIt->second) {
+      std::map<std::string, uint32_t>::const_iterator toIt = index.find (link.GetNodeId());
+      if (toIt == index.end())
+        continue;
+
+      double delay = TopologyPartitioner::ParseDelay (link.GetDelay());
+      partitioner.AddLink (fromIt->second, toIt->second, delay > 0 ? delay : defaultDelay);
+    }
+  }
+
+  uint32_t nPartitions = m_nPartitions > 0 ? m_nPartitions :
+                                             TopologyPartitioner::GetDefaultPartitions();
+  std::vector<uint32_t> partitions = partitioner.Partition (nPartitions, m_partitioningMode);
+  if (partitioner.GetLookahead (partitions) == 0) {
+    // BuildTopology gives these links the default lookahead as their delay
+    std::cerr << "Warning: automatic partitioning of " << GetFileName ()
+              << " cuts links with zero delay, their delay is set to "
+              << TopologyPartitioner::DEFAULT_LOOKAHEAD << "s to give the MPI simulator a"
+              << " lookahead; set neighbor delays or ns3::PointToPointChannel::Delay to avoid it"
+              << std::endl;
+  }
+
+  std::map<std::string, uint32_t> systemIds;
+  for (std::map<std::string, uint32_t>::const_iterator it = index.begin(); it != index.end(); ++it) {
+    systemIds[it->first] = partitions[it->second];
+  }
+  return systemIds;
+}
+
 void
 NlsrConfReader::SetLinkMTUSize()
 {
   ns3::PointToPointNetDevice *netDevice = 0;
-  int mtuSize = 8192;
+  int mtuSize = 0;
 
-  // MTU can be configured from env variable.
+  // Large LSAs are fragmented by NetDeviceLinkService, so devices keep their MTU unless
+  // it is overridden with an env variable.
   char* str = getenv("MTU_SIZE");
   if (str != NULL) {
     try {
       mtuSize = std::stoi(str);
       NS_LOG_INFO ("MTU size set to: " << mtuSize);
     } catch (const std::invalid_argument& ia) {
-      NS_LOG_ERROR ("Invalid MTU size configured, using default: 8192");
+      NS_LOG_ERROR ("Invalid MTU size configured, keeping device MTU");
+      return;
     }
   } else {
-    NS_LOG_INFO ("No MTU specified, using default: 8192");
+    NS_LOG_INFO ("No MTU specified, keeping device MTU");
+    return;
   }
 
   for (NodeContainer::Iterator it = m_nodes.Begin(); it != m_nodes.End(); ++it) {
@@ -38,14 +38,22 @@
 #include "ns3/ptr.h"
 #include "ns3/log.h"
 
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "nlsr-node-index.hpp"
+#include "topology-partitioner.hpp"
+
 #include "adjacency-list.hpp"
 
 namespace ns3 {
 namespace ndn {
 
+class NlsrSnapshot;
+
 class NlsrConfReader : public TopologyReader
 {
 public:
+  typedef boost::property_tree::ptree ConfigSection;
 
   // Network node. 
   class NetworkNode 
@@ -235,6 +243,60 @@ public:
   void
   InitializeNlsr();
 
+  /**
+   * \brief Install NLSR routes centrally instead of running NLSR ("oracle" mode)
+   *
+   * Computes the link-state or hyperbolic routing table of every router from the adjacency
+   * and per-node configuration the reader holds, honoring link-cost and
+   * max-faces-per-prefix, and installs the routes for every router prefix and advertised
+   * prefix directly into the FIB of each forwarder.  No hello, LSA or sync traffic is
+   * generated, so NlsrApp should not be installed and InitializeNlsr() not called.
+   *
+   * The NDN stack must be installed on all nodes before this call.
+   *
+   * \param nThreads number of threads computing routing tables, 0 for all hardware threads
+   *
+   * \see NlsrRoutingOracle
+   */
+  void
+  InstallOracleRoutes(uint32_t nThreads = 0);
+
+  /**
+   * \brief Warm start all NLSR instances from a snapshot file
+   *
+   * Must be called before InitializeNlsr().
+   *
+   * \see NlsrSnapshot
+   */
+  bool
+  SetWarmStart(const std::string& snapshotFile);
+
+  /**
+   * \brief Get the parsed NLSR configuration of a node
+   *
+   * Every per-node NLSR file is parsed exactly once while the topology is read.  The
+   * returned section is immutable and shared with the NlsrApp installed on that node.
+   *
+   * \return parsed configuration or nullptr if the node is unknown
+   */
+  shared_ptr<const ConfigSection>
+  GetNodeConfig(const std::string& nodeId) const;
+
+  /**
+   * \brief Assign nodes to MPI partitions (systemId) automatically while building topology
+   *
+   * Must be called before Read().  Without this call all nodes are placed in partition 0.
+   *
+   * \param nPartitions number of partitions; 0 selects the number of MPI ranks (1 without MPI)
+   * \param mode balanced minimum edge cut weighted by link delay, or geographic bisection
+   *             using node latitude/longitude
+   *
+   * \see TopologyPartitioner
+   */
+  void
+  SetAutoPartitioning(uint32_t nPartitions = 0,
+                      TopologyPartitioner::Mode mode = TopologyPartitioner::MIN_EDGE_CUT);
+
   virtual NodeContainer
   Read ();
 
@@ -276,21 +338,32 @@ protected:
 
   NodeContainer BuildTopology ();
 
+  /**
+   * \brief Override MTU of point-to-point devices with MTU_SIZE environment variable, if set
+   */
   void SetLinkMTUSize();
 
+  std::map<std::string, uint32_t> ComputePartitions () const;
+
 protected:
   std::string m_path;
   NodeContainer m_nodes;
 
 private:
-  typedef boost::property_tree::ptree ConfigSection;
   typedef std::map<std::string, NetworkNode> NODE_MAP;
   typedef std::vector<NetworkLink> ADJACENCY_LIST; 
   typedef std::map<std::string, ADJACENCY_LIST> ADJACENCY_MAP;
+  typedef std::map<std::string, shared_ptr<const ConfigSection> > CONFIG_MAP;
 
   bool
   Load(std::istream& input);
 
+  void
+  LoadNodeConfigs();
+
+  bool
+  ProcessConfig(ConfigSection& pt);
+
   bool
   ProcessSection(const std::string& sectionName, const ConfigSection& section);
 
@@ -306,8 +379,12 @@ private:
 private:
   std::string m_confFileName;
   std::string m_srcNodeId;
+  std::vector<std::string> m_nodeConfigFiles;
   NODE_MAP m_node_map;
   ADJACENCY_MAP m_adj_map;
+  CONFIG_MAP m_conf_map;
+  shared_ptr<NlsrNodeIndex> m_nodeIndex;
+  shared_ptr<const NlsrSnapshot> m_warmStart;
 
   NlsrConfReader (const NlsrConfReader&);
   NlsrConfReader& operator= (const NlsrConfReader&);
@@ -318,6 +395,10 @@ private:
   ObjectFactory m_mobilityFactory;
   double m_scale;
   uint32_t m_requiredPartitions;
+
+  bool m_autoPartitioning;
+  uint32_t m_nPartitions;
+  TopologyPartitioner::Mode m_partitioningMode;
 };
 
 } // namespace ndn
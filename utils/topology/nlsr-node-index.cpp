@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "nlsr-node-index.hpp"
+
+#include "ns3/assert.h"
+
+#include <functional>
+
+namespace ns3 {
+namespace ndn {
+
+NlsrNodeIndex::NlsrNodeIndex(size_t nNodes)
+  : m_size(0)
+{
+  // keep the load factor at or below 0.5
+  size_t capacity = 16;
+  while (capacity < 2 * nNodes) {
+    capacity <<= 1;
+  }
+  m_slots.resize(capacity);
+  m_mask = capacity - 1;
+}
+
+size_t
+NlsrNodeIndex::Probe(const std::string& name) const
+{
+  size_t pos = std::hash<std::string>()(name) & m_mask;
+  while (m_slots[pos].node != nullptr && m_slots[pos].name != name) {
+    pos = (pos + 1) & m_mask;
+  }
+  return pos;
+}
+
+void
+NlsrNodeIndex::Add(const std::string& name, Ptr<Node> node)
+{
+  NS_ASSERT(node != nullptr);
+  NS_ASSERT_MSG(2 * (m_size + 1) <= m_slots.size(), "NlsrNodeIndex capacity exceeded");
+
+  Slot& slot = m_slots[Probe(name)];
+  if (slot.node == nullptr) {
+    slot.name = name;
+    ++m_size;
+  }
+  slot.node = node;
+}
+
+Ptr<Node>
+NlsrNodeIndex::Find(const std::string& name) const
+{
+  return m_slots[Probe(name)].node;
+}
+
+} // namespace ndn
+} // namespace ns3
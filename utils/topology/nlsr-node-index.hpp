@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NLSR_NODE_INDEX_HPP
+#define NLSR_NODE_INDEX_HPP
+
+#include "ns3/ptr.h"
+#include "ns3/node.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Immutable index from NLSR router name to simulated node
+ *
+ * The index is an open-addressing hash table with linear probing.  It is built once by
+ * NlsrConfReader and shared by all NlsrApp instances, so setup is linear in the number of
+ * routers and lookups do not depend on the size of the topology.
+ */
+class NlsrNodeIndex
+{
+public:
+  /**
+   * \brief Create an index with room for \p nNodes entries
+   */
+  explicit
+  NlsrNodeIndex(size_t nNodes);
+
+  /**
+   * \brief Add name to node mapping
+   *
+   * Must only be called while the index is built.  Adding a name twice replaces the node.
+   */
+  void
+  Add(const std::string& name, Ptr<Node> node);
+
+  /**
+   * \brief Find node by router name
+   * \return node or nullptr if the name is not known
+   */
+  Ptr<Node>
+  Find(const std::string& name) const;
+
+  size_t
+  GetN() const
+  {
+    return m_size;
+  }
+
+private:
+  size_t
+  Probe(const std::string& name) const;
+
+private:
+  struct Slot
+  {
+    std::string name;
+    Ptr<Node> node;
+  };
+
+  std::vector<Slot> m_slots;
+  size_t m_mask;
+  size_t m_size;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NLSR_NODE_INDEX_HPP
@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "nlsr-routing-oracle.hpp"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <thread>
+
+namespace ns3 {
+namespace ndn {
+
+static const uint32_t NO_LINK = std::numeric_limits<uint32_t>::max();
+
+uint32_t
+NlsrRoutingOracle::AddRouter(uint32_t maxFacesPerPrefix)
+{
+  Router router = {maxFacesPerPrefix, false, 0, 0};
+  m_routers.push_back(router);
+  m_isIndexed = false;
+  return m_routers.size() - 1;
+}
+
+uint32_t
+NlsrRoutingOracle::AddHyperbolicRouter(uint32_t maxFacesPerPrefix, double radius, double angle)
+{
+  Router router = {maxFacesPerPrefix, true, radius, angle};
+  m_routers.push_back(router);
+  m_isIndexed = false;
+  return m_routers.size() - 1;
+}
+
+void
+NlsrRoutingOracle::AddLink(uint32_t router, uint32_t neighbor, double cost)
+{
+  NS_ASSERT(router < m_routers.size() && neighbor < m_routers.size());
+  if (router == neighbor)
+    return;
+
+  Link link = {router, neighbor, cost};
+  m_links.push_back(link);
+  m_isIndexed = false;
+}
+
+void
+NlsrRoutingOracle::BuildIndex() const
+{
+  if (m_isIndexed)
+    return;
+
+  m_sortedLinks = m_links;
+  std::stable_sort(m_sortedLinks.begin(), m_sortedLinks.end(),
+                   [] (const Link& a, const Link& b) { return a.from < b.from; });
+
+  m_firstLink.assign(m_routers.size() + 1, 0);
+  for (const Link& link : m_sortedLinks) {
+    ++m_firstLink[link.from + 1];
+  }
+  for (size_t i = 1; i < m_firstLink.size(); ++i) {
+    m_firstLink[i] += m_firstLink[i - 1];
+  }
+  m_isIndexed = true;
+}
+
+NlsrRoutingOracle::RoutingTable
+NlsrRoutingOracle::ComputeRoutingTable(uint32_t router) const
+{
+  NS_ASSERT(router < m_routers.size());
+  BuildIndex();
+
+  RoutingTable table(m_routers.size());
+  if (m_routers[router].isHyperbolic)
+    ComputeHyperbolic(router, table);
+  else
+    ComputeLinkState(router, table);
+
+  uint32_t maxFaces = m_routers[router].maxFacesPerPrefix;
+  for (std::vector<NextHop>& nextHops : table) {
+    std::stable_sort(nextHops.begin(), nextHops.end(),
+                     [] (const NextHop& a, const NextHop& b) { return a.cost < b.cost; });
+    if (maxFaces > 0 && nextHops.size() > maxFaces)
+      nextHops.resize(maxFaces);
+  }
+  return table;
+}
+
+void
+NlsrRoutingOracle::ComputeAll(const Visitor& visitor, uint32_t nThreads) const
+{
+  BuildIndex();
+
+  if (nThreads == 0)
+    nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  // compute a window of tables in parallel, then hand them over in order; the window bounds
+  // memory to a few tables per worker
+  const uint32_t window = nThreads * 4;
+  std::vector<RoutingTable> tables(window);
+
+  for (uint32_t first = 0; first < m_routers.size(); first += window) {
+    uint32_t last = std::min<uint32_t>(first + window, m_routers.size());
+    std::atomic<uint32_t> next(first);
+
+    auto worker = [&] {
+      for (uint32_t router = next++; router < last; router = next++) {
+        tables[router - first] = ComputeRoutingTable(router);
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 1; i < std::min(nThreads, last - first); ++i) {
+      workers.push_back(std::thread(worker));
+    }
+    worker();
+    for (std::thread& thread : workers) {
+      thread.join();
+    }
+
+    for (uint32_t router = first; router < last; ++router) {
+      visitor(router, tables[router - first]);
+      RoutingTable().swap(tables[router - first]);
+    }
+  }
+}
+
+void
+NlsrRoutingOracle::ComputeLinkState(uint32_t router, RoutingTable& table) const
+{
+  std::vector<double> cost;
+
+  if (m_routers[router].maxFacesPerPrefix == 1) {
+    std::vector<uint32_t> firstHop;
+    Dijkstra(router, NO_LINK, cost, &firstHop);
+    for (uint32_t destination = 0; destination < m_routers.size(); ++destination) {
+      if (destination != router && firstHop[destination] != NO_LINK) {
+        NextHop nextHop = {firstHop[destination], cost[destination]};
+        table[destination].push_back(nextHop);
+      }
+    }
+    return;
+  }
+
+  for (uint32_t link = m_firstLink[router]; link < m_firstLink[router + 1]; ++link) {
+    Dijkstra(router, link, cost, nullptr);
+    for (uint32_t destination = 0; destination < m_routers.size(); ++destination) {
+      if (destination != router && cost[destination] < std::numeric_limits<double>::infinity()) {
+        NextHop nextHop = {m_sortedLinks[link].to, cost[destination]};
+        table[destination].push_back(nextHop);
+      }
+    }
+  }
+}
+
+void
+NlsrRoutingOracle::ComputeHyperbolic(uint32_t router, RoutingTable& table) const
+{
+  for (uint32_t link = m_firstLink[router]; link < m_firstLink[router + 1]; ++link) {
+    const Router& neighbor = m_routers[m_sortedLinks[link].to];
+    if (!neighbor.isHyperbolic)
+      continue; // coordinates unknown
+
+    for (uint32_t destination = 0; destination < m_routers.size(); ++destination) {
+      const Router& target = m_routers[destination];
+      if (destination == router || !target.isHyperbolic)
+        continue;
+
+      double distance = 0;
+      if (destination != m_sortedLinks[link].to)
+        distance = GetHyperbolicDistance(neighbor.radius, neighbor.angle, target.radius,
+                                         target.angle);
+
+      NextHop nextHop = {m_sortedLinks[link].to, distance};
+      table[destination].push_back(nextHop);
+    }
+  }
+}
+
+void
+NlsrRoutingOracle::Dijkstra(uint32_t router, uint32_t onlyLink, std::vector<double>& cost,
+                            std::vector<uint32_t>* firstHop) const
+{
+  cost.assign(m_routers.size(), std::numeric_limits<double>::infinity());
+  if (firstHop != nullptr)
+    firstHop->assign(m_routers.size(), NO_LINK);
+
+  typedef std::pair<double, uint32_t> QueueEntry;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+  cost[router] = 0;
+  queue.push(std::make_pair(0.0, router));
+
+  while (!queue.empty()) {
+    QueueEntry top = queue.top();
+    queue.pop();
+    uint32_t u = top.second;
+    if (top.first > cost[u])
+      continue;
+
+    for (uint32_t link = m_firstLink[u]; link < m_firstLink[u + 1]; ++link) {
+      if (u == router && onlyLink != NO_LINK && link != onlyLink)
+        continue;
+
+      uint32_t v = m_sortedLinks[link].to;
+      double candidate = cost[u] + m_sortedLinks[link].cost;
+      if (candidate < cost[v]) {
+        cost[v] = candidate;
+        if (firstHop != nullptr)
+          (*firstHop)[v] = u == router ? v : (*firstHop)[u];
+        queue.push(std::make_pair(candidate, v));
+      }
+    }
+  }
+}
+
+double
+NlsrRoutingOracle::GetHyperbolicDistance(double radius1, double angle1, double radius2,
+                                         double angle2)
+{
+  double deltaAngle = M_PI - std::abs(M_PI - std::abs(angle1 - angle2));
+  double x = std::cosh(radius1) * std::cosh(radius2)
+             - std::sinh(radius1) * std::sinh(radius2) * std::cos(deltaAngle);
+  return std::acosh(std::max(x, 1.0));
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NLSR_ROUTING_ORACLE_HPP
+#define NLSR_ROUTING_ORACLE_HPP
+
+#include <functional>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Centralized computation of NLSR routing tables
+ *
+ * Computes for every router the routing table NLSR would converge to, without running the
+ * protocol:
+ *
+ * - link-state routers use Dijkstra over the configured link costs.  With
+ *   max-faces-per-prefix 1 the next hop is the first hop of the shortest path.  Otherwise, as
+ *   in NLSR, a path cost is computed for every neighbor with all other links of the router
+ *   removed, and the cheapest max-faces-per-prefix neighbors are kept (0 keeps all).
+ *
+ * - hyperbolic routers rank neighbors by their hyperbolic distance to the destination.
+ *
+ * Routing tables of different routers are computed in parallel.
+ */
+class NlsrRoutingOracle
+{
+public:
+  struct NextHop
+  {
+    uint32_t neighbor;
+    double cost;
+  };
+
+  /**
+   * \brief Next hops towards every destination router, indexed by destination
+   *
+   * Entries of the router itself and of unreachable routers are empty.
+   */
+  typedef std::vector<std::vector<NextHop>> RoutingTable;
+
+  typedef std::function<void(uint32_t router, const RoutingTable& table)> Visitor;
+
+  /**
+   * \brief Add a router
+   * \param maxFacesPerPrefix number of next hops to keep per destination, 0 for all
+   * \return router index, assigned sequentially starting from 0
+   */
+  uint32_t
+  AddRouter(uint32_t maxFacesPerPrefix);
+
+  /**
+   * \brief Add a hyperbolic router with polar coordinates (\p radius, \p angle)
+   */
+  uint32_t
+  AddHyperbolicRouter(uint32_t maxFacesPerPrefix, double radius, double angle);
+
+  /**
+   * \brief Add a directed adjacency from \p router to \p neighbor with NLSR link cost
+   */
+  void
+  AddLink(uint32_t router, uint32_t neighbor, double cost);
+
+  uint32_t
+  GetNRouters() const
+  {
+    return m_routers.size();
+  }
+
+  /**
+   * \brief Compute routing table of a single router
+   */
+  RoutingTable
+  ComputeRoutingTable(uint32_t router) const;
+
+  /**
+   * \brief Compute routing tables of all routers
+   *
+   * Tables are computed by \p nThreads workers (0 selects the number of hardware threads) and
+   * passed to \p visitor one at a time, in router index order, on the calling thread.
+   */
+  void
+  ComputeAll(const Visitor& visitor, uint32_t nThreads = 0) const;
+
+  static double
+  GetHyperbolicDistance(double radius1, double angle1, double radius2, double angle2);
+
+private:
+  void
+  ComputeLinkState(uint32_t router, RoutingTable& table) const;
+
+  void
+  ComputeHyperbolic(uint32_t router, RoutingTable& table) const;
+
+  /**
+   * \brief Shortest path costs from \p router
+   *
+   * If \p onlyLink is a valid edge index, \p router may only leave through that edge.
+   * If \p firstHop is not null, it receives the neighbor on the path to each destination.
+   */
+  void
+  Dijkstra(uint32_t router, uint32_t onlyLink, std::vector<double>& cost,
+           std::vector<uint32_t>* firstHop) const;
+
+  void
+  BuildIndex() const;
+
+private:
+  struct Router
+  {
+    uint32_t maxFacesPerPrefix;
+    bool isHyperbolic;
+    double radius;
+    double angle;
+  };
+
+  struct Link
+  {
+    uint32_t from;
+    uint32_t to;
+    double cost;
+  };
+
+  std::vector<Router> m_routers;
+  std::vector<Link> m_links;
+
+  // links sorted by origin router, rebuilt by the first computation after a change
+  mutable bool m_isIndexed = false;
+  mutable std::vector<uint32_t> m_firstLink;
+  mutable std::vector<Link> m_sortedLinks;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NLSR_ROUTING_ORACLE_HPP
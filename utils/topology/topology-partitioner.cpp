@@ -0,0 +1,415 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "topology-partitioner.hpp"
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/nstime.h"
+#include "ns3/point-to-point-channel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <queue>
+
+#ifdef NS3_MPI
+#include <ns3/mpi-interface.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("TopologyPartitioner");
+
+// weight of a zero-delay link relative to the shortest non-zero delay link; such links can
+// never be cut without breaking the distributed simulator lookahead
+static const double ZERO_DELAY_WEIGHT_FACTOR = 1000.0;
+
+// allowed deviation of partition load from the target, as a fraction of the total load
+static const double BALANCE_TOLERANCE = 0.03;
+
+static const int MAX_REFINEMENT_PASSES = 8;
+
+const double TopologyPartitioner::DEFAULT_LOOKAHEAD = 0.001;
+
+uint32_t
+TopologyPartitioner::AddNode(double latitude, double longitude)
+{
+  m_positions.push_back(std::make_pair(latitude, longitude));
+  return m_positions.size() - 1;
+}
+
+void
+TopologyPartitioner::AddLink(uint32_t from, uint32_t to, double delay)
+{
+  NS_ASSERT(from < m_positions.size() && to < m_positions.size());
+  if (from == to)
+    return;
+
+  Edge edge = {from, to, delay};
+  m_edges.push_back(edge);
+}
+
+TopologyPartitioner::Adjacency
+TopologyPartitioner::BuildAdjacency() const
+{
+  double maxDelay = 0;
+  double minDelay = std::numeric_limits<double>::max();
+  for (const Edge& edge : m_edges) {
+    if (edge.delay > 0) {
+      maxDelay = std::max(maxDelay, edge.delay);
+      minDelay = std::min(minDelay, edge.delay);
+    }
+  }
+
+  double zeroDelayWeight = ZERO_DELAY_WEIGHT_FACTOR;
+  if (maxDelay > 0)
+    zeroDelayWeight *= maxDelay / minDelay;
+
+  Adjacency adjacency(m_positions.size());
+  for (const Edge& edge : m_edges) {
+    double weight = 1.0; // unknown delay
+    if (edge.delay > 0)
+      weight = maxDelay / edge.delay;
+    else if (edge.delay == 0)
+      weight = zeroDelayWeight;
+
+    adjacency[edge.from].push_back(std::make_pair(edge.to, weight));
+    adjacency[edge.to].push_back(std::make_pair(edge.from, weight));
+  }
+  return adjacency;
+}
+
+std::vector<uint32_t>
+TopologyPartitioner::Partition(uint32_t nPartitions, Mode mode) const
+{
+  std::vector<uint32_t> partitions(m_positions.size(), 0);
+  nPartitions = std::min<uint32_t>(nPartitions, m_positions.size());
+  if (nPartitions <= 1)
+    return partitions;
+
+  Adjacency adjacency = BuildAdjacency();
+
+  std::vector<double> load(m_positions.size());
+  for (size_t i = 0; i < adjacency.size(); ++i) {
+    load[i] = std::max<size_t>(adjacency[i].size(), 1);
+  }
+
+  std::vector<uint32_t> nodes(m_positions.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    nodes[i] = i;
+  }
+
+  Split(adjacency, load, nodes, 0, nPartitions, mode, partitions);
+
+  std::vector<double> partitionLoad(nPartitions, 0);
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    partitionLoad[partitions[i]] += load[i];
+  }
+  size_t cutLinks = 0;
+  for (const Edge& edge : m_edges) {
+    if (partitions[edge.from] != partitions[edge.to])
+      ++cutLinks;
+  }
+  NS_LOG_INFO(nPartitions << " partitions, " << cutLinks << " of " << m_edges.size()
+                          << " links cut, lookahead " << GetLookahead(partitions) << "s, load "
+                          << *std::min_element(partitionLoad.begin(), partitionLoad.end()) << ".."
+                          << *std::max_element(partitionLoad.begin(), partitionLoad.end()));
+
+  return partitions;
+}
+
+void
+TopologyPartitioner::Split(const Adjacency& adjacency, const std::vector<double>& load,
+                           const std::vector<uint32_t>& nodes, uint32_t firstPartition,
+                           uint32_t nPartitions, Mode mode,
+                           std::vector<uint32_t>& partitions) const
+{
+  if (nPartitions <= 1 || nodes.size() <= 1) {
+    for (uint32_t node : nodes) {
+      partitions[node] = firstPartition;
+    }
+    return;
+  }
+
+  uint32_t nLeft = nPartitions / 2;
+  uint32_t nRight = nPartitions - nLeft;
+  double fraction = static_cast<double>(nLeft) / nPartitions;
+
+  std::vector<bool> isLeft = mode == GEOGRAPHIC ? BisectGeographic(load, nodes, fraction)
+                                                : BisectGraph(adjacency, load, nodes, fraction);
+
+  std::vector<uint32_t> left, right;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    (isLeft[i] ? left : right).push_back(nodes[i]);
+  }
+
+  // every partition must receive at least one node
+  while (left.size() < nLeft) {
+    left.push_back(right.back());
+    right.pop_back();
+  }
+  while (right.size() < nRight) {
+    right.push_back(left.back());
+    left.pop_back();
+  }
+
+  Split(adjacency, load, left, firstPartition, nLeft, mode, partitions);
+  Split(adjacency, load, right, firstPartition + nLeft, nRight, mode, partitions);
+}
+
+std::vector<bool>
+TopologyPartitioner::BisectGraph(const Adjacency& adjacency, const std::vector<double>& load,
+                                 const std::vector<uint32_t>& nodes, double fraction) const
+{
+  const size_t n = nodes.size();
+
+  std::vector<int32_t> local(adjacency.size(), -1);
+  for (size_t i = 0; i < n; ++i) {
+    local[nodes[i]] = i;
+  }
+
+  double totalLoad = 0;
+  double maxLoad = 0;
+  for (uint32_t node : nodes) {
+    totalLoad += load[node];
+    maxLoad = std::max(maxLoad, load[node]);
+  }
+  const double target = fraction * totalLoad;
+  const double tolerance = std::max(BALANCE_TOLERANCE * totalLoad, maxLoad);
+
+  // find a pseudo-peripheral node to start growing from
+  auto farthest = [&](size_t start) {
+    std::vector<bool> visited(n, false);
+    std::queue<size_t> queue;
+    queue.push(start);
+    visited[start] = true;
+    size_t last = start;
+    while (!queue.empty()) {
+      last = queue.front();
+      queue.pop();
+      for (const auto& neighbor : adjacency[nodes[last]]) {
+        int32_t j = local[neighbor.first];
+        if (j >= 0 && !visited[j]) {
+          visited[j] = true;
+          queue.push(j);
+        }
+      }
+    }
+    return last;
+  };
+  size_t start = farthest(farthest(0));
+
+  // gain of moving a node to the left side: weight to the left minus weight to the right
+  std::vector<double> gain(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    for (const auto& neighbor : adjacency[nodes[i]]) {
+      if (local[neighbor.first] >= 0)
+        gain[i] -= neighbor.second;
+    }
+  }
+
+  // greedy graph growing
+  std::vector<bool> isLeft(n, false);
+  double leftLoad = 0;
+  size_t nextSeed = 0;
+  typedef std::priority_queue<std::pair<double, size_t>> Heap;
+  Heap frontier;
+  frontier.push(std::make_pair(gain[start], start));
+
+  while (leftLoad < target) {
+    size_t i = n;
+    while (!frontier.empty()) {
+      std::pair<double, size_t> top = frontier.top();
+      frontier.pop();
+      if (!isLeft[top.second] && top.first == gain[top.second]) {
+        i = top.second;
+        break;
+      }
+    }
+    if (i == n) {
+      // region is a whole connected component, continue from another one
+      while (nextSeed < n && isLeft[nextSeed])
+        ++nextSeed;
+      if (nextSeed == n)
+        break;
+      i = nextSeed;
+    }
+
+    isLeft[i] = true;
+    leftLoad += load[nodes[i]];
+    for (const auto& neighbor : adjacency[nodes[i]]) {
+      int32_t j = local[neighbor.first];
+      if (j >= 0 && !isLeft[j]) {
+        gain[j] += 2 * neighbor.second;
+        frontier.push(std::make_pair(gain[j], j));
+      }
+    }
+  }
+
+  // refinement: move boundary nodes while the cut weight decreases and balance holds
+  for (int pass = 0; pass < MAX_REFINEMENT_PASSES; ++pass) {
+    Heap candidates;
+    for (size_t i = 0; i < n; ++i) {
+      gain[i] = 0;
+      for (const auto& neighbor : adjacency[nodes[i]]) {
+        int32_t j = local[neighbor.first];
+        if (j >= 0)
+          gain[i] += isLeft[j] != isLeft[i] ? neighbor.second : -neighbor.second;
+      }
+      if (gain[i] > 0)
+        candidates.push(std::make_pair(gain[i], i));
+    }
+
+    std::vector<bool> locked(n, false);
+    bool moved = false;
+    while (!candidates.empty()) {
+      std::pair<double, size_t> top = candidates.top();
+      candidates.pop();
+      size_t i = top.second;
+      if (locked[i] || top.first != gain[i])
+        continue;
+
+      double newLeftLoad = leftLoad + (isLeft[i] ? -load[nodes[i]] : load[nodes[i]]);
+      if (std::abs(newLeftLoad - target) > tolerance
+          && std::abs(newLeftLoad - target) >= std::abs(leftLoad - target))
+        continue;
+
+      isLeft[i] = !isLeft[i];
+      leftLoad = newLeftLoad;
+      locked[i] = true;
+      moved = true;
+
+      gain[i] = -gain[i];
+      for (const auto& neighbor : adjacency[nodes[i]]) {
+        int32_t j = local[neighbor.first];
+        if (j < 0 || locked[j])
+          continue;
+        gain[j] += isLeft[j] == isLeft[i] ? -2 * neighbor.second : 2 * neighbor.second;
+        if (gain[j] > 0)
+          candidates.push(std::make_pair(gain[j], j));
+      }
+    }
+
+    if (!moved)
+      break;
+  }
+
+  return isLeft;
+}
+
+std::vector<bool>
+TopologyPartitioner::BisectGeographic(const std::vector<double>& load,
+                                      const std::vector<uint32_t>& nodes, double fraction) const
+{
+  double minLat = std::numeric_limits<double>::max(), maxLat = -minLat;
+  double minLon = minLat, maxLon = -minLat;
+  double totalLoad = 0;
+  for (uint32_t node : nodes) {
+    minLat = std::min(minLat, m_positions[node].first);
+    maxLat = std::max(maxLat, m_positions[node].first);
+    minLon = std::min(minLon, m_positions[node].second);
+    maxLon = std::max(maxLon, m_positions[node].second);
+    totalLoad += load[node];
+  }
+  bool byLatitude = (maxLat - minLat) > (maxLon - minLon);
+
+  std::vector<size_t> order(nodes.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const std::pair<double, double>& pa = m_positions[nodes[a]];
+    const std::pair<double, double>& pb = m_positions[nodes[b]];
+    double ca = byLatitude ? pa.first : pa.second;
+    double cb = byLatitude ? pb.first : pb.second;
+    return ca < cb || (ca == cb && a < b);
+  });
+
+  std::vector<bool> isLeft(nodes.size(), false);
+  double leftLoad = 0;
+  const double target = fraction * totalLoad;
+  for (size_t i = 0; i < order.size() && leftLoad < target; ++i) {
+    isLeft[order[i]] = true;
+    leftLoad += load[nodes[order[i]]];
+  }
+  return isLeft;
+}
+
+double
+TopologyPartitioner::GetLookahead(const std::vector<uint32_t>& partitions) const
+{
+  double lookahead = -1;
+  for (const Edge& edge : m_edges) {
+    if (partitions[edge.from] != partitions[edge.to] && edge.delay >= 0) {
+      lookahead = lookahead < 0 ? edge.delay : std::min(lookahead, edge.delay);
+    }
+  }
+  return lookahead;
+}
+
+uint32_t
+TopologyPartitioner::GetDefaultPartitions()
+{
+#ifdef NS3_MPI
+  if (MpiInterface::IsEnabled())
+    return MpiInterface::GetSize();
+#endif
+  return 1;
+}
+
+double
+TopologyPartitioner::GetDefaultLinkDelay()
+{
+  TimeValue delay;
+  CreateObject<PointToPointChannel>()->GetAttribute("Delay", delay);
+  return delay.Get().ToDouble(Time::S);
+}
+
+double
+TopologyPartitioner::ParseDelay(const std::string& delay)
+{
+  const char* begin = delay.c_str();
+  char* end = 0;
+  double value = strtod(begin, &end);
+  if (end == begin || value < 0)
+    return -1;
+
+  std::string unit(end);
+  unit.erase(std::remove(unit.begin(), unit.end(), ' '), unit.end());
+
+  if (unit.empty() || unit == "s")
+    return value;
+  if (unit == "ms")
+    return value * 1e-3;
+  if (unit == "us")
+    return value * 1e-6;
+  if (unit == "ns")
+    return value * 1e-9;
+  if (unit == "ps")
+    return value * 1e-12;
+  if (unit == "min")
+    return value * 60;
+  if (unit == "h")
+    return value * 3600;
+  return -1;
+}
+
+} // namespace ns3
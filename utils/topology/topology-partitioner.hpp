@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef TOPOLOGY_PARTITIONER_HPP
+#define TOPOLOGY_PARTITIONER_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Assigns topology nodes to MPI partitions (ns-3 systemId)
+ *
+ * Two strategies are supported:
+ *
+ * - MIN_EDGE_CUT: balanced recursive bisection.  Each bisection grows a region from a
+ *   peripheral vertex and refines the cut with greedy Fiduccia-Mattheyses moves.  Node load is
+ *   the node degree.  Edge weight is inversely proportional to the link delay, so short links
+ *   stay inside a partition and the delay of cut links, i.e., the lookahead of the distributed
+ *   simulator, stays large.
+ *
+ * - GEOGRAPHIC: recursive coordinate bisection on latitude/longitude, balancing node load.
+ *
+ * The result is deterministic for a given input.
+ */
+class TopologyPartitioner
+{
+public:
+  enum Mode {
+    MIN_EDGE_CUT,
+    GEOGRAPHIC
+  };
+
+  /**
+   * \brief Add a node to the graph
+   * \return index of the node, assigned sequentially starting from 0
+   */
+  uint32_t
+  AddNode(double latitude = 0.0, double longitude = 0.0);
+
+  /**
+   * \brief Add an undirected link
+   * \param delay link delay in seconds; negative if unknown
+   */
+  void
+  AddLink(uint32_t from, uint32_t to, double delay);
+
+  uint32_t
+  GetNNodes() const
+  {
+    return m_positions.size();
+  }
+
+  /**
+   * \brief Compute partition of every node
+   * \param nPartitions number of partitions, clamped to the number of nodes
+   * \return vector of systemId values indexed by node index
+   */
+  std::vector<uint32_t>
+  Partition(uint32_t nPartitions, Mode mode = MIN_EDGE_CUT) const;
+
+  /**
+   * \brief Get minimum delay (seconds) over links that cross partitions
+   * \return minimum delay or -1 if no known-delay link is cut
+   */
+  double
+  GetLookahead(const std::vector<uint32_t>& partitions) const;
+
+  /**
+   * \brief Get number of partitions for automatic partitioning
+   * \return MpiInterface::GetSize() if MPI is enabled, 1 otherwise
+   */
+  static uint32_t
+  GetDefaultPartitions();
+
+  /**
+   * \brief Parse delay string, such as "10ms", "1.5us", or "0.01" (seconds)
+   * \return delay in seconds or -1 if the string cannot be parsed
+   */
+  static double
+  ParseDelay(const std::string& delay);
+
+  /**
+   * \brief Get delay of point-to-point channels that are created without an explicit delay
+   * \return value of ns3::PointToPointChannel::Delay in seconds
+   */
+  static double
+  GetDefaultLinkDelay();
+
+  /**
+   * \brief Delay (seconds) given to cut links that have zero delay
+   *
+   * The distributed simulator needs a nonzero delay on links between partitions as its
+   * lookahead, e.g., for topologies generated by ndn-nlsr-confgen, which have no delays.
+   */
+  static const double DEFAULT_LOOKAHEAD;
+
+private:
+  typedef std::vector<std::vector<std::pair<uint32_t, double>>> Adjacency;
+
+  Adjacency
+  BuildAdjacency() const;
+
+  void
+  Split(const Adjacency& adjacency, const std::vector<double>& load,
+        const std::vector<uint32_t>& nodes, uint32_t firstPartition, uint32_t nPartitions,
+        Mode mode, std::vector<uint32_t>& partitions) const;
+
+  std::vector<bool>
+  BisectGraph(const Adjacency& adjacency, const std::vector<double>& load,
+              const std::vector<uint32_t>& nodes, double fraction) const;
+
+  std::vector<bool>
+  BisectGeographic(const std::vector<double>& load, const std::vector<uint32_t>& nodes,
+                   double fraction) const;
+
+private:
+  struct Edge
+  {
+    uint32_t from;
+    uint32_t to;
+    double delay;
+  };
+
+  std::vector<std::pair<double, double>> m_positions;
+  std::vector<Edge> m_edges;
+};
+
+} // namespace ns3
+
+#endif // TOPOLOGY_PARTITIONER_HPP
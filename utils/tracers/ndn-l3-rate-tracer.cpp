@@ -24,8 +24,10 @@
 #include "ns3/callback.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/assert.h"
 #include "ns3/node-list.h"
 
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
 #include "daemon/table/pit-entry.hpp"
 
 #include <fstream>
@@ -166,16 +168,22 @@ L3RateTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
 }
 
 L3RateTracer::L3RateTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
-  : L3Tracer(node)
+  : L3Tracer(node, false)
   , m_os(os)
 {
+  Ptr<L3Protocol> l3 = m_nodePtr->GetObject<L3Protocol>();
+  NS_ASSERT_MSG(l3 != nullptr, "NDN stack is not installed on node " << m_node);
+  l3->enableFaceCounters();
   SetAveragingPeriod(Seconds(1.0));
 }
 
 L3RateTracer::L3RateTracer(shared_ptr<std::ostream> os, const std::string& node)
-  : L3Tracer(node)
+  : L3Tracer(node, false)
   , m_os(os)
 {
+  Ptr<L3Protocol> l3 = m_nodePtr->GetObject<L3Protocol>();
+  NS_ASSERT_MSG(l3 != nullptr, "NDN stack is not installed on node " << m_node);
+  l3->enableFaceCounters();
   SetAveragingPeriod(Seconds(1.0));
 }
 
@@ -195,6 +203,7 @@ L3RateTracer::SetAveragingPeriod(const Time& period)
 void
 L3RateTracer::PeriodicPrinter()
 {
+  Update();
   Print(*m_os);
   Reset();
 
@@ -225,6 +234,74 @@ L3RateTracer::PrintHeader(std::ostream& os) const
      << "KilobytesRaw";
 }
 
+void
+L3RateTracer::Update()
+{
+  Ptr<L3Protocol> l3 = m_nodePtr->GetObject<L3Protocol>();
+  NS_ASSERT_MSG(l3 != nullptr, "NDN stack is not installed on node " << m_node);
+  const FaceCounterTable* counters = l3->getFaceCounters();
+  NS_ASSERT_MSG(counters != nullptr, "Face counters are not enabled on node " << m_node);
+  FaceCounterTable delta = counters->diff(m_lastCounters);
+  m_lastCounters = *counters;
+
+  for (nfd::FaceId faceId = delta.getBeginFaceId(); faceId < delta.getEndFaceId(); ++faceId) {
+    auto stats = m_stats.find(faceId);
+    if (stats == m_stats.end()) {
+      bool hasActivity = false;
+      for (int counter = 0; counter < FaceCounterTable::N_COUNTERS; ++counter) {
+        hasActivity = hasActivity ||
+          delta.getPackets(static_cast<FaceCounterTable::Counter>(counter), faceId) > 0;
+      }
+      if (!hasActivity) {
+        continue;
+      }
+
+      shared_ptr<Face> face = l3->getFaceById(faceId);
+      m_faceDescriptions[faceId] = face != nullptr ? face->getLocalUri().toString() : "-";
+      stats = m_stats.insert(std::make_pair(faceId, std::tuple<Stats, Stats, Stats, Stats>())).first;
+      std::get<0>(stats->second).Reset();
+      std::get<1>(stats->second).Reset();
+      std::get<2>(stats->second).Reset();
+      std::get<3>(stats->second).Reset();
+    }
+
+    Stats& packets = std::get<0>(stats->second);
+    Stats& bytes = std::get<1>(stats->second);
+
+    packets.m_inInterests = delta.getPackets(FaceCounterTable::IN_INTERESTS, faceId);
+    bytes.m_inInterests = delta.getBytes(FaceCounterTable::IN_INTERESTS, faceId);
+    packets.m_outInterests = delta.getPackets(FaceCounterTable::OUT_INTERESTS, faceId);
+    bytes.m_outInterests = delta.getBytes(FaceCounterTable::OUT_INTERESTS, faceId);
+    packets.m_inData = delta.getPackets(FaceCounterTable::IN_DATA, faceId);
+    bytes.m_inData = delta.getBytes(FaceCounterTable::IN_DATA, faceId);
+    packets.m_outData = delta.getPackets(FaceCounterTable::OUT_DATA, faceId);
+    bytes.m_outData = delta.getBytes(FaceCounterTable::OUT_DATA, faceId);
+
+    // no "size" stats
+    packets.m_satisfiedInterests = delta.getPackets(FaceCounterTable::IN_SATISFIED_INTERESTS, faceId);
+    packets.m_timedOutInterests = delta.getPackets(FaceCounterTable::IN_TIMED_OUT_INTERESTS, faceId);
+    packets.m_outSatisfiedInterests = delta.getPackets(FaceCounterTable::OUT_SATISFIED_INTERESTS, faceId);
+    packets.m_outTimedOutInterests = delta.getPackets(FaceCounterTable::OUT_TIMED_OUT_INTERESTS, faceId);
+  }
+
+  uint64_t nSatisfied = delta.getNodeTotal(FaceCounterTable::IN_SATISFIED_INTERESTS);
+  uint64_t nTimedOut = delta.getNodeTotal(FaceCounterTable::IN_TIMED_OUT_INTERESTS);
+  auto stats = m_stats.find(nfd::face::INVALID_FACEID);
+  if (stats == m_stats.end()) {
+    if (nSatisfied == 0 && nTimedOut == 0) {
+      return;
+    }
+    stats = m_stats.insert(std::make_pair(nfd::face::INVALID_FACEID,
+                                          std::tuple<Stats, Stats, Stats, Stats>())).first;
+    std::get<0>(stats->second).Reset();
+    std::get<1>(stats->second).Reset();
+    std::get<2>(stats->second).Reset();
+    std::get<3>(stats->second).Reset();
+  }
+  std::get<0>(stats->second).m_satisfiedInterests = nSatisfied;
+  std::get<0>(stats->second).m_timedOutInterests = nTimedOut;
+}
+
 void
 L3RateTracer::Reset()
 {
@@ -246,8 +323,8 @@ const double alpha = 0.8;
                        + /*old value*/ (1 - alpha) * STATS(3).fieldName;                           \
                                                                                                    \
   os << time.ToDouble(Time::S) << "\t" << m_node << "\t";                                          \
-  if (stats.first != nullptr) {                                                                    \
-    os << stats.first->getId() << "\t" << stats.first->getLocalUri() << "\t";                      \
+  if (stats.first != nfd::face::INVALID_FACEID) {                                                  \
+    os << stats.first << "\t" << m_faceDescriptions.at(stats.first) << "\t";                       \
   }                                                                                                \
   else {                                                                                           \
     os << "-1\tall\t";                                                                             \
@@ -261,7 +338,7 @@ L3RateTracer::Print(std::ostream& os) const
   Time time = Simulator::Now();
 
   for (auto& stats : m_stats) {
-    if (stats.first == nullptr)
+    if (stats.first == nfd::face::INVALID_FACEID)
       continue;
 
     PRINTER("InInterests", m_inInterests);
@@ -278,7 +355,7 @@ L3RateTracer::Print(std::ostream& os) const
   }
 
   {
-    auto i = m_stats.find(nullptr);
+    auto i = m_stats.find(nfd::face::INVALID_FACEID);
     if (i != m_stats.end()) {
       auto& stats = *i;
       PRINTER("SatisfiedInterests", m_satisfiedInterests);
@@ -287,75 +364,5 @@ L3RateTracer::Print(std::ostream& os) const
   }
 }
 
-void
-L3RateTracer::OutInterests(const Interest& interest, const Face& face)
-{
-  std::get<0>(m_stats[face.shared_from_this()]).m_outInterests++;
-  if (interest.hasWire()) {
-    std::get<1>(m_stats[face.shared_from_this()]).m_outInterests +=
-      interest.wireEncode().size();
-  }
-}
-
-void
-L3RateTracer::InInterests(const Interest& interest, const Face& face)
-{
-  std::get<0>(m_stats[face.shared_from_this()]).m_inInterests++;
-  if (interest.hasWire()) {
-    std::get<1>(m_stats[face.shared_from_this()]).m_inInterests +=
-      interest.wireEncode().size();
-  }
-}
-
-void
-L3RateTracer::OutData(const Data& data, const Face& face)
-{
-  std::get<0>(m_stats[face.shared_from_this()]).m_outData++;
-  if (data.hasWire()) {
-    std::get<1>(m_stats[face.shared_from_this()]).m_outData +=
-      data.wireEncode().size();
-  }
-}
-
-void
-L3RateTracer::InData(const Data& data, const Face& face)
-{
-  std::get<0>(m_stats[face.shared_from_this()]).m_inData++;
-  if (data.hasWire()) {
-    std::get<1>(m_stats[face.shared_from_this()]).m_inData +=
-      data.wireEncode().size();
-  }
-}
-
-void
-L3RateTracer::SatisfiedInterests(const nfd::pit::Entry& entry, const Face&, const Data&)
-{
-  std::get<0>(m_stats[nullptr]).m_satisfiedInterests++;
-  // no "size" stats
-
-  for (const auto& in : entry.getInRecords()) {
-    std::get<0>(m_stats[in.getFace()]).m_satisfiedInterests ++;
-  }
-
-  for (const auto& out : entry.getOutRecords()) {
-    std::get<0>(m_stats[out.getFace()]).m_outSatisfiedInterests ++;
-  }
-}
-
-void
-L3RateTracer::TimedOutInterests(const nfd::pit::Entry& entry)
-{
-  std::get<0>(m_stats[nullptr]).m_timedOutInterests++;
-  // no "size" stats
-
-  for (const auto& in : entry.getInRecords()) {
-    std::get<0>(m_stats[in.getFace()]).m_timedOutInterests++;
-  }
-
-  for (const auto& out : entry.getOutRecords()) {
-    std::get<0>(m_stats[out.getFace()]).m_outTimedOutInterests++;
-  }
-}
-
 } // namespace ndn
 } // namespace ns3
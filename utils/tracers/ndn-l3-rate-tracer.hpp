@@ -24,6 +24,8 @@
 
 #include "ndn-l3-tracer.hpp"
 
+#include "ns3/ndnSIM/model/ndn-face-counter-table.hpp"
+
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "ns3/node-container.h"
@@ -38,6 +40,9 @@ namespace ndn {
 /**
  * @ingroup ndn-tracers
  * @brief NDN network-layer rate tracer
+ *
+ * The tracer does not observe individual packets: it enables per-face counters of
+ * L3Protocol (FaceCounterTable) and diffs their snapshots every averaging period.
  */
 class L3RateTracer : public L3Tracer {
 public:
@@ -125,26 +130,6 @@ public:
   virtual void
   Print(std::ostream& os) const;
 
-protected:
-  // from L3Tracer
-  virtual void
-  OutInterests(const Interest& interest, const Face& face);
-
-  virtual void
-  InInterests(const Interest& interest, const Face& face);
-
-  virtual void
-  OutData(const Data& data, const Face& face);
-
-  virtual void
-  InData(const Data& data, const Face& face);
-
-  virtual void
-  SatisfiedInterests(const nfd::pit::Entry&, const Face&, const Data&);
-
-  virtual void
-  TimedOutInterests(const nfd::pit::Entry&);
-
 private:
   void
   SetAveragingPeriod(const Time& period);
@@ -152,6 +137,12 @@ private:
   void
   PeriodicPrinter();
 
+  /**
+   * @brief Accumulate counters of L3Protocol since the last update into current stats
+   */
+  void
+  Update();
+
   void
   Reset();
 
@@ -160,7 +151,9 @@ private:
   Time m_period;
   EventId m_printEvent;
 
-  mutable std::map<shared_ptr<const Face>, std::tuple<Stats, Stats, Stats, Stats>> m_stats;
+  FaceCounterTable m_lastCounters;
+  std::map<nfd::FaceId, std::string> m_faceDescriptions;
+  mutable std::map<nfd::FaceId, std::tuple<Stats, Stats, Stats, Stats>> m_stats;
 };
 
 } // namespace ndn
@@ -31,12 +31,14 @@
 namespace ns3 {
 namespace ndn {
 
-L3Tracer::L3Tracer(Ptr<Node> node)
+L3Tracer::L3Tracer(Ptr<Node> node, bool shouldConnect)
   : m_nodePtr(node)
 {
   m_node = boost::lexical_cast<std::string>(m_nodePtr->GetId());
 
-  Connect();
+  if (shouldConnect) {
+    Connect();
+  }
 
   std::string name = Names::FindName(node);
   if (!name.empty()) {
@@ -44,10 +46,13 @@ L3Tracer::L3Tracer(Ptr<Node> node)
   }
 }
 
-L3Tracer::L3Tracer(const std::string& node)
+L3Tracer::L3Tracer(const std::string& node, bool shouldConnect)
   : m_node(node)
+  , m_nodePtr(Names::Find<Node>(node))
 {
-  Connect();
+  if (shouldConnect) {
+    Connect();
+  }
 }
 
 L3Tracer::~L3Tracer(){};
@@ -70,5 +75,35 @@ L3Tracer::Connect()
                                  MakeCallback(&L3Tracer::TimedOutInterests, this));
 }
 
+void
+L3Tracer::OutInterests(const Interest&, const Face&)
+{
+}
+
+void
+L3Tracer::InInterests(const Interest&, const Face&)
+{
+}
+
+void
+L3Tracer::OutData(const Data&, const Face&)
+{
+}
+
+void
+L3Tracer::InData(const Data&, const Face&)
+{
+}
+
+void
+L3Tracer::SatisfiedInterests(const nfd::pit::Entry&, const Face&, const Data&)
+{
+}
+
+void
+L3Tracer::TimedOutInterests(const nfd::pit::Entry&)
+{
+}
+
 } // namespace ndn
 } // namespace ns3
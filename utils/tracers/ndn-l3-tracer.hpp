@@ -47,14 +47,17 @@ public:
   /**
    * @brief Trace constructor that attaches to the node using node pointer
    * @param node  pointer to the node
+   * @param shouldConnect connect to L3Protocol trace sources (tracers that read
+   *                      L3Protocol::getFaceCounters() instead do not need them)
    */
-  L3Tracer(Ptr<Node> node);
+  L3Tracer(Ptr<Node> node, bool shouldConnect = true);
 
   /**
    * @brief Trace constructor that attaches to the node using node name
    * @param nodeName  name of the node registered using Names::Add
+   * @param shouldConnect connect to L3Protocol trace sources
    */
-  L3Tracer(const std::string& node);
+  L3Tracer(const std::string& node, bool shouldConnect = true);
 
   /**
    * @brief Destructor
@@ -81,23 +84,26 @@ protected:
   void
   Connect();
 
+  // Trace sinks, connected by Connect().  They do nothing by default, so tracers that are
+  // constructed with shouldConnect = false do not need to override them.
+
   virtual void
-  OutInterests(const Interest&, const Face&) = 0;
+  OutInterests(const Interest&, const Face&);
 
   virtual void
-  InInterests(const Interest&, const Face&) = 0;
+  InInterests(const Interest&, const Face&);
 
   virtual void
-  OutData(const Data&, const Face&) = 0;
+  OutData(const Data&, const Face&);
 
   virtual void
-  InData(const Data&, const Face&) = 0;
+  InData(const Data&, const Face&);
 
   virtual void
-  SatisfiedInterests(const nfd::pit::Entry&, const Face&, const Data&) = 0;
+  SatisfiedInterests(const nfd::pit::Entry&, const Face&, const Data&);
 
   virtual void
-  TimedOutInterests(const nfd::pit::Entry&) = 0;
+  TimedOutInterests(const nfd::pit::Entry&);
 
 protected:
   std::string m_node;
@@ -0,0 +1,280 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ndn-nlsr-convergence-monitor.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/names.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+#include "apps/ndn-nlsr-app.hpp"
+
+#include "nlsr.hpp"
+#include "route/nexthop.hpp"
+#include "route/routing-table.hpp"
+#include "route/routing-table-entry.hpp"
+
+#include <fstream>
+#include <list>
+#include <boost/functional/hash.hpp>
+
+NS_LOG_COMPONENT_DEFINE("ndn.NlsrConvergenceMonitor");
+
+namespace ns3 {
+namespace ndn {
+
+static std::list<Ptr<NlsrConvergenceMonitor>> g_monitors;
+
+static const char* KIND_NAMES[NLSR_TRACE_N_KINDS] = {"Hello", "NameLsa", "LinkLsa", "Sync", "Fib"};
+
+void
+NlsrConvergenceMonitor::Destroy()
+{
+  for (const auto& monitor : g_monitors) {
+    monitor->m_sampleEvent.Cancel();
+  }
+  g_monitors.clear();
+  NlsrTracer::Instance().SetEventListener(NlsrTracer::EventListener());
+}
+
+Ptr<NlsrConvergenceMonitor>
+NlsrConvergenceMonitor::InstallAll(const std::string& file, Time samplingPeriod, Time quietPeriod)
+{
+  return Install(NodeContainer::GetGlobal(), file, samplingPeriod, quietPeriod);
+}
+
+Ptr<NlsrConvergenceMonitor>
+NlsrConvergenceMonitor::Install(const NodeContainer& nodes, const std::string& file,
+                                Time samplingPeriod, Time quietPeriod)
+{
+  shared_ptr<std::ostream> outputStream;
+  if (file != "-") {
+    shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+    if (!os->is_open()) {
+      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Monitoring disabled");
+      return nullptr;
+    }
+
+    outputStream = os;
+  }
+  else {
+    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  Ptr<NlsrConvergenceMonitor> monitor =
+    Create<NlsrConvergenceMonitor>(nodes, outputStream, samplingPeriod, quietPeriod);
+  g_monitors.push_back(monitor);
+  return monitor;
+}
+
+NlsrConvergenceMonitor::NlsrConvergenceMonitor(const NodeContainer& nodes,
+                                               shared_ptr<std::ostream> os,
+                                               Time samplingPeriod, Time quietPeriod)
+  : m_os(os)
+  , m_samplingPeriod(samplingPeriod)
+  , m_quietPeriod(quietPeriod)
+{
+  std::fill(m_totals, m_totals + NLSR_TRACE_N_KINDS, Counters());
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+    if ((*node)->GetId() >= m_nodeIndex.size()) {
+      m_nodeIndex.resize((*node)->GetId() + 1, -1);
+    }
+    m_nodeIndex[(*node)->GetId()] = m_nodes.size();
+
+    NodeStats stats = {*node, 0, 0, 0};
+    m_nodes.push_back(stats);
+  }
+
+  StartEpisode("startup", Simulator::Now());
+
+  NlsrTracer::Instance().SetEventListener([this] (uint8_t kind, uint32_t node,
+                                                  uint64_t packets, uint64_t bytes) {
+      this->OnNlsrEvent(kind, node, packets, bytes);
+    });
+  m_sampleEvent = Simulator::Schedule(m_samplingPeriod, &NlsrConvergenceMonitor::Sample, this);
+}
+
+NlsrConvergenceMonitor::~NlsrConvergenceMonitor()
+{
+  m_sampleEvent.Cancel();
+  WriteReport();
+}
+
+void
+NlsrConvergenceMonitor::StartEpisode(const std::string& cause, const Time& start)
+{
+  Episode episode;
+  episode.cause = cause;
+  episode.start = start;
+  episode.lastChange = start;
+  episode.isConverged = false;
+  std::fill(episode.messages, episode.messages + NLSR_TRACE_N_KINDS, Counters());
+  m_episodes.push_back(episode);
+}
+
+void
+NlsrConvergenceMonitor::NotifyTopologyChange(const std::string& cause)
+{
+  NS_LOG_FUNCTION(this << cause);
+  StartEpisode(cause, Simulator::Now());
+}
+
+bool
+NlsrConvergenceMonitor::IsConverged() const
+{
+  return m_episodes.back().isConverged;
+}
+
+Time
+NlsrConvergenceMonitor::GetLastConvergenceTime() const
+{
+  for (auto episode = m_episodes.rbegin(); episode != m_episodes.rend(); ++episode) {
+    if (episode->isConverged) {
+      return episode->converged - episode->start;
+    }
+  }
+  return Seconds(0);
+}
+
+size_t
+NlsrConvergenceMonitor::ComputeRoutingTableDigest(Ptr<Node> node) const
+{
+  Ptr<NlsrApp> app;
+  for (uint32_t i = 0; i < node->GetNApplications() && app == nullptr; ++i) {
+    app = DynamicCast<NlsrApp>(node->GetApplication(i));
+  }
+  if (app == nullptr || !app->IsRunning()) {
+    return 0;
+  }
+
+  size_t digest = 0;
+  for (nlsr::RoutingTableEntry& entry : app->GetNlsr().getRoutingTable().getRoutingTableEntry()) {
+    const Block& destination = entry.getDestination().wireEncode();
+    boost::hash_combine(digest, boost::hash_range(destination.wire(),
+                                                  destination.wire() + destination.size()));
+    for (const nlsr::NextHop& nextHop : entry.getNexthopList().getNextHops()) {
+      boost::hash_combine(digest, nextHop.getConnectingFaceUri());
+      boost::hash_combine(digest, nextHop.getRouteCost());
+    }
+  }
+  return digest;
+}
+
+void
+NlsrConvergenceMonitor::Sample()
+{
+  bool hasChanged = false;
+  for (auto& stats : m_nodes) {
+    size_t digest = ComputeRoutingTableDigest(stats.node);
+    if (digest != stats.routingTableDigest) {
+      stats.routingTableDigest = digest;
+      stats.recalculations++;
+      hasChanged = true;
+    }
+  }
+
+  Time now = Simulator::Now();
+  if (hasChanged) {
+    if (m_episodes.back().isConverged) {
+      // change without an announced topology event
+      StartEpisode("unannounced", now - m_samplingPeriod);
+    }
+    m_episodes.back().lastChange = now;
+  }
+  else if (!m_episodes.back().isConverged && now - m_episodes.back().lastChange >= m_quietPeriod) {
+    Episode& episode = m_episodes.back();
+    episode.isConverged = true;
+    episode.converged = episode.lastChange;
+    NS_LOG_INFO("NLSR converged after " << episode.cause << " in "
+                << (episode.converged - episode.start).GetSeconds() << "s");
+  }
+
+  m_sampleEvent = Simulator::Schedule(m_samplingPeriod, &NlsrConvergenceMonitor::Sample, this);
+}
+
+void
+NlsrConvergenceMonitor::OnNlsrEvent(uint8_t kind, uint32_t node, uint64_t packets, uint64_t bytes)
+{
+  if (kind >= NLSR_TRACE_N_KINDS) {
+    return;
+  }
+
+  m_totals[kind].packets += packets;
+  m_totals[kind].bytes += bytes;
+  m_episodes.back().messages[kind].packets += packets;
+  m_episodes.back().messages[kind].bytes += bytes;
+
+  if (kind == NLSR_TRACE_FIB && node < m_nodeIndex.size() && m_nodeIndex[node] >= 0) {
+    m_nodes[m_nodeIndex[node]].fibUpdates++;
+  }
+}
+
+void
+NlsrConvergenceMonitor::WriteReport()
+{
+  Report(*m_os);
+  m_os->flush();
+}
+
+void
+NlsrConvergenceMonitor::Report(std::ostream& os) const
+{
+  os << "Episode" << "\t" << "Cause" << "\t" << "Start" << "\t" << "Converged" << "\t"
+     << "ConvergenceTime";
+  for (int kind = 0; kind < NLSR_TRACE_N_KINDS; ++kind) {
+    os << "\t" << KIND_NAMES[kind] << "Packets" << "\t" << KIND_NAMES[kind] << "KBytes";
+  }
+  os << "\n";
+
+  for (size_t i = 0; i < m_episodes.size(); ++i) {
+    const Episode& episode = m_episodes[i];
+    os << i << "\t" << episode.cause << "\t" << episode.start.ToDouble(Time::S) << "\t";
+    if (episode.isConverged) {
+      os << episode.converged.ToDouble(Time::S) << "\t"
+         << (episode.converged - episode.start).ToDouble(Time::S);
+    }
+    else {
+      os << "NA" << "\t" << "NA";
+    }
+    for (int kind = 0; kind < NLSR_TRACE_N_KINDS; ++kind) {
+      os << "\t" << episode.messages[kind].packets << "\t" << episode.messages[kind].bytes / 1024.0;
+    }
+    os << "\n";
+  }
+
+  os << "\n" << "Type" << "\t" << "Packets" << "\t" << "KBytes" << "\n";
+  for (int kind = 0; kind < NLSR_TRACE_N_KINDS; ++kind) {
+    os << KIND_NAMES[kind] << "\t" << m_totals[kind].packets << "\t"
+       << m_totals[kind].bytes / 1024.0 << "\n";
+  }
+
+  os << "\n" << "Node" << "\t" << "FibUpdates" << "\t" << "RoutingRecalculations" << "\n";
+  for (const auto& stats : m_nodes) {
+    os << Names::FindName(stats.node) << "\t" << stats.fibUpdates << "\t" << stats.recalculations
+       << "\n";
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_NLSR_CONVERGENCE_MONITOR_HPP
+#define NDN_NLSR_CONVERGENCE_MONITOR_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ndn-nlsr-tracer.hpp"
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+
+#include <vector>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Detects NLSR routing convergence and reports control overhead
+ *
+ * The monitor periodically computes a digest of the NLSR routing table of every monitored
+ * node.  Unlike the FIB, the routing table changes only as a result of a routing table
+ * calculation, and not because of prefix registrations by applications.  A convergence
+ * episode starts at installation (startup) or when NotifyTopologyChange is called (e.g., right
+ * after LinkControlHelper::FailLink), or when a routing table change is observed in a
+ * converged network.  The episode ends once no routing table has changed for the configured
+ * quiet period; the convergence time is measured up to the last observed change.
+ *
+ * Control messages and bytes are collected from NlsrTracer events, per type and episode.
+ * When the simulator is destroyed, a report with the episodes, message totals by type, and
+ * per-node FIB update and routing table recalculation counts is written to the output file.
+ * Only recalculations that changed the routing table are counted, at most one per sampling
+ * period.
+ */
+class NlsrConvergenceMonitor : public SimpleRefCount<NlsrConvergenceMonitor>
+{
+public:
+  /**
+   * @brief Install monitor on all simulation nodes
+   *
+   * @param file File to which the report will be written.  If filename is -, then std::out is used
+   * @param samplingPeriod How often FIBs are checked for changes
+   * @param quietPeriod Time without any FIB change after which the network is considered converged
+   */
+  static Ptr<NlsrConvergenceMonitor>
+  InstallAll(const std::string& file, Time samplingPeriod = Seconds(1.0),
+             Time quietPeriod = Seconds(30.0));
+
+  /**
+   * @brief Install monitor on the selected simulation nodes
+   */
+  static Ptr<NlsrConvergenceMonitor>
+  Install(const NodeContainer& nodes, const std::string& file, Time samplingPeriod = Seconds(1.0),
+          Time quietPeriod = Seconds(30.0));
+
+  /**
+   * @brief Explicit request to remove all statically created monitors
+   *
+   * Monitors write their reports when they are destroyed, so this method should be called
+   * before Simulator::Destroy().
+   */
+  static void
+  Destroy();
+
+  NlsrConvergenceMonitor(const NodeContainer& nodes, shared_ptr<std::ostream> os,
+                         Time samplingPeriod, Time quietPeriod);
+
+  virtual
+  ~NlsrConvergenceMonitor();
+
+  /**
+   * @brief Start a new convergence episode, caused by a topology change
+   */
+  void
+  NotifyTopologyChange(const std::string& cause);
+
+  /**
+   * @brief Check whether routing has converged after the last episode start
+   */
+  bool
+  IsConverged() const;
+
+  /**
+   * @brief Convergence time of the last finished episode (zero if none finished yet)
+   */
+  Time
+  GetLastConvergenceTime() const;
+
+  /**
+   * @brief Write report to the output stream
+   */
+  void
+  Report(std::ostream& os) const;
+
+protected:
+  /**
+   * @brief Digest of the routing table of the NLSR instance on the node
+   *
+   * @return digest, or 0 if NLSR is not running on the node
+   */
+  virtual size_t
+  ComputeRoutingTableDigest(Ptr<Node> node) const;
+
+private:
+  void
+  Sample();
+
+  void
+  WriteReport();
+
+  void
+  OnNlsrEvent(uint8_t kind, uint32_t node, uint64_t packets, uint64_t bytes);
+
+  void
+  StartEpisode(const std::string& cause, const Time& start);
+
+private:
+  struct Counters
+  {
+    uint64_t packets;
+    uint64_t bytes;
+  };
+
+  struct Episode
+  {
+    std::string cause;
+    Time start;
+    Time lastChange;
+    Time converged;
+    bool isConverged;
+    Counters messages[NLSR_TRACE_N_KINDS];
+  };
+
+  struct NodeStats
+  {
+    Ptr<Node> node;
+    size_t routingTableDigest;
+    uint64_t fibUpdates;
+    uint64_t recalculations;
+  };
+
+  shared_ptr<std::ostream> m_os;
+  Time m_samplingPeriod;
+  Time m_quietPeriod;
+  EventId m_sampleEvent;
+
+  std::vector<NodeStats> m_nodes;
+  std::vector<int32_t> m_nodeIndex; ///< @brief ns-3 node id to m_nodes position, -1 if not monitored
+  std::vector<Episode> m_episodes;
+  Counters m_totals[NLSR_TRACE_N_KINDS];
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_NLSR_CONVERGENCE_MONITOR_HPP
@@ -20,6 +20,11 @@
 // ndn-nlsr-tracer.cpp
 
 #include <fstream>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <string.h>
 
 #include "ns3/log.h"
 #include "ndn-nlsr-tracer.hpp"
@@ -38,35 +43,74 @@ std::string syncTraceFile = "-node-nlsr-sync-trace-";
 std::string nlsaTraceFile = "-node-nlsr-nlsa-trace-";
 std::string llsaTraceFile = "-node-nlsr-llsa-trace-";
 std::string fibTraceFile = "-node-nlsr-fib-trace-";
+std::string binaryTraceFile = "-nlsr-trace.bin";
+std::string summaryTraceFile = "-nlsr-summary-trace.txt";
 
 namespace ns3 {
 
 namespace ndn {
 
+static const char BINARY_MAGIC[8] = {'N', 'L', 'S', 'R', 'T', 'R', 'C', '1'};
+static const char ENTRY_STRING = 'S';
+static const char ENTRY_NODE = 'N';
+static const char ENTRY_EVENT = 'E';
+
+static const size_t RING_SIZE = 1 << 16; // must be a power of two
+static const size_t N_RAW_COLUMNS = 6;
+static const uint32_t NO_NODE_NAME = std::numeric_limits<uint32_t>::max();
+
 NlsrTracer* NlsrTracer::inst = 0;
-int NlsrTracer::m_HelloCount = 0;
-int NlsrTracer::m_NameLsaCount = 0;
-int NlsrTracer::m_LinkLsaCount = 0;
-int NlsrTracer::m_NsyncCount = 0;
-int NlsrTracer::m_FibCount = 0;
-
-int NlsrTracer::m_HelloFileCount = 0;
-int NlsrTracer::m_NameLsaFileCount = 0;
-int NlsrTracer::m_LinkLsaFileCount = 0;
-int NlsrTracer::m_NsyncFileCount = 0;
-int NlsrTracer::m_FibFileCount = 0;
 
 bool NlsrTracer::m_EnableTracer = true;
 
+// integers are stored little-endian, so traces can be converted on any host
+template<class T>
+static void
+writeValue(std::ostream& os, T value)
+{
+  typename std::make_unsigned<T>::type bits = value;
+  char buf[sizeof(T)];
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    buf[i] = static_cast<char>(static_cast<uint64_t>(bits) >> (8 * i));
+  }
+  os.write(buf, sizeof(buf));
+}
+
+template<class T>
+static bool
+readValue(std::istream& is, T& value)
+{
+  unsigned char buf[sizeof(T)];
+  if (!is.read(reinterpret_cast<char*>(buf), sizeof(buf))) {
+    return false;
+  }
+  uint64_t bits = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    bits |= static_cast<uint64_t>(buf[i]) << (8 * i);
+  }
+  value = static_cast<T>(static_cast<typename std::make_unsigned<T>::type>(bits));
+  return true;
+}
+
 NlsrTracer& NlsrTracer::Instance() {
   if (!inst) 
     inst = new NlsrTracer();
   return *inst;
 }
 
-NlsrTracer::NlsrTracer() {
+NlsrTracer::NlsrTracer()
+  : m_writtenStrings(0)
+  , m_head(0)
+  , m_tail(0)
+  , m_isRunning(false)
+  , m_isSummary(false)
+{
   m_LogBlockSize = 4000;
 
+  // id 0 is reserved for the "-" placeholder
+  m_strings.push_back("-");
+  m_stringIds["-"] = 0;
+
   char* str = getenv("ENABLE_TRACER");
   if (str != NULL) {
     if (strcmp(str, "TRUE") == 0) {
@@ -83,12 +127,7 @@ NlsrTracer::NlsrTracer() {
 }
 
 NlsrTracer::~NlsrTracer() {
-  // Close of streams
-  of_hello.close();
-  of_nlsa.close();
-  of_llsa.close();
-  of_nsync.close();
-  of_fib.close();
+  Flush();
 }
 
 // LOG_FILE_SIZE can be configured from env variable.
@@ -115,157 +154,476 @@ NlsrTracer::IsEnabled() {
 void 
 NlsrTracer::InitializeTracer(std::string prefix) {
 
-  if (!m_EnableTracer) {
+  if (!m_EnableTracer || m_isRunning) {
     return;
   }
 
   m_prefix = prefix;
   boost::filesystem::path full_path(boost::filesystem::current_path());
-  m_helloTracer = full_path.string() + "/" + m_prefix + helloTraceFile + std::to_string(m_HelloFileCount++) + ".txt";
-  of_hello.open(m_helloTracer.c_str());
+  m_traceFile = full_path.string() + "/" + m_prefix + binaryTraceFile;
+  m_os.open(m_traceFile.c_str(), std::ios::binary | std::ios::trunc);
+  if (!m_os.is_open()) {
+    NS_LOG_ERROR ("Cannot open " << m_traceFile << ", Nlsr tracer is disabled");
+    return;
+  }
+  m_os.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
 
-  m_nameLsaTracer = full_path.string() + "/" + m_prefix + nlsaTraceFile + std::to_string(m_NameLsaFileCount++) + ".txt";
-  of_nlsa.open(m_nameLsaTracer.c_str()); 
+  SetLogRollOverSize();
 
-  m_linkLsaTracer = full_path.string() + "/" + m_prefix + llsaTraceFile + std::to_string(m_LinkLsaFileCount++) + ".txt";
-  of_llsa.open(m_linkLsaTracer.c_str()); 
+  m_ring.resize(RING_SIZE);
+  m_ringColumns.resize(RING_SIZE * N_RAW_COLUMNS);
+  m_head = 0;
+  m_tail = 0;
+  m_isRunning = true;
+  m_writer = std::thread(&NlsrTracer::WriterLoop, this);
 
-  m_nsyncTracer = full_path.string() + "/" + m_prefix + syncTraceFile + std::to_string(m_NsyncFileCount++) + ".txt";
-  of_nsync.open(m_nsyncTracer.c_str()); 
+  Simulator::ScheduleDestroy(&NlsrTracer::Flush, this);
+}
 
-  m_fibTracer = full_path.string() + "/" + m_prefix + fibTraceFile + std::to_string(m_FibFileCount++) + ".txt";
-  of_fib.open(m_fibTracer.c_str()); 
+void
+NlsrTracer::InitializeSummaryTracer(const std::string& prefix, Time period)
+{
+  if (!m_EnableTracer || m_isRunning || m_isSummary) {
+    return;
+  }
 
-  WriteHeaders();
-  SetLogRollOverSize();
+  m_prefix = prefix;
+  boost::filesystem::path full_path(boost::filesystem::current_path());
+  std::string file = full_path.string() + "/" + m_prefix + summaryTraceFile;
+  m_summaryOs.open(file.c_str(), std::ios::trunc);
+  if (!m_summaryOs.is_open()) {
+    NS_LOG_ERROR ("Cannot open " << file << ", Nlsr tracer is disabled");
+    return;
+  }
+
+  m_summaryOs << "Time" << "\tNode"
+              << "\tHelloPackets" << "\tHelloKBytes"
+              << "\tNameLsaPackets" << "\tNameLsaKBytes"
+              << "\tLinkLsaPackets" << "\tLinkLsaKBytes"
+              << "\tSyncPackets" << "\tSyncKBytes"
+              << "\tFibUpdates" << "\n";
+
+  m_isSummary = true;
+  m_summaryPeriod = period;
+  m_summary.assign(NodeList::GetNNodes() * NLSR_TRACE_N_KINDS, SummaryCounters());
+  m_summaryEvent = Simulator::Schedule(m_summaryPeriod, &NlsrTracer::PeriodicSummary, this);
+
+  Simulator::ScheduleDestroy(&NlsrTracer::Flush, this);
 }
 
 void
-NlsrTracer::WriteHeaders() {
-  of_llsa << "Time" << "\tNode" << "\tFaceId" << "\tFaceDescr" << "\tType" << "\tPackets" << "\tKBytes" << "\tPacketRaw" << endl;
-  of_nlsa << "Time" << "\tNode" << "\tName" << "\tType" << "\tPackets" << "\tKBytes" << "\t-" << "\t-" << endl;
-  of_hello << "Time" << "\tNode" << "\tName" << "\tType" << "\tPackets" << "\tKBytes" << "\t-" << "\t-" << endl;
-  of_nsync << "Time" << "\tNode" << "\tName" << "\tType" << "\tPackets" << "\tKBytes" << "\t-" << "\t-" << endl;
-  of_fib << "Time" << "\tNode" << "\tName" << "\tType" << "\tAttempt" << "\t-" << "\t-" << "\t-" << endl;
+NlsrTracer::Accumulate(uint8_t kind, uint64_t packets, uint64_t bytes)
+{
+  uint32_t node = Simulator::GetContext();
+  if (node >= NodeList::GetNNodes()) {
+    return;
+  }
+
+  size_t index = node * NLSR_TRACE_N_KINDS + kind;
+  if (index >= m_summary.size()) {
+    m_summary.resize((node + 1) * NLSR_TRACE_N_KINDS, SummaryCounters());
+  }
+  m_summary[index].packets += packets;
+  m_summary[index].bytes += bytes;
 }
 
 void
-NlsrTracer::HelloTrace(std::string arg1, std::string arg2, std::string arg3, std::string arg4, std::string arg5, std::string arg6) {
-
-  if (!m_EnableTracer) {
-    return;
+NlsrTracer::PeriodicSummary()
+{
+  double time = Simulator::Now().ToDouble(Time::S);
+  uint32_t nNodes = m_summary.size() / NLSR_TRACE_N_KINDS;
+  for (uint32_t node = 0; node < nNodes; ++node) {
+    SummaryCounters* counters = &m_summary[node * NLSR_TRACE_N_KINDS];
+
+    m_summaryOs << time << "\t" << Names::FindName(NodeList::GetNode(node));
+    for (int kind = 0; kind < NLSR_TRACE_FIB; ++kind) {
+      m_summaryOs << "\t" << counters[kind].packets << "\t" << counters[kind].bytes / 1024.0;
+    }
+    m_summaryOs << "\t" << counters[NLSR_TRACE_FIB].packets << "\n";
   }
+  std::fill(m_summary.begin(), m_summary.end(), SummaryCounters());
+
+  m_summaryEvent = Simulator::Schedule(m_summaryPeriod, &NlsrTracer::PeriodicSummary, this);
+}
 
-  ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(ns3::Simulator::GetContext());
-  std::string nodeName = Names::FindName(node);
+void
+NlsrTracer::SetEventListener(const EventListener& listener)
+{
+  m_listener = listener;
+}
 
-  of_hello << Simulator::Now().ToDouble(Time::S) << "\t" << nodeName << "\t" << arg1 << "\t" << arg2 << "\t" << arg3 << "\t" << arg4 << "\t" << arg5 << "\t" << arg6 << endl; 
-  if (++m_HelloCount == m_LogBlockSize) {
-    // Close and create a new log file
-    of_hello.flush();
-    m_HelloCount = 0;
-    of_hello.close();
+uint32_t
+NlsrTracer::Intern(const std::string& str)
+{
+  std::lock_guard<std::mutex> lock(m_dictMutex);
+  return InternLocked(str);
+}
 
-    boost::filesystem::path full_path(boost::filesystem::current_path());
-    m_helloTracer = full_path.string() + "/" + m_prefix + helloTraceFile + std::to_string(m_HelloFileCount++) + ".txt";
-    of_hello.open(m_helloTracer.c_str()); 
-    of_hello << "Time" << "\tNode" << "\tName" << "\tType" << "\tPackets" << "\tKBytes" << "\t-" << "\t-" << endl;
+uint32_t
+NlsrTracer::InternLocked(const std::string& str)
+{
+  auto it = m_stringIds.find(str);
+  if (it != m_stringIds.end()) {
+    return it->second;
   }
+
+  uint32_t id = m_strings.size();
+  m_strings.push_back(str);
+  m_stringIds.insert(std::make_pair(str, id));
+  return id;
 }
 
-void 
-NlsrTracer::NameLsaTrace(std::string arg1, std::string arg2, std::string arg3, std::string arg4, std::string arg5, std::string arg6) {
+void
+NlsrTracer::Push(NlsrTraceRecord& record)
+{
+  record.time = Simulator::Now().GetNanoSeconds();
+  record.node = Simulator::GetContext();
+
+  if (record.node < NodeList::GetNNodes()) {
+    if (record.node >= m_nodeNames.size()) {
+      m_nodeNames.resize(record.node + 1, NO_NODE_NAME);
+    }
+    if (m_nodeNames[record.node] == NO_NODE_NAME) {
+      uint32_t nameId = Intern(Names::FindName(NodeList::GetNode(record.node)));
+      m_nodeNames[record.node] = nameId;
 
-  if (!m_EnableTracer) {
-    return;
+      std::lock_guard<std::mutex> lock(m_dictMutex);
+      m_newNodes.push_back(std::make_pair(record.node, nameId));
+    }
   }
 
-  ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(ns3::Simulator::GetContext());
-  std::string nodeName = Names::FindName(node);
+  size_t head = m_head.load(std::memory_order_relaxed);
+  size_t next = (head + 1) & (RING_SIZE - 1);
+  if (next == m_tail.load(std::memory_order_acquire)) {
+    // ring is full, wait for the writer to catch up
+    std::unique_lock<std::mutex> lock(m_writerMutex);
+    m_writerCv.notify_one();
+    m_spaceCv.wait(lock, [&] { return next != m_tail.load(std::memory_order_acquire); });
+  }
 
-  of_nlsa << Simulator::Now().ToDouble(Time::S) << "\t" << nodeName << "\t" << arg1 << "\t" << arg2 << "\t" << arg3 << "\t" << arg4 << "\t" << arg5 << "\t" << arg6 << endl; 
-  if (++m_NameLsaCount == m_LogBlockSize) {
-    // Close and create a new log file
-    of_nlsa.flush();
-    m_NameLsaCount = 0;
-    of_nlsa.close();
+  m_ring[head] = record;
+  m_head.store(next, std::memory_order_release);
 
-    boost::filesystem::path full_path(boost::filesystem::current_path());
-    m_nameLsaTracer = full_path.string() + "/" + m_prefix + nlsaTraceFile + std::to_string(m_NameLsaFileCount++) + ".txt";
-    of_nlsa.open(m_nameLsaTracer.c_str()); 
-    of_nlsa << "Time" << "\tNode" << "\tName" << "\tType" << "\tPackets" << "\tKBytes" << "\t-" << "\t-" << endl;
+  if ((head & (RING_SIZE / 4 - 1)) == 0) {
+    m_writerCv.notify_one();
   }
 }
 
-void 
-NlsrTracer::LinkLsaTrace(std::string arg1, std::string arg2, std::string arg3, std::string arg4, std::string arg5, std::string arg6) {
+void
+NlsrTracer::Trace(NlsrTraceKind kind, uint32_t faceId, uint32_t nameId, uint32_t typeId,
+                  uint64_t packets, uint64_t bytes)
+{
+  if (m_listener) {
+    m_listener(kind, Simulator::GetContext(), kind == NLSR_TRACE_FIB ? 1 : packets, bytes);
+  }
+
+  if (m_isSummary) {
+    Accumulate(kind, kind == NLSR_TRACE_FIB ? 1 : packets, bytes);
+    return;
+  }
 
-  if (!m_EnableTracer) {
+  if (!m_isRunning) {
     return;
   }
 
-  ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(ns3::Simulator::GetContext());
-  std::string nodeName = Names::FindName(node);
+  NlsrTraceRecord record;
+  memset(&record, 0, sizeof(record));
+  record.kind = kind;
+  record.face = faceId;
+  record.name = nameId;
+  record.type = typeId;
+  record.packets = packets;
+  record.bytes = bytes;
+  Push(record);
+}
 
-  of_llsa << Simulator::Now().ToDouble(Time::S) << "\t" << nodeName << "\t" << arg1 << "\t" << arg2 << "\t" << arg3 << "\t" << arg4 << "\t" << arg5 << "\t" << arg6 << endl; 
-  if (++m_LinkLsaCount == m_LogBlockSize) {
-    of_llsa.flush();
-    m_LinkLsaCount = 0;
-    of_llsa.close();
+void
+NlsrTracer::TraceRaw(NlsrTraceKind kind, const std::string& arg1, const std::string& arg2,
+                     const std::string& arg3, const std::string& arg4, const std::string& arg5,
+                     const std::string& arg6)
+{
+  if (m_isSummary || m_listener) {
+    // Packets and KBytes columns of the text layout; the link LSA trace has an extra FaceId
+    const std::string* args[] = {&arg1, &arg2, &arg3, &arg4, &arg5, &arg6};
+    size_t column = (kind == NLSR_TRACE_LINK_LSA) ? 3 : 2;
+    uint64_t packets = 1;
+    uint64_t bytes = 0;
+    if (kind != NLSR_TRACE_FIB) {
+      packets = std::max<uint64_t>(strtoull(args[column]->c_str(), 0, 10), 1);
+      bytes = static_cast<uint64_t>(strtod(args[column + 1]->c_str(), 0) * 1024);
+    }
 
-    boost::filesystem::path full_path(boost::filesystem::current_path());
-    m_linkLsaTracer = full_path.string() + "/" + m_prefix + llsaTraceFile + std::to_string(m_LinkLsaFileCount++) + ".txt";
-    of_llsa.open(m_linkLsaTracer.c_str()); 
-    of_llsa << "Time" << "\tNode" << "\tName" << "\tType" << "\tPackets" << "\tKBytes" << "\t-" << "\t-" << endl;
+    if (m_listener) {
+      m_listener(kind, Simulator::GetContext(), packets, bytes);
+    }
+
+    if (m_isSummary) {
+      Accumulate(kind, packets, bytes);
+      return;
+    }
   }
+
+  if (!m_isRunning) {
+    return;
+  }
+
+  // Columns are interned by the writer thread.  The slot is owned by the simulation thread
+  // until Push publishes it, and assignment reuses the capacity of the previous strings.
+  std::string* columns = &m_ringColumns[m_head.load(std::memory_order_relaxed) * N_RAW_COLUMNS];
+  columns[0] = arg1;
+  columns[1] = arg2;
+  columns[2] = arg3;
+  columns[3] = arg4;
+  columns[4] = arg5;
+  columns[5] = arg6;
+
+  NlsrTraceRecord record;
+  memset(&record, 0, sizeof(record));
+  record.kind = kind;
+  record.isRaw = 1;
+  Push(record);
+}
+
+void
+NlsrTracer::HelloTrace(const std::string& arg1, const std::string& arg2, const std::string& arg3,
+                       const std::string& arg4, const std::string& arg5, const std::string& arg6) {
+  TraceRaw(NLSR_TRACE_HELLO, arg1, arg2, arg3, arg4, arg5, arg6);
 }
 
 void 
-NlsrTracer::NsyncTrace(std::string arg1, std::string arg2, std::string arg3, std::string arg4, std::string arg5, std::string arg6) {
+NlsrTracer::NameLsaTrace(const std::string& arg1, const std::string& arg2, const std::string& arg3,
+                         const std::string& arg4, const std::string& arg5, const std::string& arg6) {
+  TraceRaw(NLSR_TRACE_NAME_LSA, arg1, arg2, arg3, arg4, arg5, arg6);
+}
 
-  if (!m_EnableTracer) {
-    return;
+void 
+NlsrTracer::LinkLsaTrace(const std::string& arg1, const std::string& arg2, const std::string& arg3,
+                         const std::string& arg4, const std::string& arg5, const std::string& arg6) {
+  TraceRaw(NLSR_TRACE_LINK_LSA, arg1, arg2, arg3, arg4, arg5, arg6);
+}
+
+void 
+NlsrTracer::NsyncTrace(const std::string& arg1, const std::string& arg2, const std::string& arg3,
+                       const std::string& arg4, const std::string& arg5, const std::string& arg6) {
+  TraceRaw(NLSR_TRACE_NSYNC, arg1, arg2, arg3, arg4, arg5, arg6);
+}
+
+void 
+NlsrTracer::FibTrace(const std::string& arg1, const std::string& arg2, const std::string& arg3,
+                     const std::string& arg4, const std::string& arg5, const std::string& arg6) {
+  TraceRaw(NLSR_TRACE_FIB, arg1, arg2, arg3, arg4, arg5, arg6);
+}
+
+void
+NlsrTracer::WriteDictionary()
+{
+  for (; m_writtenStrings < m_strings.size(); ++m_writtenStrings) {
+    const std::string& str = m_strings[m_writtenStrings];
+    m_os.put(ENTRY_STRING);
+    writeValue(m_os, static_cast<uint32_t>(m_writtenStrings));
+    writeValue(m_os, static_cast<uint32_t>(str.size()));
+    m_os.write(str.data(), str.size());
+  }
+
+  for (const auto& node : m_newNodes) {
+    m_os.put(ENTRY_NODE);
+    writeValue(m_os, node.first);
+    writeValue(m_os, node.second);
   }
+  m_newNodes.clear();
+}
+
+void
+NlsrTracer::WriterLoop()
+{
+  while (true) {
+    bool isRunning = m_isRunning;
+    {
+      std::unique_lock<std::mutex> lock(m_writerMutex);
+      if (isRunning) {
+        m_writerCv.wait_for(lock, std::chrono::milliseconds(100));
+      }
+    }
 
-  ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(ns3::Simulator::GetContext());
-  std::string nodeName = Names::FindName(node);
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t head = m_head.load(std::memory_order_acquire);
+
+    std::unique_lock<std::mutex> dictLock(m_dictMutex);
+
+    // strings of typed records and node names have been interned before the records were
+    // published
+    WriteDictionary();
+
+    for (; tail != head; tail = (tail + 1) & (RING_SIZE - 1)) {
+      NlsrTraceRecord& record = m_ring[tail];
+      if (record.isRaw) {
+        const std::string* columns = &m_ringColumns[tail * N_RAW_COLUMNS];
+        record.name = InternLocked(columns[0]);
+        record.type = InternLocked(columns[1]);
+        for (size_t i = 0; i < 4; ++i) {
+          record.extra[i] = InternLocked(columns[i + 2]);
+        }
+        WriteDictionary();
+      }
+
+      m_os.put(ENTRY_EVENT);
+      writeValue(m_os, record.time);
+      writeValue(m_os, record.node);
+      writeValue(m_os, record.face);
+      writeValue(m_os, record.name);
+      writeValue(m_os, record.type);
+      writeValue(m_os, record.packets);
+      writeValue(m_os, record.bytes);
+      for (size_t i = 0; i < 4; ++i) {
+        writeValue(m_os, record.extra[i]);
+      }
+      writeValue(m_os, record.kind);
+      writeValue(m_os, record.isRaw);
+    }
+    dictLock.unlock();
 
-  of_nsync << Simulator::Now().ToDouble(Time::S) << "\t" << nodeName << "\t" << arg1 << "\t" << arg2 << "\t" << arg3 << "\t" << arg4 << "\t" << arg5 << "\t" << arg6 << endl; 
-  if (++m_NsyncCount == m_LogBlockSize) {
-    // Close and create a new log file
-    of_nsync.flush();
-    m_NsyncCount = 0;
-    of_nsync.close();
+    {
+      // taking the lock orders the store with a concurrent wait in Push
+      std::lock_guard<std::mutex> lock(m_writerMutex);
+      m_tail.store(tail, std::memory_order_release);
+    }
+    m_spaceCv.notify_one();
 
-    boost::filesystem::path full_path(boost::filesystem::current_path());
-    m_nsyncTracer = full_path.string() + "/" + m_prefix + syncTraceFile + std::to_string(m_NsyncFileCount++) + ".txt";
-    of_nsync.open(m_nsyncTracer.c_str()); 
-    of_nsync << "Time" << "\tNode" << "\tName" << "\tType" << "\tPackets" << "\tKBytes" << "\t-" << "\t-" << endl;
+    if (!isRunning) {
+      break;
+    }
   }
+
+  m_os.flush();
 }
 
-void 
-NlsrTracer::FibTrace(std::string arg1, std::string arg2, std::string arg3, std::string arg4, std::string arg5, std::string arg6) {
+void
+NlsrTracer::Flush()
+{
+  if (m_isSummary) {
+    m_isSummary = false;
+    m_summaryEvent.Cancel();
+    m_summaryOs.close();
+  }
 
-  if (!m_EnableTracer) {
+  if (!m_isRunning) {
     return;
   }
 
-  ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(ns3::Simulator::GetContext());
-  std::string nodeName = Names::FindName(node);
+  m_isRunning = false;
+  m_writerCv.notify_one();
+  m_writer.join();
+  m_os.close();
+}
+
+bool
+NlsrTracer::ConvertToText(const std::string& binaryFile, const std::string& prefix, int logBlockSize)
+{
+  std::ifstream is(binaryFile.c_str(), std::ios::binary);
+  char magic[sizeof(BINARY_MAGIC)];
+  if (!is.read(magic, sizeof(magic)) || memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0) {
+    NS_LOG_ERROR ("Not an NLSR binary trace: " << binaryFile);
+    return false;
+  }
 
-  of_fib << Simulator::Now().ToDouble(Time::S) << "\t" << nodeName << "\t" << arg1 << "\t" << arg2 << "\t" << arg3 << "\t" << arg4 << "\t" << arg5 << "\t" << arg6 << endl; 
-  if (++m_FibCount == m_LogBlockSize) {
-    // Close and create a new log file
-    of_fib.flush();
-    m_FibCount = 0;
-    of_fib.close();
+  const std::string fileNames[NLSR_TRACE_N_KINDS] = {
+    helloTraceFile, nlsaTraceFile, llsaTraceFile, syncTraceFile, fibTraceFile
+  };
+  const std::string headers[NLSR_TRACE_N_KINDS] = {
+    "Time\tNode\tName\tType\tPackets\tKBytes\t-\t-",
+    "Time\tNode\tName\tType\tPackets\tKBytes\t-\t-",
+    "Time\tNode\tFaceId\tFaceDescr\tType\tPackets\tKBytes\tPacketRaw",
+    "Time\tNode\tName\tType\tPackets\tKBytes\t-\t-",
+    "Time\tNode\tName\tType\tAttempt\t-\t-\t-"
+  };
+
+  std::ofstream os[NLSR_TRACE_N_KINDS];
+  int lineCount[NLSR_TRACE_N_KINDS] = {0};
+  int fileCount[NLSR_TRACE_N_KINDS] = {0};
+  auto openNext = [&] (int kind) {
+    os[kind].close();
+    os[kind].open((prefix + fileNames[kind] + std::to_string(fileCount[kind]++) + ".txt").c_str());
+    os[kind] << headers[kind] << "\n";
+    lineCount[kind] = 0;
+  };
+  for (int kind = 0; kind < NLSR_TRACE_N_KINDS; ++kind) {
+    openNext(kind);
+  }
 
-    boost::filesystem::path full_path(boost::filesystem::current_path());
-    m_fibTracer = full_path.string() + "/" + m_prefix + fibTraceFile + std::to_string(m_FibFileCount++) + ".txt";
-    of_fib.open(m_fibTracer.c_str()); 
-    of_fib << "Time" << "\tNode" << "\tName" << "\tType" << "\tAttempt" << "\t-" << "\t-" << "\t-" << endl;
+  std::vector<std::string> strings;
+  std::vector<std::string> nodeNames;
+  auto str = [&] (uint32_t id) -> const std::string& {
+    static const std::string unknown = "-";
+    return id < strings.size() ? strings[id] : unknown;
+  };
+
+  char entry;
+  while (is.get(entry)) {
+    if (entry == ENTRY_STRING) {
+      uint32_t id, size;
+      if (!readValue(is, id) || !readValue(is, size))
+        break;
+      std::string value(size, '\0');
+      is.read(&value[0], size);
+      if (id >= strings.size())
+        strings.resize(id + 1);
+      strings[id] = value;
+    }
+    else if (entry == ENTRY_NODE) {
+      uint32_t node, nameId;
+      if (!readValue(is, node) || !readValue(is, nameId))
+        break;
+      if (node >= nodeNames.size())
+        nodeNames.resize(node + 1);
+      nodeNames[node] = str(nameId);
+    }
+    else if (entry == ENTRY_EVENT) {
+      NlsrTraceRecord record;
+      readValue(is, record.time);
+      readValue(is, record.node);
+      readValue(is, record.face);
+      readValue(is, record.name);
+      readValue(is, record.type);
+      readValue(is, record.packets);
+      readValue(is, record.bytes);
+      for (size_t i = 0; i < 4; ++i) {
+        readValue(is, record.extra[i]);
+      }
+      readValue(is, record.kind);
+      if (!readValue(is, record.isRaw) || record.kind >= NLSR_TRACE_N_KINDS)
+        break;
+
+      std::ostream& out = os[record.kind];
+      out << record.time / 1e9 << "\t"
+          << (record.node < nodeNames.size() ? nodeNames[record.node] : std::string()) << "\t";
+      if (record.isRaw) {
+        out << str(record.name) << "\t" << str(record.type) << "\t" << str(record.extra[0]) << "\t"
+            << str(record.extra[1]) << "\t" << str(record.extra[2]) << "\t" << str(record.extra[3]);
+      }
+      else if (record.kind == NLSR_TRACE_LINK_LSA) {
+        out << record.face << "\t" << str(record.name) << "\t" << str(record.type) << "\t"
+            << record.packets << "\t" << record.bytes / 1024.0 << "\t-";
+      }
+      else if (record.kind == NLSR_TRACE_FIB) {
+        out << str(record.name) << "\t" << str(record.type) << "\t" << record.packets << "\t-\t-\t-";
+      }
+      else {
+        out << str(record.name) << "\t" << str(record.type) << "\t" << record.packets << "\t"
+            << record.bytes / 1024.0 << "\t-\t-";
+      }
+      out << "\n";
+
+      if (++lineCount[record.kind] == logBlockSize) {
+        openNext(record.kind);
+      }
+    }
+    else {
+      NS_LOG_ERROR ("Corrupted NLSR binary trace: " << binaryFile);
+      return false;
+    }
   }
+
+  return true;
 }
 
 } // namespace ndn
@@ -1,4 +1,4 @@
-/*{* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 /**
  * Copyright (c) 2011-2015  Regents of the University of California.
  *
@@ -25,15 +25,75 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <stdint.h>
 
 #include <boost/filesystem.hpp>
 
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+
 namespace ns3 {
 
 using namespace std;
 
 namespace ndn {
 
+/**
+ * \brief Kind of an NLSR trace event
+ */
+enum NlsrTraceKind : uint8_t {
+  NLSR_TRACE_HELLO = 0,
+  NLSR_TRACE_NAME_LSA = 1,
+  NLSR_TRACE_LINK_LSA = 2,
+  NLSR_TRACE_NSYNC = 3,
+  NLSR_TRACE_FIB = 4,
+  NLSR_TRACE_N_KINDS = 5
+};
+
+/**
+ * \brief Fixed-size NLSR trace event
+ *
+ * Names and labels of typed events are interned by NlsrTracer::Intern, so a record never owns
+ * memory and can be copied into the ring buffer without allocation.  Columns of string API
+ * events are interned by the writer thread.  Id 0 always denotes "-".
+ */
+struct NlsrTraceRecord
+{
+  int64_t time;       ///< \brief simulation time in nanoseconds
+  uint32_t node;      ///< \brief ns-3 node id
+  uint32_t face;      ///< \brief face id, 0 if not applicable
+  uint32_t name;      ///< \brief interned name (or first free-form column)
+  uint32_t type;      ///< \brief interned event label, e.g., "SENT"
+  uint64_t packets;   ///< \brief packet counter (attempt number for FIB events)
+  uint64_t bytes;     ///< \brief byte counter
+  uint32_t extra[4];  ///< \brief interned free-form columns, used by the string API
+  uint8_t kind;       ///< \brief NlsrTraceKind
+  uint8_t isRaw;      ///< \brief record stores six interned columns instead of typed fields
+};
+
+/**
+ * \brief Tracer for NLSR control traffic
+ *
+ * Events are recorded into a preallocated ring buffer, which a background thread drains
+ * into a compact binary file <prefix>-nlsr-trace.bin.  The simulation thread does not
+ * format or flush anything, columns of the string API are interned by the writer thread,
+ * and the simulation thread waits only when the ring is full.  All integers in the binary
+ * file are little-endian, independent of the host.  NlsrTracer::ConvertToText (or the
+ * ndn-nlsr-trace-converter program) turns the binary file into the tab-separated per-event
+ * files produced by earlier versions, so existing post-processing scripts keep working.
+ *
+ * In summary mode (InitializeSummaryTracer) no per-event records are kept.  Instead, packet
+ * and byte counters are accumulated per node and event kind, and one row per node is written
+ * to <prefix>-nlsr-summary-trace.txt at the end of every period.
+ */
 class NlsrTracer {
 
 public:
@@ -43,22 +103,81 @@ public:
 
   void InitializeTracer(std::string prefix);
 
+  /**
+   * \brief Enable summary mode instead of per-event tracing
+   *
+   * \param prefix Prefix of the summary trace file
+   * \param period Length of the aggregation bucket (default, one second)
+   */
+  void
+  InitializeSummaryTracer(const std::string& prefix, Time period = Seconds(1.0));
+
   bool IsEnabled();
 
+  /**
+   * \brief Callback invoked for every event, independent of the tracing mode
+   *
+   * Parameters are event kind, node id, number of packets (1 for FIB events) and bytes.
+   */
+  typedef std::function<void(uint8_t, uint32_t, uint64_t, uint64_t)> EventListener;
+
+  /**
+   * \brief Set (or reset with an empty function) the event listener
+   */
+  void
+  SetEventListener(const EventListener& listener);
+
+  /**
+   * \brief Intern a string and return its id for use in NlsrTraceRecord
+   */
+  uint32_t
+  Intern(const std::string& str);
+
+  /**
+   * \brief Record a typed event on the node in the current simulation context
+   */
+  void
+  Trace(NlsrTraceKind kind, uint32_t faceId, uint32_t nameId, uint32_t typeId,
+        uint64_t packets, uint64_t bytes);
+
+  /**
+   * \brief Drain all pending records to the binary file and stop the writer thread
+   *
+   * Called automatically when the simulator is destroyed.
+   */
+  void
+  Flush();
+
   void 
-  HelloTrace(std::string agr1 = "-", std::string agr2 = "-", std::string agr3 = "-", std::string agr4 = "-", std::string agr5 = "-", std::string agr6 = "-");
+  HelloTrace(const std::string& arg1 = "-", const std::string& arg2 = "-", const std::string& arg3 = "-",
+             const std::string& arg4 = "-", const std::string& arg5 = "-", const std::string& arg6 = "-");
 
   void 
-  NameLsaTrace(std::string agr1 = "-", std::string agr2 = "-", std::string agr3 = "-", std::string agr4 = "-", std::string agr5 = "-", std::string agr6 = "-");
+  NameLsaTrace(const std::string& arg1 = "-", const std::string& arg2 = "-", const std::string& arg3 = "-",
+               const std::string& arg4 = "-", const std::string& arg5 = "-", const std::string& arg6 = "-");
 
   void 
-  LinkLsaTrace(std::string agr1 = "-", std::string agr2 = "-", std::string agr3 = "-", std::string agr4 = "-", std::string agr5 = "-", std::string agr6 = "-");
+  LinkLsaTrace(const std::string& arg1 = "-", const std::string& arg2 = "-", const std::string& arg3 = "-",
+               const std::string& arg4 = "-", const std::string& arg5 = "-", const std::string& arg6 = "-");
 
   void 
-  NsyncTrace(std::string agr1 = "-", std::string agr2 = "-", std::string agr3 = "-", std::string agr4 = "-", std::string agr5 = "-", std::string agr6 = "-");
+  NsyncTrace(const std::string& arg1 = "-", const std::string& arg2 = "-", const std::string& arg3 = "-",
+             const std::string& arg4 = "-", const std::string& arg5 = "-", const std::string& arg6 = "-");
 
   void 
-  FibTrace(std::string agr1 = "-", std::string agr2 = "-", std::string agr3 = "-", std::string agr4 = "-", std::string agr5 = "-", std::string agr6 = "-");
+  FibTrace(const std::string& arg1 = "-", const std::string& arg2 = "-", const std::string& arg3 = "-",
+           const std::string& arg4 = "-", const std::string& arg5 = "-", const std::string& arg6 = "-");
+
+  /**
+   * \brief Convert binary trace into per-kind tab-separated files
+   *
+   * Output files are named <prefix>-node-nlsr-{hello,nlsa,llsa,sync,fib}-trace-<n>.txt and
+   * are rolled over every \p logBlockSize lines, exactly as the text tracer used to do.
+   *
+   * \return false if the binary file cannot be read
+   */
+  static bool
+  ConvertToText(const std::string& binaryFile, const std::string& prefix, int logBlockSize = 4000);
 
 private:
 
@@ -66,36 +185,73 @@ private:
   NlsrTracer(const NlsrTracer&);
   NlsrTracer& operator=(const NlsrTracer&);
 
-  void WriteHeaders();
   void SetLogRollOverSize();
 
+  void
+  TraceRaw(NlsrTraceKind kind, const std::string& arg1, const std::string& arg2,
+           const std::string& arg3, const std::string& arg4, const std::string& arg5,
+           const std::string& arg6);
+
+  void
+  Push(NlsrTraceRecord& record);
+
+  void
+  WriterLoop();
+
+  void
+  WriteDictionary();
+
+  uint32_t
+  InternLocked(const std::string& str);
+
+  void
+  Accumulate(uint8_t kind, uint64_t packets, uint64_t bytes);
+
+  void
+  PeriodicSummary();
+
   std::string m_prefix;
-  std::string m_currPath;
-  std::string m_helloTracer;
-  std::string m_nameLsaTracer;
-  std::string m_linkLsaTracer;
-  std::string m_nsyncTracer;
-  std::string m_fibTracer;
-
-  std::ofstream of_hello;
-  std::ofstream of_nlsa;
-  std::ofstream of_llsa;
-  std::ofstream of_nsync;
-  std::ofstream of_fib;
+  std::string m_traceFile;
+  std::ofstream m_os;
 
-  static NlsrTracer* inst;
-  static int m_HelloCount;
-  static int m_NameLsaCount;
-  static int m_LinkLsaCount;
-  static int m_NsyncCount;
-  static int m_FibCount;
-
-  static int m_HelloFileCount;
-  static int m_NameLsaFileCount;
-  static int m_LinkLsaFileCount;
-  static int m_NsyncFileCount;
-  static int m_FibFileCount;
+  // string and node dictionaries, shared with the writer thread (the simulation thread only
+  // takes the lock in Intern and once per node)
+  std::mutex m_dictMutex;
+  std::unordered_map<std::string, uint32_t> m_stringIds;
+  std::vector<std::string> m_strings;
+  std::vector<uint32_t> m_nodeNames;
+  std::vector<std::pair<uint32_t, uint32_t> > m_newNodes;
+  size_t m_writtenStrings;
+
+  // single-producer single-consumer ring buffer; columns of raw records are kept as strings
+  // in m_ringColumns and interned by the writer
+  std::vector<NlsrTraceRecord> m_ring;
+  std::vector<std::string> m_ringColumns; ///< \brief N_RAW_COLUMNS per ring slot
+  std::atomic<size_t> m_head;
+  std::atomic<size_t> m_tail;
+
+  std::thread m_writer;
+  std::mutex m_writerMutex;
+  std::condition_variable m_writerCv;
+  std::condition_variable m_spaceCv; ///< \brief signaled when the writer frees ring slots
+  std::atomic<bool> m_isRunning;
 
+  // summary mode
+  struct SummaryCounters
+  {
+    uint64_t packets;
+    uint64_t bytes;
+  };
+
+  bool m_isSummary;
+  Time m_summaryPeriod;
+  EventId m_summaryEvent;
+  std::ofstream m_summaryOs;
+  std::vector<SummaryCounters> m_summary; ///< \brief indexed by node id * NLSR_TRACE_N_KINDS + kind
+
+  EventListener m_listener;
+
+  static NlsrTracer* inst;
   static bool m_EnableTracer;
   int m_LogBlockSize;
 };